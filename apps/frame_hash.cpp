@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "machine/Machine.h"
+#include "utils/FrameHash.h"
+#include "utils/Logger.h"
+#include "utils/Recorder.h"
+
+// Golden frame-hash regression harness
+// Runs each ROM headless for a fixed number of frames (with optional scripted
+// input from <golden_dir>/<rom>.input) and records or checks a hash of the
+// screen and RAM per frame against <golden_dir>/<rom>.fh. ROMs run in
+// parallel, one per core. --video also captures each run to
+// <golden_dir>/<rom>.y4m for inspecting a mismatch. --pipelined renders on
+// a second thread per ROM (PPUPipeline); its hashes must match the serial run.
+// --accuracy picks the machine's tier; FAST must match the BALANCED goldens.
+// Usage: ./frame_hash record <golden_dir> <rom.nes>... [--frames N] [--threads N] [--video] [--pipelined]
+//                                                       [--accuracy fast|balanced|exact]
+//        ./frame_hash check <golden_dir> <rom.nes>... [--threads N] [--video] [--pipelined]
+//                                                      [--accuracy fast|balanced|exact]
+
+struct Job
+{
+    std::string rom;
+    std::string golden;
+    std::string input;
+    std::string video;
+
+    bool ok;
+    long mismatch;     // First differing frame (check)
+    const char* what;  // Which hash differed
+    size_t frames;
+    std::string error;
+};
+
+static void RunJob(Job& job, bool record, uint32_t frames, bool pipelined, Accuracy accuracy)
+{
+    job.ok = false;
+    job.mismatch = -1;
+    job.what = "";
+    job.frames = 0;
+
+    std::vector<FrameHash> golden;
+    if (!record)
+    {
+        if (!FrameHash::Load(job.golden, golden))
+        {
+            job.error = "no golden file";
+            return;
+        }
+        frames = (uint32_t) golden.size();
+    }
+
+    InputScript script;
+    if (std::filesystem::exists(job.input) && !script.Load(job.input))
+    {
+        job.error = "bad input script";
+        return;
+    }
+
+    auto machine = std::make_unique<Machine>(accuracy);
+    if (!machine->LoadFromFile(job.rom))
+    {
+        job.error = "failed to load ROM";
+        return;
+    }
+
+    if (pipelined && !machine->SetPipelinedPPU(true))
+    {
+        job.error = "failed to start the PPU pipeline";
+        return;
+    }
+
+    // Headless capture keeps every frame, so block rather than drop
+    Recorder recorder;
+    if (!job.video.empty())
+        recorder.Open(job.video, Recorder::FORMAT_Y4M, Recorder::BACKPRESSURE_BLOCK);
+
+    std::vector<FrameHash> hashes;
+    if (recorder.IsOpen())
+    {
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            FrameHash::Run(*machine, 1, &script, hashes);
+            recorder.PushFrame(machine->GetPPU().GetScreenBuffer());
+        }
+        recorder.Close();
+    }
+    else
+    {
+        FrameHash::Run(*machine, frames, &script, hashes);
+    }
+    job.frames = hashes.size();
+
+    if (record)
+    {
+        job.ok = FrameHash::Save(job.golden, hashes);
+        if (!job.ok)
+            job.error = "failed to write golden file";
+        return;
+    }
+
+    job.mismatch = FrameHash::FindMismatch(golden, hashes);
+    job.ok = job.mismatch < 0;
+
+    if (!job.ok)
+    {
+        bool screen = golden[job.mismatch].screen != hashes[job.mismatch].screen;
+        bool ram = golden[job.mismatch].ram != hashes[job.mismatch].ram;
+        job.what = screen && ram ? "screen, ram" : (screen ? "screen" : "ram");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4 || (std::strcmp(argv[1], "record") != 0 && std::strcmp(argv[1], "check") != 0))
+    {
+        std::fprintf(stderr, "Usage: %s record <golden_dir> <rom.nes>... [--frames N] [--threads N] [--video] [--pipelined] [--accuracy fast|balanced|exact]\n", argv[0]);
+        std::fprintf(stderr, "       %s check <golden_dir> <rom.nes>... [--threads N] [--video] [--pipelined] [--accuracy fast|balanced|exact]\n", argv[0]);
+        return 1;
+    }
+
+    Logger::GetInstance().SetLogLevel(LogLevel::WARN);
+
+    bool record = std::strcmp(argv[1], "record") == 0;
+    std::filesystem::path goldenDir = argv[2];
+    uint32_t frames = 600;
+    unsigned threads = 0;
+    bool video = false;
+    bool pipelined = false;
+    Accuracy accuracy = Accuracy::BALANCED;
+
+    std::vector<Job> jobs;
+    for (int i = 3; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = (uint32_t) std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = (unsigned) std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--video") == 0)
+            video = true;
+        else if (std::strcmp(argv[i], "--pipelined") == 0)
+            pipelined = true;
+        else if (std::strcmp(argv[i], "--accuracy") == 0 && i + 1 < argc)
+        {
+            ++i;
+            if (std::strcmp(argv[i], "fast") == 0)
+                accuracy = Accuracy::FAST;
+            else if (std::strcmp(argv[i], "balanced") == 0)
+                accuracy = Accuracy::BALANCED;
+            else if (std::strcmp(argv[i], "exact") == 0)
+                accuracy = Accuracy::EXACT;
+            else
+            {
+                std::fprintf(stderr, "Unknown accuracy '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            std::string stem = std::filesystem::path(argv[i]).stem().string();
+
+            Job job;
+            job.rom = argv[i];
+            job.golden = (goldenDir / (stem + ".fh")).string();
+            job.input = (goldenDir / (stem + ".input")).string();
+            jobs.push_back(job);
+        }
+    }
+
+    for (Job& job : jobs)
+    {
+        if (video)
+            job.video = (goldenDir / (std::filesystem::path(job.rom).stem().string() + ".y4m")).string();
+    }
+
+    if (record || video)
+        std::filesystem::create_directories(goldenDir);
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned) std::min<size_t>(threads, std::max<size_t>(1, jobs.size()));
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i; (i = next.fetch_add(1)) < jobs.size(); )
+            RunJob(jobs[i], record, frames, pipelined, accuracy);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    int failed = 0;
+    size_t totalFrames = 0;
+    for (const Job& job : jobs)
+    {
+        totalFrames += job.frames;
+
+        if (job.ok)
+            std::printf("%-6s %s (%zu frames)\n", record ? "WROTE" : "OK", job.rom.c_str(), job.frames);
+        else if (!job.error.empty())
+            std::printf("ERROR  %s: %s\n", job.rom.c_str(), job.error.c_str());
+        else
+            std::printf("FAIL   %s: first mismatch at frame %ld (%s)\n",
+                        job.rom.c_str(), job.mismatch, job.what);
+
+        failed += job.ok ? 0 : 1;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::fprintf(stderr, "%zu ROMs, %zu frames in %.1f ms on %u threads\n", jobs.size(), totalFrames, ms, threads);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+#include <signal.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "utils/Logger.h"
+#include "utils/Telemetry.h"
+
+// Live view of a running emulator
+// Polls the shared-memory stats that `nes_emulator --telemetry` publishes
+// and redraws them in place, with per-second rates worked out from the
+// running totals. Waits for the emulator to start and exits when it does.
+// Usage: ./nes_top [--name /nes_telemetry] [--interval ms] [--once]
+
+static constexpr double NTSC_CPU_MHZ = 1.789773;
+
+static void PrintStats(const TelemetryStats& stats, const TelemetryStats& previous, double seconds, int pid)
+{
+    auto rate = [&](uint64_t now, uint64_t before)
+    {
+        return seconds > 0 && now >= before ? (now - before) / seconds : 0.0;
+    };
+
+    double frameMs = stats.emulateMs + stats.renderMs + stats.displayMs;
+    auto share = [&](double ms) { return frameMs > 0 ? 100.0 * ms / frameMs : 0.0; };
+
+    std::printf("nes_top - pid %d\n\n", pid);
+    std::printf("  Frames        %12llu   %8.1f fps\n", (unsigned long long) stats.frames, stats.fps);
+    std::printf("  CPU           %12.3f MHz (%.0f%% of NTSC)\n", stats.cpuMHz, 100.0 * stats.cpuMHz / NTSC_CPU_MHZ);
+    std::printf("  Frame time    p50 %7.2f ms   p95 %7.2f ms   p99 %7.2f ms\n",
+                stats.frameMsP50, stats.frameMsP95, stats.frameMsP99);
+    std::printf("\n");
+    std::printf("  Emulate       %8.2f ms  %5.1f%%   (CPU + PPU)\n", stats.emulateMs, share(stats.emulateMs));
+    std::printf("  Render wait   %8.2f ms  %5.1f%%   (pipelined PPU)\n", stats.renderMs, share(stats.renderMs));
+    std::printf("  Display       %8.2f ms  %5.1f%%\n", stats.displayMs, share(stats.displayMs));
+    std::printf("\n");
+    std::printf("  Instructions  %16llu   %12.0f /s\n", (unsigned long long) stats.instructions,
+                rate(stats.instructions, previous.instructions));
+    std::printf("  NMIs          %16llu   %12.1f /s\n", (unsigned long long) stats.nmis, rate(stats.nmis, previous.nmis));
+    std::printf("  IRQs          %16llu   %12.1f /s\n", (unsigned long long) stats.irqs, rate(stats.irqs, previous.irqs));
+    std::printf("  Log drops     %16llu   %12.1f /s\n", (unsigned long long) stats.logDrops,
+                rate(stats.logDrops, previous.logDrops));
+}
+
+int main(int argc, char** argv)
+{
+    std::string name = TelemetryWriter::DEFAULT_NAME;
+    int intervalMs = 1000;
+    bool once = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc)
+            name = argv[++i];
+        else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+            intervalMs = std::max(50, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--once") == 0)
+            once = true;
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--name %s] [--interval ms] [--once]\n", argv[0], TelemetryWriter::DEFAULT_NAME);
+            return 1;
+        }
+    }
+
+    Logger::GetInstance().SetLogLevel(LogLevel::WARN);
+
+    TelemetryReader reader;
+    while (!reader.Open(name))
+    {
+        if (once)
+        {
+            std::fprintf(stderr, "No telemetry at %s (is nes_emulator running with --telemetry?)\n", name.c_str());
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+
+    TelemetryStats previous = {};
+    reader.Read(previous);
+    auto previousTime = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        if (!once)
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+
+        // The segment stays mapped after the emulator unlinks it
+        int pid = reader.GetWriterPid();
+        if (::kill(pid, 0) != 0 && errno != EPERM)
+        {
+            std::printf("Emulator (pid %d) has exited\n", pid);
+            return 0;
+        }
+
+        TelemetryStats stats;
+        if (!reader.Read(stats))
+            continue;
+
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - previousTime).count();
+
+        // Home the cursor and clear, like top
+        if (!once)
+            std::printf("\033[H\033[2J");
+        PrintStats(stats, previous, seconds, pid);
+        std::fflush(stdout);
+
+        if (once)
+            return 0;
+
+        previous = stats;
+        previousTime = now;
+    }
+}
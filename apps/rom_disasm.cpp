@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cstdio>
+
+#include "cartridge/Cartridge.h"
+#include "utils/Logger.h"
+#include "utils/StaticDisassembler.h"
+
+// Whole-ROM static disassembler
+// Follows code flow from the interrupt vectors through every reachable PRG
+// bank and writes an assembler-style listing.
+// Usage: ./rom_disasm game.nes [out.asm]
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <rom.nes> [out.asm]\n", argv[0]);
+        return 1;
+    }
+
+    Logger::GetInstance().SetLogLevel(LogLevel::WARN);
+
+    Cartridge cartridge;
+    if (!cartridge.LoadFromFile(argv[1]))
+    {
+        std::fprintf(stderr, "Failed to load %s\n", argv[1]);
+        return 1;
+    }
+
+    StaticDisassembler disassembler;
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = disassembler.Analyze(cartridge);
+    auto end = std::chrono::steady_clock::now();
+
+    if (!ok)
+        return 1;
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    if (argc >= 3)
+    {
+        if (!disassembler.WriteListing(argv[2]))
+            return 1;
+    }
+    else
+    {
+        disassembler.WriteListing(stdout);
+    }
+
+    std::fprintf(stderr, "%zu instructions, %zu code bytes, %zu unresolved targets in %.2f ms\n",
+                 disassembler.GetInstructionCount(),
+                 disassembler.GetCodeBytes(),
+                 disassembler.GetUnresolved().size(),
+                 ms);
+    return 0;
+}
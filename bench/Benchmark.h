@@ -0,0 +1,100 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+// Minimal microbenchmark runner.
+// Each benchmark body is timed over several samples; the median is reported
+// so results stay stable enough to diff across commits.
+class BenchmarkRunner
+{
+public:
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations; // operations per sample
+        double nsPerOp;      // median over all samples
+        double minNsPerOp;
+        double maxNsPerOp;
+    };
+
+    // Body runs the measured operation `n` times
+    using Body = std::function<void(uint64_t n)>;
+
+    explicit BenchmarkRunner(int samples = 15, const std::string& filter = "")
+        : _samples(samples), _filter(filter)
+    {}
+
+    void Run(const std::string& name, uint64_t iterations, const Body& body)
+    {
+        if (!_filter.empty() && name.find(_filter) == std::string::npos)
+            return;
+
+        // Warm-up pass (caches, branch predictors, lazy allocations)
+        body(iterations);
+
+        std::vector<double> samples;
+        samples.reserve(_samples);
+
+        for (int i = 0; i < _samples; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            body(iterations);
+            auto end = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            samples.push_back(ns / (double) iterations);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        Result r;
+        r.name       = name;
+        r.iterations = iterations;
+        r.nsPerOp    = samples[samples.size() / 2];
+        r.minNsPerOp = samples.front();
+        r.maxNsPerOp = samples.back();
+        _results.push_back(r);
+
+        std::fprintf(stderr, "%-32s %12.2f ns/op\n", name.c_str(), r.nsPerOp);
+    }
+
+    void WriteJSON(FILE* out) const
+    {
+        std::fprintf(out, "{\n");
+        std::fprintf(out, "  \"suite\": \"nes_bench\",\n");
+        std::fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+        std::fprintf(out, "  \"samples\": %d,\n", _samples);
+        std::fprintf(out, "  \"results\": [\n");
+
+        for (size_t i = 0; i < _results.size(); ++i)
+        {
+            const Result& r = _results[i];
+            std::fprintf(out,
+                "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                "\"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+                r.name.c_str(),
+                (unsigned long long) r.iterations,
+                r.nsPerOp, r.minNsPerOp, r.maxNsPerOp,
+                r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0,
+                (i + 1 < _results.size()) ? "," : "");
+        }
+
+        std::fprintf(out, "  ]\n");
+        std::fprintf(out, "}\n");
+    }
+
+private:
+    int _samples;
+    std::string _filter;
+    std::vector<Result> _results;
+};
+
+#endif // BENCHMARK_H
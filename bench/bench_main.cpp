@@ -0,0 +1,516 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../tests/TestROM.h"
+#include "bus/Bus.h"
+#include "machine/Machine.h"
+#include "machine/VecEnv.h"
+#include "ppu/Display.h"
+#include "ppu/PPUPipeline.h"
+#include "utils/Debugger.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+#include "utils/Profiler.h"
+#include "utils/Recorder.h"
+
+
+// Keeps the optimizer from discarding benchmark results
+static volatile uint64_t g_sink = 0;
+
+
+// Synthetic iNES image for the given mapper, every PRG/CHR byte patterned
+static std::vector<uint8_t> MakeROM(uint8_t mapper, uint8_t prgBanks, uint8_t chrBanks)
+{
+    std::vector<uint8_t> rom = MakeTestROM({}, mapper, prgBanks, chrBanks);
+
+    for (size_t i = TEST_ROM_PRG; i < rom.size(); ++i)
+        rom[i] = (uint8_t) (i * 7);
+
+    return rom;
+}
+
+// Repeat an instruction sequence and close the loop with JMP $8000
+static std::vector<uint8_t> MakeLoop(const std::vector<uint8_t>& prologue,
+                                     const std::vector<uint8_t>& body,
+                                     int repeat = 16)
+{
+    std::vector<uint8_t> program(prologue);
+    for (int i = 0; i < repeat; ++i)
+        program.insert(program.end(), body.begin(), body.end());
+
+    program.push_back(0x4C); // JMP $8000
+    program.push_back(0x00);
+    program.push_back(0x80);
+    return program;
+}
+
+
+// CPU + flat 64KB memory, no cartridge
+struct CPUSystem
+{
+    Memory memory;
+    Bus bus;
+    CPU cpu;
+
+    CPUSystem()
+    {
+        bus.ConnectMemory(&memory);
+        bus.ConnectCPU(&cpu);
+        bus.Reset();
+    }
+
+    void Load(const std::vector<uint8_t>& program, uint16_t address = 0x8000)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+            bus.CPUWrite(address + i, program[i]);
+        cpu.PC = 0x8000;
+    }
+};
+
+// Full system with a cartridge inserted
+struct NESSystem
+{
+    Memory memory;
+    Bus bus;
+    CPU cpu;
+    PPU ppu;
+    Cartridge cartridge;
+
+    explicit NESSystem(const std::vector<uint8_t>& rom)
+    {
+        bus.ConnectMemory(&memory);
+        bus.ConnectCPU(&cpu);
+        bus.ConnectPPU(&ppu);
+        cartridge.LoadFromMemory(rom);
+        bus.InsertCartridge(&cartridge);
+        bus.Reset();
+    }
+};
+
+
+static void BenchCPU(BenchmarkRunner& runner)
+{
+    struct OpcodeClass
+    {
+        const char* name;
+        std::vector<uint8_t> prologue;
+        std::vector<uint8_t> body;
+    };
+
+    const std::vector<OpcodeClass> classes = {
+        { "load_store", {}, { 0xA9, 0x10, 0xA5, 0x10, 0xAD, 0x00, 0x02, 0xBD, 0x00, 0x02,
+                              0x85, 0x11, 0x8D, 0x01, 0x02, 0xA2, 0x01, 0xA0, 0x02 } },
+        { "transfer",   {}, { 0xAA, 0xA8, 0x8A, 0x98, 0xBA, 0x9A } },
+        { "arithmetic", {}, { 0x69, 0x01, 0x65, 0x10, 0xE9, 0x01, 0xE6, 0x10, 0xC6, 0x10,
+                              0xE8, 0xCA, 0xC8, 0x88 } },
+        { "logical",    {}, { 0x29, 0x0F, 0x09, 0xF0, 0x49, 0xFF, 0x25, 0x10, 0x24, 0x10 } },
+        { "shift",      {}, { 0x0A, 0x4A, 0x2A, 0x6A, 0x06, 0x10, 0x66, 0x10 } },
+        { "compare",    {}, { 0xC9, 0x10, 0xC5, 0x10, 0xE0, 0x10, 0xC0, 0x10 } },
+        { "branch",     { 0x18 }, { 0x90, 0x00, 0xB0, 0x00 } },   // CLC; BCC taken, BCS not
+        { "stack",      {}, { 0x48, 0x68, 0x08, 0x28 } },
+        { "flags",      {}, { 0x18, 0x38, 0xD8, 0xB8, 0x78, 0x58 } },
+        { "illegal",    {}, { 0xA7, 0x10, 0x87, 0x10, 0xC7, 0x10, 0xE7, 0x10, 0x07, 0x10,
+                              0x04, 0x10 } },
+    };
+
+    for (const OpcodeClass& c : classes)
+    {
+        CPUSystem sys;
+        sys.Load(MakeLoop(c.prologue, c.body));
+
+        runner.Run(std::string("cpu_step/") + c.name, 1 << 16, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+                sys.cpu.Step();
+            g_sink += sys.cpu.A;
+        });
+    }
+
+    // JSR/RTS pairs: subroutine at $8100 is a single RTS
+    {
+        CPUSystem sys;
+        sys.Load(MakeLoop({}, { 0x20, 0x00, 0x81 }));
+        sys.bus.CPUWrite(0x8100, 0x60);
+
+        runner.Run("cpu_step/jump", 1 << 16, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+                sys.cpu.Step();
+            g_sink += sys.cpu.PC;
+        });
+    }
+}
+
+static void BenchBus(BenchmarkRunner& runner)
+{
+    NESSystem sys(MakeROM(0, 2, 1));
+
+    struct Region
+    {
+        const char* name;
+        uint16_t base;
+        uint16_t mask; // offset mask within the region
+    };
+
+    const std::vector<Region> reads = {
+        { "ram",        0x0000, 0x07FF },
+        { "ppu",        0x2002, 0x0000 },
+        { "apu",        0x4000, 0x0000 },
+        { "controller", 0x4016, 0x0000 },
+        { "prg_ram",    0x6000, 0x1FFF },
+        { "prg_rom",    0x8000, 0x7FFF },
+    };
+
+    for (const Region& r : reads)
+    {
+        runner.Run(std::string("bus_read/") + r.name, 1 << 18, [&](uint64_t n) {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i)
+                sum += sys.bus.CPURead(r.base + ((i * 97) & r.mask));
+            g_sink += sum;
+        });
+    }
+
+    const std::vector<Region> writes = {
+        { "ram",     0x0000, 0x07FF },
+        { "ppu",     0x2003, 0x0000 },
+        { "apu",     0x4000, 0x0000 },
+        { "prg_ram", 0x6000, 0x1FFF },
+        { "mapper",  0x8000, 0x7FFF },
+    };
+
+    for (const Region& r : writes)
+    {
+        runner.Run(std::string("bus_write/") + r.name, 1 << 18, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+                sys.bus.CPUWrite(r.base + ((i * 97) & r.mask), (uint8_t) i);
+        });
+    }
+}
+
+static void BenchPPU(BenchmarkRunner& runner)
+{
+    NESSystem sys(MakeROM(0, 2, 1));
+
+    // Scatter all 64 sprites over the screen so evaluation finds hits
+    sys.ppu.CPUWrite(0x2003, 0x00);
+    for (int i = 0; i < 64; ++i)
+    {
+        sys.ppu.CPUWrite(0x2004, (uint8_t) (i * 3));  // Y
+        sys.ppu.CPUWrite(0x2004, (uint8_t) i);        // tile
+        sys.ppu.CPUWrite(0x2004, (uint8_t) (i & 0x03)); // attributes
+        sys.ppu.CPUWrite(0x2004, (uint8_t) (i * 4));  // X
+    }
+
+    sys.ppu.CPUWrite(0x2000, 0x80); // NMI on
+    sys.ppu.CPUWrite(0x2001, 0x1E); // background + sprites
+
+    runner.Run("ppu_clock/frame", 8, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            do {
+                sys.ppu.Clock();
+            } while (!sys.ppu.IsFrameComplete());
+            sys.ppu.ClearFrameComplete();
+        }
+        g_sink += sys.ppu.GetScreenBuffer()[0];
+    });
+
+    sys.ppu.SetSkipRender(true);
+    runner.Run("ppu_clock/frame_skip", 8, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            do {
+                sys.ppu.Clock();
+            } while (!sys.ppu.IsFrameComplete());
+            sys.ppu.ClearFrameComplete();
+        }
+        g_sink += sys.ppu.GetScreenBuffer()[0];
+    });
+    sys.ppu.SetSkipRender(false);
+}
+
+static void BenchSystem(BenchmarkRunner& runner)
+{
+    // NROM-256 with a small busy loop at reset and an RTI at the NMI vector
+    std::vector<uint8_t> rom = MakeROM(0, 2, 1);
+    const std::vector<uint8_t> loop = MakeLoop({}, { 0xB5, 0x00, 0xE8, 0x9D, 0x00, 0x02 }, 4);
+    std::copy(loop.begin(), loop.end(), rom.begin() + TEST_ROM_PRG);
+    rom[TEST_ROM_PRG + 0x7000] = 0x40;                  // RTI at $F000
+    SetTestROMVector(rom, 0xFFFA, 0xF000);
+    SetTestROMVector(rom, 0xFFFC, 0x8000);
+
+    // Plain, profiled, with an attached-but-unarmed debugger, and with
+    // pixels drawn on a second thread (synced every frame)
+    static const char* const NAMES[] = { "system/frame", "system/frame_profiled", "system/frame_debugger",
+                                         "system/frame_pipelined" };
+
+    for (int variant = 0; variant < 4; ++variant)
+    {
+        NESSystem sys(rom);
+        Profiler profiler;
+        Debugger debugger;
+        PPUPipeline pipeline;
+        if (variant == 1)
+            sys.bus.AttachProfiler(&profiler);
+        if (variant == 2)
+            sys.bus.AttachDebugger(&debugger);
+        if (variant == 3)
+            pipeline.Start(&sys.ppu, &sys.cartridge);
+
+        sys.ppu.CPUWrite(0x2000, 0x80); // NMI on
+        sys.ppu.CPUWrite(0x2001, 0x1E); // background + sprites
+
+        runner.Run(NAMES[variant], 8, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                do {
+                    sys.bus.Clock();
+                } while (!sys.ppu.IsFrameComplete());
+                sys.ppu.ClearFrameComplete();
+                pipeline.Sync();
+            }
+            g_sink += sys.cpu.X;
+        });
+    }
+}
+
+static void BenchMachine(BenchmarkRunner& runner)
+{
+    // Same busy loop as BenchSystem, a few frames in so RAM and VRAM have
+    // been written
+    std::vector<uint8_t> rom = MakeROM(0, 2, 1);
+    const std::vector<uint8_t> loop = MakeLoop({}, { 0xB5, 0x00, 0xE8, 0x9D, 0x00, 0x02 }, 4);
+    std::copy(loop.begin(), loop.end(), rom.begin() + TEST_ROM_PRG);
+    rom[TEST_ROM_PRG + 0x7000] = 0x40;
+    SetTestROMVector(rom, 0xFFFA, 0xF000);
+    SetTestROMVector(rom, 0xFFFC, 0x8000);
+
+    Machine machine;
+    machine.LoadFromMemory(rom);
+    machine.GetPPU().CPUWrite(0x2000, 0x80);
+    machine.GetPPU().CPUWrite(0x2001, 0x1E);
+    for (int i = 0; i < 4; ++i)
+        machine.RunFrame();
+
+    // Fork alone, then fork and play one frame on the copy
+    runner.Run("machine/fork", 1 << 10, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            g_sink += machine.Fork()->GetFrameCount();
+    });
+
+    runner.Run("machine/fork_frame", 8, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            std::unique_ptr<Machine> fork = machine.Fork();
+            fork->RunFrame();
+            g_sink += fork->GetCPU().X;
+        }
+    });
+
+    // One frame per accuracy tier
+    static const char* const TIERS[] = { "machine/frame_fast", "machine/frame_balanced", "machine/frame_exact" };
+    static const Accuracy ACCURACIES[] = { Accuracy::FAST, Accuracy::BALANCED, Accuracy::EXACT };
+
+    for (int tier = 0; tier < 3; ++tier)
+    {
+        Machine tiered(ACCURACIES[tier]);
+        tiered.LoadFromMemory(rom);
+        tiered.GetPPU().CPUWrite(0x2000, 0x80);
+        tiered.GetPPU().CPUWrite(0x2001, 0x1E);
+
+        runner.Run(TIERS[tier], 8, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+                tiered.RunFrame();
+            g_sink += tiered.GetCPU().X;
+        });
+    }
+
+    // One batched step of 8 environments with the usual RL settings
+    // (4 frames per action, 128x120 grayscale plus RAM)
+    VecEnv::Config config;
+    config.downsample = 2;
+    VecEnv env;
+    if (env.Init(rom, 8, config))
+    {
+        std::vector<uint8_t> actions(env.GetCount(), 0);
+        runner.Run("vecenv/step8_skip4", 2, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                actions[i % actions.size()] ^= Controller::A;
+                env.Step(actions.data());
+            }
+            g_sink += env.GetObservations()[0];
+        });
+    }
+}
+
+static void BenchCartridge(BenchmarkRunner& runner)
+{
+    struct MapperConfig
+    {
+        const char* name;
+        uint8_t mapper;
+        uint8_t prgBanks;
+        uint8_t chrBanks;
+    };
+
+    const std::vector<MapperConfig> mappers = {
+        { "nrom",  0,  2, 1 },
+        { "mmc1",  1,  8, 4 },
+        { "uxrom", 2,  8, 0 },
+        { "cnrom", 3,  2, 4 },
+        { "mmc3",  4, 16, 16 },
+        { "axrom", 7,  8, 0 },
+        { "gxrom", 66, 4, 4 },
+    };
+
+    for (const MapperConfig& m : mappers)
+    {
+        Cartridge cartridge;
+        cartridge.LoadFromMemory(MakeROM(m.mapper, m.prgBanks, m.chrBanks));
+        cartridge.Reset();
+
+        runner.Run(std::string("cartridge_read/") + m.name, 1 << 18, [&](uint64_t n) {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i)
+                sum += cartridge.CPURead(0x8000 + ((i * 97) & 0x7FFF));
+            g_sink += sum;
+        });
+
+        runner.Run(std::string("cartridge_chr/") + m.name, 1 << 18, [&](uint64_t n) {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i)
+                sum += cartridge.PPURead((i * 97) & 0x1FFF);
+            g_sink += sum;
+        });
+    }
+}
+
+static void BenchDisplay(BenchmarkRunner& runner)
+{
+    std::vector<uint8_t> screen(Display::NES_WIDTH * Display::NES_HEIGHT);
+    std::vector<uint32_t> pixels(Display::NES_WIDTH * Display::NES_HEIGHT);
+
+    for (size_t i = 0; i < screen.size(); ++i)
+        screen[i] = (uint8_t) (i % 64);
+
+    runner.Run("display/convert_frame", 64, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            Display::ConvertFrame(screen.data(), pixels.data(), Display::NES_WIDTH * 4);
+        g_sink += pixels[1234];
+    });
+
+    // Sustained headless capture: blocking pushes, so this is the slower of
+    // the handoff and the writer's conversion
+    Recorder recorder;
+    if (recorder.Open("/dev/null", Recorder::FORMAT_Y4M, Recorder::BACKPRESSURE_BLOCK))
+    {
+        runner.Run("recorder/y4m_sustained", 64, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+                g_sink += recorder.PushFrame(screen.data());
+        });
+    }
+}
+
+static void BenchLogger(BenchmarkRunner& runner)
+{
+    // TRACE lines as emitted while CPU debugging, written to a throwaway file
+    Logger& logger = Logger::GetInstance();
+    logger.SetConsoleOutput(false);
+    logger.Initialize("/dev/null", LogLevel::TRACE);
+
+    runner.Run("logger/trace", 1 << 12, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            LOG_TRACE("PC=%04X A=%02X X=%02X Y=%02X", (unsigned) (0x8000 + i), 1, 2, 3);
+    });
+
+    logger.Shutdown();
+    logger.SetFileOutput(false);
+    logger.SetConsoleOutput(true);
+    logger.SetLogLevel(LogLevel::WARN);
+}
+
+static void BenchDisassembler(BenchmarkRunner& runner)
+{
+    CPUSystem sys;
+
+    // Mixed-mode code stream
+    sys.Load(MakeLoop({}, { 0xA9, 0x10, 0xBD, 0x00, 0x02, 0xB1, 0x10, 0x6C, 0x00, 0x02,
+                            0xD0, 0xFE, 0x0A, 0xE8, 0x81, 0x20 }, 64));
+
+    runner.Run("disassembler/disassemble", 1 << 14, [&](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i)
+            sum += Disassembler::Disassemble(sys.cpu, 0x8000 + (i & 0x03FF)).size();
+        g_sink += sum;
+    });
+
+    // Allocation-free path: caller buffer, side-effect-free peeks
+    runner.Run("disassembler/disassemble_buffer", 1 << 14, [&](uint64_t n) {
+        char line[64];
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i)
+            sum += Disassembler::Disassemble(sys.bus, 0x8000 + (i & 0x03FF), line, sizeof(line));
+        g_sink += sum;
+    });
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* outPath = nullptr;
+    std::string filter;
+    int samples = 15;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            samples = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--out file.json] [--filter substr] [--samples n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Keep component init chatter out of the measurements
+    Logger::GetInstance().SetLogLevel(LogLevel::WARN);
+
+    BenchmarkRunner runner(samples, filter);
+
+    BenchCPU(runner);
+    BenchBus(runner);
+    BenchPPU(runner);
+    BenchSystem(runner);
+    BenchMachine(runner);
+    BenchCartridge(runner);
+    BenchDisplay(runner);
+    BenchDisassembler(runner);
+    BenchLogger(runner);
+
+    FILE* out = stdout;
+    if (outPath)
+    {
+        out = std::fopen(outPath, "w");
+        if (!out)
+        {
+            std::fprintf(stderr, "Failed to open %s\n", outPath);
+            return 1;
+        }
+    }
+
+    runner.WriteJSON(out);
+
+    if (out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
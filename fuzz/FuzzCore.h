@@ -0,0 +1,49 @@
+#ifndef FUZZ_CORE_H
+#define FUZZ_CORE_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+// A 6502 core as seen by the lockstep fuzzer: a flat 64KB memory image,
+// driven one instruction at a time. Each implementation (current core,
+// reference core, future fast cores) gets a small adapter.
+class FuzzCore
+{
+public:
+    static constexpr size_t MEMORY_SIZE = 0x10000;
+
+    struct Registers
+    {
+        uint8_t a, x, y, sp, p;
+        uint16_t pc;
+
+        bool operator==(const Registers& other) const
+        {
+            return a == other.a && x == other.x && y == other.y
+                && sp == other.sp && p == other.p && pc == other.pc;
+        }
+        bool operator!=(const Registers& other) const { return !(*this == other); }
+    };
+
+    virtual ~FuzzCore() = default;
+
+    virtual const char* GetName() const = 0;
+
+    // Replace memory and registers; no reset sequence is run
+    virtual void Load(const uint8_t* memory, const Registers& registers) = 0;
+
+    // Patch one byte between instructions (lazy code generation)
+    virtual void Poke(uint16_t address, uint8_t value) = 0;
+
+    // Execute one instruction; returns the cycles it took
+    virtual uint32_t Step() = 0;
+
+    virtual Registers GetRegisters() const = 0;
+    virtual const uint8_t* GetMemory() const = 0;
+
+    // One byte of memory, cheaper than GetMemory() on paged cores
+    virtual uint8_t Peek(uint16_t address) const = 0;
+};
+
+#endif // FUZZ_CORE_H
@@ -0,0 +1,129 @@
+#include <cstring>
+
+#include "RefCore.h"
+
+// Reference sources (compiled with -DBus=RefBus -DMemory=RefMemory ...)
+#include "bus/Bus.hpp"
+#include "cpu/CPU6502.hpp"
+#include "cpu/Instructions.hpp"
+#include "mem/Memory.hpp"
+
+
+// Flat 64KB that logs writes and notes accesses to the NES I/O range
+class LoggingMemory : public Memory
+{
+public:
+    uint8_t read(uint16_t address) const override
+    {
+        if (0x2000 <= address && address < 0x4020)
+            touchedIO = true;
+        return data[address];
+    }
+
+    void write(uint16_t address, uint8_t value) override
+    {
+        if (0x2000 <= address && address < 0x4020)
+            touchedIO = true;
+        writes.push_back({ address, data[address], value });
+        data[address] = value;
+    }
+
+    uint8_t data[FuzzCore::MEMORY_SIZE];
+    mutable bool touchedIO = false;
+    std::vector<RefCore::Write> writes;
+};
+
+struct RefCore::Impl
+{
+    LoggingMemory memory;
+    Bus bus;
+    CPU6502 cpu;
+
+    // ADC, SBC and the unofficial opcodes built on them
+    bool UsesAdder(uint16_t pc) const
+    {
+        auto operate = instructionTable[memory.data[pc]].operate;
+        return operate == &CPU6502::ADC || operate == &CPU6502::SBC
+            || operate == &CPU6502::RRA || operate == &CPU6502::ISC;
+    }
+};
+
+
+RefCore::RefCore()
+    : _impl(std::make_unique<Impl>())
+{
+    std::memset(_impl->memory.data, 0, sizeof(_impl->memory.data));
+    _impl->memory.writes.reserve(8);
+    _impl->bus.attachMemory(&_impl->memory);
+    _impl->cpu.connectBus(&_impl->bus);
+
+    // Run the reset sequence once so the core sits at an instruction boundary
+    _impl->cpu.reset();
+    while (!_impl->cpu.complete())
+        _impl->cpu.clock();
+}
+
+RefCore::~RefCore() = default;
+
+void RefCore::Load(const uint8_t* memory, const Registers& registers)
+{
+    std::memcpy(_impl->memory.data, memory, MEMORY_SIZE);
+
+    CPU6502& cpu = _impl->cpu;
+    cpu.A = registers.a;
+    cpu.X = registers.x;
+    cpu.Y = registers.y;
+    cpu.SP = registers.sp;
+    cpu.P = registers.p;
+    cpu.PC = registers.pc;
+}
+
+void RefCore::Poke(uint16_t address, uint8_t value)
+{
+    _impl->memory.data[address] = value;
+}
+
+uint32_t RefCore::Step()
+{
+    _impl->memory.writes.clear();
+    _impl->memory.touchedIO = false;
+
+    // The 2A03 has no BCD: run the adder in binary, keeping D as it was
+    CPU6502& cpu = _impl->cpu;
+    uint8_t decimal = cpu.P & CPU6502::D;
+    if (decimal && _impl->UsesAdder(cpu.PC))
+        cpu.P &= (uint8_t) ~CPU6502::D;
+    else
+        decimal = 0;
+
+    uint64_t before = cpu.totalCycles();
+    cpu.step();
+    cpu.P |= decimal;
+    return (uint32_t) (cpu.totalCycles() - before);
+}
+
+FuzzCore::Registers RefCore::GetRegisters() const
+{
+    const CPU6502& cpu = _impl->cpu;
+    return { cpu.A, cpu.X, cpu.Y, cpu.SP, cpu.P, cpu.PC };
+}
+
+const uint8_t* RefCore::GetMemory() const
+{
+    return _impl->memory.data;
+}
+
+const std::vector<RefCore::Write>& RefCore::GetWrites() const
+{
+    return _impl->memory.writes;
+}
+
+bool RefCore::TouchedIO() const
+{
+    return _impl->memory.touchedIO;
+}
+
+bool RefCore::IsSupported(uint8_t opcode)
+{
+    return instructionTable[opcode].operate != nullptr;
+}
@@ -0,0 +1,52 @@
+#ifndef REF_CORE_H
+#define REF_CORE_H
+
+#include <memory>
+#include <vector>
+
+#include "FuzzCore.h"
+
+
+// Adapter for the obsoleted CPU6502 core (obsoleted/src). Its sources are
+// built with their class names renamed (see the Makefile fuzz target), so
+// nothing from them may appear in this header.
+//
+// Besides memory, it records what each Step() wrote, so the fuzzer can
+// check just those bytes on the other core, and whether it touched
+// $2000-$401F, where the NES bus is not plain memory. Its decimal mode is
+// disabled, as on the NES 2A03.
+class RefCore : public FuzzCore
+{
+public:
+    struct Write
+    {
+        uint16_t address;
+        uint8_t before;
+        uint8_t after;
+    };
+
+    RefCore();
+    ~RefCore() override;
+
+    const char* GetName() const override { return "CPU6502 (obsoleted)"; }
+
+    void Load(const uint8_t* memory, const Registers& registers) override;
+    void Poke(uint16_t address, uint8_t value) override;
+    uint32_t Step() override;
+    Registers GetRegisters() const override;
+    const uint8_t* GetMemory() const override;
+    uint8_t Peek(uint16_t address) const override { return GetMemory()[address]; }
+
+    // Writes and I/O access of the last Step()
+    const std::vector<Write>& GetWrites() const;
+    bool TouchedIO() const;
+
+    // Opcodes without an implementation (executing one would crash)
+    static bool IsSupported(uint8_t opcode);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+#endif // REF_CORE_H
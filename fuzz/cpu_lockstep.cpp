@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FuzzCore.h"
+#include "RefCore.h"
+#include "bus/Bus.h"
+#include "cpu/Instructions.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+
+// Differential lockstep fuzzer: current CPU vs the obsoleted CPU6502 core.
+// Each program starts from a random 64KB image and random registers; code
+// is generated lazily (the first time PC reaches an address, a random
+// enabled opcode is written there), so branches and jumps into data keep
+// producing valid programs. After every instruction the registers, cycle
+// count and every byte the reference wrote are compared, with a full
+// memory compare every 256 instructions. The first mismatch is replayed,
+// reduced to a single instruction from a minimal memory image and printed.
+//
+// Runs that touch $2000-$401F stop early: those are registers on the NES
+// bus, not memory, so the cores can't be compared there.
+//
+// With --illegal, expect cycle mismatches from the reference: it adds a
+// page-cross cycle to the unofficial read-modify-write opcodes and misses
+// it on the indexed NOPs. --skip takes those opcodes out.
+//
+// Usage: ./cpu_lockstep [--programs N] [--length N] [--seed N] [--threads N]
+//                       [--illegal] [--skip <opcode hex>]...
+
+using Registers = FuzzCore::Registers;
+
+struct Options
+{
+    uint64_t programs = 10000;
+    uint64_t length = 1000;   // Instructions per program
+    uint64_t seed = 1;
+    unsigned threads = 0;
+    std::array<bool, 256> enabled {};
+    std::vector<uint8_t> opcodes; // Enabled opcodes, for drawing
+};
+
+struct Failure
+{
+    uint64_t program;
+    uint64_t step;
+    std::vector<uint8_t> memory; // Image before the failing instruction
+    Registers registers;
+    std::string what;
+};
+
+
+// The current core on the real Bus over flat Memory. A PPU is attached so
+// stray register accesses are harmless; the reference flags those runs.
+class SystemCore : public FuzzCore
+{
+public:
+    SystemCore()
+    {
+        _bus.ConnectMemory(&_memory);
+        _bus.ConnectCPU(&_cpu);
+        _bus.ConnectPPU(&_ppu);
+        _bus.Reset();
+
+        while (_cpu.GetCycles() > 0)
+            _cpu.Clock();
+    }
+
+    const char* GetName() const override { return "CPU"; }
+
+    void Load(const uint8_t* memory, const Registers& registers) override
+    {
+        for (size_t i = 0; i < MEMORY_SIZE; ++i)
+            _memory.Write((uint16_t) i, memory[i]);
+
+        _cpu.A = registers.a;
+        _cpu.X = registers.x;
+        _cpu.Y = registers.y;
+        _cpu.SP = registers.sp;
+        _cpu.P = registers.p;
+        _cpu.PC = registers.pc;
+    }
+
+    void Poke(uint16_t address, uint8_t value) override { _memory.Write(address, value); }
+
+    uint32_t Step() override
+    {
+        uint64_t before = _cpu.GetTotalCycles();
+        _cpu.Step();
+        return (uint32_t) (_cpu.GetTotalCycles() - before);
+    }
+
+    Registers GetRegisters() const override { return { _cpu.A, _cpu.X, _cpu.Y, _cpu.SP, _cpu.P, _cpu.PC }; }
+    const uint8_t* GetMemory() const override
+    {
+        // Memory is paged, the comparison wants one flat image
+        _memory.CopyTo(0x0000, _flat.data(), MEMORY_SIZE);
+        return _flat.data();
+    }
+
+    uint8_t Peek(uint16_t address) const override { return _memory.Read(address); }
+
+private:
+    Memory _memory;
+    Bus _bus;
+    CPU _cpu;
+    PPU _ppu;
+    mutable std::array<uint8_t, MEMORY_SIZE> _flat;
+};
+
+
+static std::string FormatRegisters(const Registers& r)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "A:%02X X:%02X Y:%02X P:%02X SP:%02X PC:%04X",
+                  r.a, r.x, r.y, r.p, r.sp, r.pc);
+    return buffer;
+}
+
+// Empty if both cores agree after an instruction
+static std::string Compare(const FuzzCore& core, uint32_t cycles, const RefCore& ref, uint32_t refCycles, bool fullMemory)
+{
+    char buffer[160];
+
+    // B and the unused bit only exist on the stack (PHP/BRK push them);
+    // how a core keeps them in P is not observable
+    Registers a = core.GetRegisters();
+    Registers b = ref.GetRegisters();
+    a.p &= 0xCF;
+    b.p &= 0xCF;
+    if (a != b)
+    {
+        std::snprintf(buffer, sizeof(buffer), "registers %s: %s, %s: %s",
+                      core.GetName(), FormatRegisters(a).c_str(), ref.GetName(), FormatRegisters(b).c_str());
+        return buffer;
+    }
+
+    if (cycles != refCycles)
+    {
+        std::snprintf(buffer, sizeof(buffer), "cycles %s: %u, %s: %u", core.GetName(), cycles, ref.GetName(), refCycles);
+        return buffer;
+    }
+
+    for (const RefCore::Write& write : ref.GetWrites())
+    {
+        uint8_t value = core.Peek(write.address);
+        uint8_t refValue = ref.Peek(write.address);
+        if (value != refValue)
+        {
+            std::snprintf(buffer, sizeof(buffer), "memory $%04X %s: %02X, %s: %02X", write.address,
+                          core.GetName(), value, ref.GetName(), refValue);
+            return buffer;
+        }
+    }
+
+    if (!fullMemory)
+        return std::string();
+
+    const uint8_t* memory = core.GetMemory();
+    const uint8_t* refMemory = ref.GetMemory();
+    if (std::memcmp(memory, refMemory, FuzzCore::MEMORY_SIZE) != 0)
+    {
+        size_t i = 0;
+        while (memory[i] == refMemory[i])
+            ++i;
+        std::snprintf(buffer, sizeof(buffer), "memory $%04zX %s: %02X, %s: %02X (not written by %s)", i,
+                      core.GetName(), memory[i], ref.GetName(), refMemory[i], ref.GetName());
+        return buffer;
+    }
+
+    return std::string();
+}
+
+// Random start image. Bytes $20-$40 are left out: as operand high bytes,
+// pointers or register values they would address the I/O range.
+static void GenerateState(std::mt19937_64& rng, std::vector<uint8_t>& memory, Registers& registers)
+{
+    for (size_t i = 0; i < FuzzCore::MEMORY_SIZE; i += 8)
+    {
+        uint64_t bits = rng();
+        for (int b = 0; b < 8; ++b)
+        {
+            uint8_t value = (uint8_t) (bits >> (b * 8));
+            if (value >= 0x20 && value <= 0x40)
+                value ^= 0x80;
+            memory[i + b] = value;
+        }
+    }
+
+    uint64_t bits = rng();
+    registers.a = memory[bits & 0xFFFF];
+    registers.x = memory[(bits >> 16) & 0xFFFF];
+    registers.y = memory[(bits >> 32) & 0xFFFF];
+    registers.sp = (uint8_t) (bits >> 48);
+    registers.p = (uint8_t) ((bits >> 56) | 0x20);
+    registers.pc = (uint16_t) ((memory[rng() & 0xFFFF] << 8) | (rng() & 0xFF));
+}
+
+// Run one program; returns false on a mismatch (filled into failure).
+// exact compares all of memory after every instruction, to pin down a
+// stray write the periodic check found.
+static bool RunProgram(uint64_t program, const Options& options, FuzzCore& core, RefCore& ref,
+                       bool exact, uint64_t& steps, bool& stoppedOnIO, Failure* failure)
+{
+    std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + program);
+
+    std::vector<uint8_t> memory(FuzzCore::MEMORY_SIZE);
+    Registers registers;
+    GenerateState(rng, memory, registers);
+
+    core.Load(memory.data(), registers);
+    ref.Load(memory.data(), registers);
+
+    std::vector<uint8_t> executed(FuzzCore::MEMORY_SIZE, 0);
+    stoppedOnIO = false;
+
+    for (steps = 0; steps < options.length; ++steps)
+    {
+        Registers before = ref.GetRegisters();
+        uint16_t pc = before.pc;
+
+        // Lazy code generation (also replaces opcodes the program wrote
+        // over its own code that aren't enabled)
+        if (!executed[pc] || !options.enabled[ref.GetMemory()[pc]])
+        {
+            uint8_t opcode = options.opcodes[rng() % options.opcodes.size()];
+            core.Poke(pc, opcode);
+            ref.Poke(pc, opcode);
+            executed[pc] = 1;
+        }
+
+        uint32_t refCycles = ref.Step();
+        uint32_t cycles = core.Step();
+
+        if (ref.TouchedIO())
+        {
+            stoppedOnIO = true;
+            return true;
+        }
+
+        bool fullMemory = exact || (steps & 0xFF) == 0xFF || steps + 1 == options.length;
+        std::string what = Compare(core, cycles, ref, refCycles, fullMemory);
+        if (!what.empty())
+        {
+            if (failure)
+            {
+                failure->program = program;
+                failure->step = steps;
+                failure->what = what;
+                failure->registers = before;
+
+                // Undo this instruction's writes to get the image it started from
+                failure->memory.assign(ref.GetMemory(), ref.GetMemory() + FuzzCore::MEMORY_SIZE);
+                const std::vector<RefCore::Write>& writes = ref.GetWrites();
+                for (auto it = writes.rbegin(); it != writes.rend(); ++it)
+                    failure->memory[it->address] = it->before;
+            }
+            ++steps;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Execute a single instruction from the given state on both cores
+static std::string RunSingle(FuzzCore& core, RefCore& ref, const std::vector<uint8_t>& memory, const Registers& registers)
+{
+    if (!RefCore::IsSupported(memory[registers.pc]))
+        return std::string();
+
+    core.Load(memory.data(), registers);
+    ref.Load(memory.data(), registers);
+
+    uint32_t refCycles = ref.Step();
+    uint32_t cycles = core.Step();
+    if (ref.TouchedIO())
+        return std::string();
+
+    return Compare(core, cycles, ref, refCycles, true);
+}
+
+// Zero ever smaller blocks of memory, then registers, while the cores
+// still disagree on the failing instruction
+static void Minimize(FuzzCore& core, RefCore& ref, Failure& failure)
+{
+    std::vector<uint8_t>& memory = failure.memory;
+    std::vector<uint8_t> saved;
+
+    for (size_t block = FuzzCore::MEMORY_SIZE / 2; block >= 1; block /= 2)
+    {
+        for (size_t start = 0; start < FuzzCore::MEMORY_SIZE; start += block)
+        {
+            auto first = memory.begin() + start;
+            auto last = first + block;
+            if (std::all_of(first, last, [](uint8_t b) { return b == 0; }))
+                continue;
+
+            saved.assign(first, last);
+            std::fill(first, last, 0);
+            if (RunSingle(core, ref, memory, failure.registers).empty())
+                std::copy(saved.begin(), saved.end(), first);
+        }
+    }
+
+    for (uint8_t* reg : { &failure.registers.a, &failure.registers.x, &failure.registers.y })
+    {
+        uint8_t value = *reg;
+        *reg = 0;
+        if (RunSingle(core, ref, memory, failure.registers).empty())
+            *reg = value;
+    }
+
+    failure.what = RunSingle(core, ref, memory, failure.registers);
+}
+
+static void Report(const Failure& failure, uint64_t seed)
+{
+    const Registers& r = failure.registers;
+
+    uint8_t bytes[3] = {
+        failure.memory[r.pc],
+        failure.memory[(uint16_t) (r.pc + 1)],
+        failure.memory[(uint16_t) (r.pc + 2)]
+    };
+    char line[64];
+    Disassembler::FormatInstruction(r.pc, bytes, line, sizeof(line));
+
+    std::printf("MISMATCH in program %llu (--seed %llu), instruction %llu\n",
+                (unsigned long long) failure.program, (unsigned long long) seed,
+                (unsigned long long) failure.step);
+    std::printf("  %s\n", failure.what.c_str());
+    std::printf("Minimized to one instruction:\n");
+    std::printf("  %04X  %s\n", r.pc, line);
+    std::printf("  start  %s\n", FormatRegisters(r).c_str());
+    std::printf("  memory (non-zero bytes):");
+
+    int count = 0;
+    for (size_t i = 0; i < failure.memory.size(); ++i)
+    {
+        if (failure.memory[i])
+            std::printf("%s$%04zX=%02X", (count++ % 8) ? " " : "\n    ", i, failure.memory[i]);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    Logger::GetInstance().SetLogLevel(LogLevel::WARN);
+
+    Options options;
+    bool illegal = false;
+    std::vector<int> skipped;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--programs") == 0 && i + 1 < argc)
+            options.programs = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--length") == 0 && i + 1 < argc)
+            options.length = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            options.threads = (unsigned) std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--illegal") == 0)
+            illegal = true;
+        else if (std::strcmp(argv[i], "--skip") == 0 && i + 1 < argc)
+            skipped.push_back((int) std::strtoul(argv[++i], nullptr, 16) & 0xFF);
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--programs N] [--length N] [--seed N] [--threads N]\n"
+                                 "       [--illegal] [--skip <opcode hex>]...\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Documented opcodes (plus unofficial ones with --illegal) that the
+    // reference implements
+    for (int op = 0; op < 256; ++op)
+    {
+        bool enabled = RefCore::IsSupported((uint8_t) op) && (illegal || IsOfficialOpcode((uint8_t) op))
+                    && std::find(skipped.begin(), skipped.end(), op) == skipped.end();
+        options.enabled[op] = enabled;
+        if (enabled)
+            options.opcodes.push_back((uint8_t) op);
+    }
+
+    if (options.opcodes.empty())
+    {
+        std::fprintf(stderr, "No opcodes enabled\n");
+        return 1;
+    }
+
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<uint64_t> next(0);
+    std::atomic<uint64_t> instructions(0);
+    std::atomic<uint64_t> stoppedOnIO(0);
+    std::atomic<bool> failed(false);
+    std::mutex failureMutex;
+    Failure failure;
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]()
+    {
+        auto core = std::make_unique<SystemCore>();
+        auto ref = std::make_unique<RefCore>();
+        uint64_t localInstructions = 0;
+        uint64_t localIO = 0;
+
+        for (uint64_t program; !failed.load(std::memory_order_relaxed)
+                               && (program = next.fetch_add(1)) < options.programs; )
+        {
+            uint64_t steps = 0;
+            bool io = false;
+            Failure found;
+
+            if (!RunProgram(program, options, *core, *ref, false, steps, io, &found))
+            {
+                // A write only the full compare caught may be from an
+                // earlier instruction: replay comparing everything
+                if (found.what.find("not written") != std::string::npos)
+                    RunProgram(program, options, *core, *ref, true, steps, io, &found);
+
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failed.exchange(true) || found.program < failure.program)
+                    failure = found;
+            }
+
+            localInstructions += steps;
+            localIO += io ? 1 : 0;
+        }
+
+        instructions += localInstructions;
+        stoppedOnIO += localIO;
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t programs = std::min<uint64_t>(next.load(), options.programs);
+
+    std::fprintf(stderr, "%llu programs, %llu instructions in %.2f s (%.2f M instr/s on %u threads), "
+                         "%llu stopped at I/O, %zu opcodes enabled\n",
+                 (unsigned long long) programs, (unsigned long long) instructions.load(), seconds,
+                 seconds > 0 ? instructions.load() / seconds / 1e6 : 0.0, threads,
+                 (unsigned long long) stoppedOnIO.load(), options.opcodes.size());
+
+    if (!failed)
+    {
+        std::printf("OK: no mismatches\n");
+        return 0;
+    }
+
+    SystemCore core;
+    RefCore ref;
+    Minimize(core, ref, failure);
+    Report(failure, options.seed);
+    return 1;
+}
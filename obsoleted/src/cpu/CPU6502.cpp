@@ -60,7 +60,7 @@ void CPU6502::clock()
             _opcode = _bus->read(PC++);
             auto& instruction = instructionTable[_opcode];
             
-#if 1
+#ifndef CPU6502_NO_TRACE
             const std::string ops = disassembleOperands();
             printf("%04X  %02X %02X %02X  %-4s %-28s A:%02X X:%02X Y:%02X P:%02X SP:%02X CYC:%lu\n",
                 PC,
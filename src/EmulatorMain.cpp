@@ -1,10 +1,20 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <iostream>
 
 #include "bus/Bus.h"
+#include "cartridge/SaveRAM.h"
 #include "ppu/Display.h"
+#include "ppu/PPUPipeline.h"
 #include "utils/Logger.h"
+#include "utils/Profiler.h"
+#include "utils/Recorder.h"
+#include "utils/Telemetry.h"
+#include "utils/TraceFormat.h"
 
 
 int main(int argc, char **argv)
@@ -13,6 +23,36 @@ int main(int argc, char **argv)
     LOG_INFO("|      My NES Emulator      |");
     LOG_INFO("+===========================+");
 
+    // Command line: nes_emulator [rom.nes] [--profile out.folded] [--trace out.ntr] [--record out.y4m]
+    //                             [--frameskip N] [--pipelined-ppu] [--telemetry]
+    // --frameskip N runs N frames without drawing for every frame shown (fast-forward)
+    // --pipelined-ppu draws on a second thread (same frames, two cores)
+    // --telemetry publishes live stats to shared memory (watch with nes_top)
+    const char* romPath = nullptr;
+    const char* profilePath = nullptr;
+    const char* tracePath = nullptr;
+    const char* recordPath = nullptr;
+    int frameSkip = 0;
+    bool pipelinedPPU = false;
+    bool telemetryEnabled = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profilePath = argv[++i];
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--frameskip") == 0 && i + 1 < argc)
+            frameSkip = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--pipelined-ppu") == 0)
+            pipelinedPPU = true;
+        else if (std::strcmp(argv[i], "--telemetry") == 0)
+            telemetryEnabled = true;
+        else
+            romPath = argv[i];
+    }
+
     std::unique_ptr<Bus>    bus = std::make_unique<Bus>();
     std::unique_ptr<Memory> memory = std::make_unique<Memory>();
     std::unique_ptr<CPU>    cpu = std::make_unique<CPU>();
@@ -39,9 +79,9 @@ int main(int argc, char **argv)
 
     // Load ROM file here
     bool romLoaded = false;
-    if (argc >= 2)
+    if (romPath)
     {
-        if (cartridge->LoadFromFile(argv[1]))
+        if (cartridge->LoadFromFile(romPath))
         {
             bus->InsertCartridge(cartridge.get());
             romLoaded = true;
@@ -56,6 +96,46 @@ int main(int argc, char **argv)
         LOG_INFO("No ROM specified, running test pattern");
     }
 
+    // Battery saves live next to the ROM and are written in the background
+    std::unique_ptr<SaveRAM> saveRAM;
+    if (romLoaded && cartridge->HasBattery())
+    {
+        saveRAM = std::make_unique<SaveRAM>();
+        if (!saveRAM->Open(SaveRAM::GetSavePath(romPath), cartridge.get()))
+            saveRAM.reset();
+    }
+
+    // Guest code profiler
+    std::unique_ptr<Profiler> profiler;
+    if (profilePath)
+    {
+        profiler = std::make_unique<Profiler>();
+        bus->AttachProfiler(profiler.get());
+        LOG_INFO("Profiling guest code, 1 sample per %u CPU cycles", profiler->GetInterval());
+    }
+
+    // Binary instruction trace (decode with trace_decode)
+    std::unique_ptr<TraceWriter> tracer;
+    if (tracePath)
+    {
+        tracer = std::make_unique<TraceWriter>();
+        if (tracer->Open(tracePath))
+            bus->AttachTracer(tracer.get());
+    }
+
+    // Video capture (.y4m, anything else is raw RGB24); drops frames
+    // rather than slowing the game down if the disk can't keep up
+    std::unique_ptr<Recorder> recorder;
+    if (recordPath)
+    {
+        std::string path = recordPath;
+        bool y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+
+        recorder = std::make_unique<Recorder>();
+        if (!recorder->Open(path, y4m ? Recorder::FORMAT_Y4M : Recorder::FORMAT_RGB24))
+            recorder.reset();
+    }
+
     // Reset system
     bus->Reset();
     LOG_INFO("CPU initialized successfully!");
@@ -119,6 +199,28 @@ int main(int argc, char **argv)
         LOG_INFO("ROM loaded, starting emulation...");
     }
 
+    // Input is read when the game strobes $4016, not before the frame,
+    // so it is as fresh as possible when the game acts on it
+    bus->SetInputProvider(0, [&display]() { return display->PollControllerState(0); });
+    bus->SetInputProvider(1, [&display]() { return display->PollControllerState(1); });
+
+    // Pixels on a render thread; the PPU calls below are forwarded to it
+    std::unique_ptr<PPUPipeline> pipeline;
+    if (pipelinedPPU)
+    {
+        pipeline = std::make_unique<PPUPipeline>();
+        if (!pipeline->Start(ppu.get(), romLoaded ? cartridge.get() : nullptr))
+            pipeline.reset();
+    }
+
+    std::unique_ptr<TelemetryWriter> telemetry;
+    if (telemetryEnabled)
+    {
+        telemetry = std::make_unique<TelemetryWriter>();
+        if (!telemetry->Open())
+            telemetry.reset();
+    }
+
     // Main emulation loop
     LOG_INFO("Entering main loop... (Press ESC to exit)");
 
@@ -129,9 +231,25 @@ int main(int argc, char **argv)
         // Handle input events
         display->HandleEvents();
 
-        // Poll both gamepads and hand them to the bus before clocking the frame
-        bus->SetControllerState(0, display->GetControllerState(0));
-        bus->SetControllerState(1, display->GetControllerState(1));
+        auto emulateStart = std::chrono::steady_clock::now();
+
+        // Skipped frames still run the game exactly, they just don't draw
+        for (int skipped = 0; skipped < frameSkip; ++skipped)
+        {
+            ppu->SetSkipRender(true);
+            do
+            {
+                bus->Clock();
+            } while (!ppu->IsFrameComplete());
+            ppu->ClearFrameComplete();
+        }
+        ppu->SetSkipRender(false);
+
+        // The PPU draws straight into the locked texture while it runs
+        uint32_t* pixels = nullptr;
+        int pitch = 0;
+        bool locked = display->LockFrame(&pixels, &pitch);
+        ppu->SetOutputBuffer(locked ? pixels : nullptr, pitch);
 
         // Clock the system until frame is complete
         do
@@ -139,18 +257,39 @@ int main(int argc, char **argv)
             bus->Clock();
         } while (!ppu->IsFrameComplete());
 
-        // Frame is ready - render it
+        // Frame is ready - render it (when pipelined, this waits for the
+        // render thread to finish drawing it)
+        auto renderStart = std::chrono::steady_clock::now();
         ppu->ClearFrameComplete();
+        ppu->SetOutputBuffer(nullptr, 0);
+        auto renderEnd = std::chrono::steady_clock::now();
+
+        if (recorder)
+            recorder->PushFrame(ppu->GetScreenBuffer());
+
+        if (saveRAM)
+            saveRAM->Sync();
 
         // Clear screen with a background color
         display->Clear();
 
-        // Draw the checkerboard pattern
-        display->Render(ppu->GetScreenBuffer());
+        if (locked)
+            display->UnlockFrame();
 
         // Update the screen
         display->Present();
 
+        if (telemetry)
+        {
+            auto displayEnd = std::chrono::steady_clock::now();
+            const uint64_t phaseNs[TelemetryWriter::PHASE_COUNT] = {
+                (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(renderStart - emulateStart).count(),
+                (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(renderEnd - renderStart).count(),
+                (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(displayEnd - renderEnd).count()
+            };
+            telemetry->EndFrame(phaseNs, *cpu, (uint32_t) frameSkip + 1);
+        }
+
         // Print FPS
         frameCount++;
         if (frameCount % 60 == 0)
@@ -158,6 +297,28 @@ int main(int argc, char **argv)
     }
 
     LOG_INFO("Total frames rendered: %ld", frameCount);
+
+    if (pipeline)
+        pipeline->Stop();
+
+    if (telemetry)
+        telemetry->Close();
+
+    if (recorder)
+        recorder->Close();
+
+    if (saveRAM)
+        saveRAM->Close();
+
+    if (profiler)
+    {
+        profiler->WriteCollapsed(profilePath);
+        profiler->WriteReport(stdout);
+    }
+
+#ifdef CPU_OPCODE_STATS
+    cpu->GetOpcodeStats().Dump("opcode_stats.txt");
+#endif
     LOG_INFO("Emulator shutting down...");
     // display->Shutdown();
 
@@ -8,7 +8,11 @@ Bus::Bus()
     _ppu(nullptr),
     _memory(nullptr),
     _cartridge(nullptr),
-    _systemClockCounter(0)
+    _systemClockCounter(0),
+    _openBus(0),
+    _profiler(nullptr),
+    _tracer(nullptr),
+    _debugger(nullptr)
 {}
 
 Bus::~Bus()
@@ -26,7 +30,10 @@ void Bus::ConnectPPU(PPU* p)
 {
     _ppu = p;
     if (_ppu)
+    {
         _ppu->ConnectBus(this);
+        _ppu->AttachDebugger(_debugger);
+    }
 }
 
 void Bus::ConnectMemory(Memory* m)
@@ -43,30 +50,64 @@ void Bus::InsertCartridge(Cartridge* cart)
     }
 }
 
+void Bus::CopyStateFrom(const Bus& other)
+{
+    _systemClockCounter = other._systemClockCounter;
+    _openBus = other._openBus;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        _controllers[i] = other._controllers[i];
+        _controllers[i].SetInputProvider(nullptr);
+    }
+}
+
+void Bus::AttachDebugger(Debugger* debugger)
+{
+    _debugger = debugger;
+    if (_ppu)
+        _ppu->AttachDebugger(debugger);
+}
+
 uint8_t Bus::CPURead(uint16_t address)
 {
-    LOG_DEBUG("address=0x%04x", address);
+    return CPURead<BalancedAccuracy>(address);
+}
+
+template <class Policy>
+uint8_t Bus::CPURead(uint16_t address)
+{
+    if constexpr (Policy::TOOL_HOOKS)
+    {
+        LOG_DEBUG("address=0x%04x", address);
+
+        if (_debugger)
+            _debugger->OnCPURead(address);
+    }
 
     // Cartridge space ($4020-$FFFF, but mostly $6000-$FFFF)
-    if (_cartridge && address >= 0x6000)
+    // An empty slot falls through to flat memory (used by the CPU tests)
+    if (_cartridge && _cartridge->IsLoaded() && address >= 0x6000)
     {
         return _cartridge->CPURead(address);
     }
     // PPU registers ($2000-$3FFF, mirrored)
     else if (0x2000 <= address && address < 0x4000)
     {
-        return _ppu ? _ppu->CPURead(address) : 0x00;
+        return _ppu ? _ppu->CPURead<Policy>(address) : 0x00;
     }
     // Controller readers: $4016 for controller 1, $4017 for controller 2
     else if (address == 0x4016 || address == 0x4017)
     {
         uint8_t index = address & 0x0001; // 0 for $4016, 1 for $4017
-        return _controllers[index].Read();
+
+        // Only the low bits are driven, the rest float
+        return (_openBus & 0xE0) | _controllers[index].Read();
     }
     // APU and I/O registers ($4000-$4017)
     else if (0x4000 <= address && address < 0x4020)
     {
-
+        return _openBus;
     }
     // RAM & mirrors ($0000-$1FFF)
     else
@@ -77,19 +118,47 @@ uint8_t Bus::CPURead(uint16_t address)
     return 0x00; // Default return value for unmapped addresses
 }
 
+uint8_t Bus::CPUPeek(uint16_t address)
+{
+    if (_cartridge && _cartridge->IsLoaded() && address >= 0x6000)
+        return _cartridge->CPURead(address);
+
+    // PPU, APU and controller registers change state on read
+    if (0x2000 <= address && address < 0x4020)
+        return 0x00;
+
+    return _memory->Read(address);
+}
+
 void Bus::CPUWrite(uint16_t address, uint8_t data)
 {
-    LOG_DEBUG("address=0x%04x data=0x%02x", address, data);
+    CPUWrite<BalancedAccuracy>(address, data);
+}
+
+template <class Policy>
+void Bus::CPUWrite(uint16_t address, uint8_t data)
+{
+    if constexpr (Policy::TOOL_HOOKS)
+    {
+        LOG_DEBUG("address=0x%04x data=0x%02x", address, data);
+
+        if (_debugger)
+            _debugger->OnCPUWrite(address, data);
+    }
 
     // Cartridge space
-    if (_cartridge && address >= 0x6000)
+    if (_cartridge && _cartridge->IsLoaded() && address >= 0x6000)
     {
         _cartridge->CPUWrite(address, data);
+
+        // Mapper registers may switch mirroring or CHR banks
+        if (address >= 0x8000)
+            _ppu->OnCartridgeWrite(address, data);
     }
     // PPU registers ($2000-$3FFF, mirrored)
     else if (0x2000 <= address && address < 0x4000)
     {
-        _ppu->CPUWrite(address, data);
+        _ppu->CPUWrite<Policy>(address, data);
     }
     // OAM DMA ($4014)
     else if (address == 0x4014)
@@ -97,8 +166,8 @@ void Bus::CPUWrite(uint16_t address, uint8_t data)
         uint16_t pageStart = data << 8;
         for (uint16_t i = 0; i < 256; ++i)
         {
-            uint8_t value = CPURead(pageStart + i);
-            _ppu->CPUWrite(0x2004, value); // Write to OAMData
+            uint8_t value = CPURead<Policy>(pageStart + i);
+            _ppu->CPUWrite<Policy>(0x2004, value); // Write to OAMData
         }
         
         // DMA takes 513 or 514 cycles
@@ -122,27 +191,96 @@ void Bus::CPUWrite(uint16_t address, uint8_t data)
     }
 }
 
+template uint8_t Bus::CPURead<FastAccuracy>(uint16_t);
+template uint8_t Bus::CPURead<BalancedAccuracy>(uint16_t);
+template uint8_t Bus::CPURead<ExactAccuracy>(uint16_t);
+template void Bus::CPUWrite<FastAccuracy>(uint16_t, uint8_t);
+template void Bus::CPUWrite<BalancedAccuracy>(uint16_t, uint8_t);
+template void Bus::CPUWrite<ExactAccuracy>(uint16_t, uint8_t);
+
 void Bus::Reset()
 {
     LOG_INFO("Bus Reset");
 
     _systemClockCounter = 0;
+    _openBus = 0;
     if (_cpu) _cpu->Reset();
     if (_ppu) _ppu->Reset();
     if (_cartridge) _cartridge->Reset();
+    if (_ppu) _ppu->UpdateNametableMapping();
 }
 
 void Bus::Clock()
 {
+    Tick<BalancedAccuracy>();
+}
+
+template <class Policy>
+void Bus::Tick()
+{
+    if constexpr (!Policy::DOT_STEPPED)
+    {
+        // The CPU executes an instruction on its first cycle, and nothing
+        // it sees changes until the next one: run it, then all the PPU
+        // dots up to the next instruction boundary in one go
+        if (_systemClockCounter % 3 == 0 && _cpu->GetCycles() == 0)
+        {
+            _ppu->Clock<Policy>();
+            _cpu->Clock();
+
+            uint64_t remaining = _cpu->FinishInstruction();
+            for (uint64_t dot = 2 + 3 * remaining; dot > 0; --dot)
+                _ppu->Clock<Policy>();
+
+            PollInterrupts();
+            _systemClockCounter += 3 + 3 * remaining;
+            return;
+        }
+    }
+
+    // Debugger stops (and holds) the whole system at instruction boundaries
+    if constexpr (Policy::TOOL_HOOKS)
+    {
+        if (_debugger && _debugger->IsInstructionHookArmed()
+            && _systemClockCounter % 3 == 0 && _cpu->GetCycles() == 0
+            && _debugger->OnInstruction(_cpu->PC))
+            return;
+    }
+
     // PPU runs 3 times faster than CPU
-    _ppu->Clock();
+    _ppu->Clock<Policy>();
     
     // CPU runs every 3 PPU clocks
     if (_systemClockCounter % 3 == 0)
     {
+        // Trace each instruction just before it executes
+        if constexpr (Policy::TOOL_HOOKS)
+        {
+            if (_tracer && _cpu->GetCycles() == 0 && !_cpu->IsInterruptPending())
+                _tracer->Capture(*this);
+        }
+
         _cpu->Clock();
+
+        if constexpr (Policy::TOOL_HOOKS)
+        {
+            if (_profiler)
+                _profiler->Tick(*this);
+        }
     }
-    
+
+    PollInterrupts();
+
+    // Increase Clock
+    _systemClockCounter++;
+}
+
+template void Bus::Tick<FastAccuracy>();
+template void Bus::Tick<BalancedAccuracy>();
+template void Bus::Tick<ExactAccuracy>();
+
+void Bus::PollInterrupts()
+{
     // Check for NMI from PPU
     if (_ppu->NMIOccurred())
     {
@@ -159,13 +297,16 @@ void Bus::Clock()
         _cartridge->ClearIRQ();
         _cpu->IRQ();
     }
-
-    // Increase Clock
-    _systemClockCounter++;
 }
 
 void Bus::SetControllerState(int index, uint8_t state)
 {
     if (index == 0 || index == 1)
         _controllers[index].SetButtons(state);
+}
+
+void Bus::SetInputProvider(int index, Controller::InputProvider provider)
+{
+    if (index == 0 || index == 1)
+        _controllers[index].SetInputProvider(std::move(provider));
 }
\ No newline at end of file
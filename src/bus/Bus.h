@@ -9,6 +9,9 @@
 #include "controller/Controller.h"
 #include "memory/Memory.h"
 #include "ppu/PPU.h"
+#include "utils/Debugger.h"
+#include "utils/Profiler.h"
+#include "utils/TraceFormat.h"
 
 
 class Bus
@@ -28,18 +31,54 @@ public:
     uint8_t CPURead(uint16_t address);
     void CPUWrite(uint16_t address, uint8_t value);
 
+    // The same under an accuracy policy; tool hooks and access logging
+    // are compiled out of the instances without TOOL_HOOKS
+    template <class Policy> uint8_t CPURead(uint16_t address);
+    template <class Policy> void CPUWrite(uint16_t address, uint8_t value);
+
+    // Side-effect free read for tools (registers read as 0)
+    uint8_t CPUPeek(uint16_t address);
+
     // System operations
     void Reset();
-    void Clock();
+    void Clock(); // One PPU dot, whatever the CPU's accuracy
+
+    // Advance the system under an accuracy policy. Dot-stepped policies
+    // run one PPU dot like Clock(); FAST runs a whole CPU instruction and
+    // its PPU dots once the two are lined up, with no tool hooks.
+    template <class Policy> void Tick();
+
+    // Value unmapped reads return (EXACT CPUs keep it up to date)
+    void SetOpenBus(uint8_t value) { _openBus = value; }
+    uint8_t GetOpenBus() const { return _openBus; }
 
     // Get component references
+    CPU* GetCPU() { return _cpu; }
     PPU* GetPPU() { return _ppu; }
     Cartridge* GetCartridge() { return _cartridge; }
 
+    // Take over another bus's clock and controller state (Machine::Fork).
+    // Connections, tools and input providers stay this bus's own.
+    void CopyStateFrom(const Bus& other);
+
     // Controller input
     void SetControllerState(int index, uint8_t state);
+    void SetInputProvider(int index, Controller::InputProvider provider);
+
+    // Guest code sampling profiler (nullptr to detach)
+    void AttachProfiler(Profiler* profiler) { _profiler = profiler; }
+
+    // Binary instruction trace (nullptr to detach)
+    void AttachTracer(TraceWriter* tracer) { _tracer = tracer; }
+
+    // Breakpoints/watchpoints (nullptr to detach); also hooks the PPU
+    void AttachDebugger(Debugger* debugger);
+    Debugger* GetDebugger() { return _debugger; }
 
 private:
+    // Hand PPU NMI and cartridge IRQ lines to the CPU
+    void PollInterrupts();
+
     CPU*        _cpu;
     PPU*        _ppu;
     Memory*     _memory;
@@ -48,8 +87,20 @@ private:
     // System clock counter
     uint64_t _systemClockCounter;
 
+    // Last value on the CPU data bus
+    uint8_t _openBus;
+
     // Controller Input
     Controller _controllers[2];
+
+    // Optional sampling profiler
+    Profiler* _profiler;
+
+    // Optional instruction tracer
+    TraceWriter* _tracer;
+
+    // Optional debugger
+    Debugger* _debugger;
 };
 
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -5,22 +6,30 @@
 
 #include "Cartridge.h"
 #include "Mapper.h"
+#include "MapperAxROM.h"
 #include "MapperCNROM.h"
+#include "MapperGxROM.h"
 #include "MapperNROM.h"
-#include "MapperMMC1.h"
 #include "MapperMMC3.h"
+#include "MapperSxROM.h"
 #include "MapperUxROM.h"
 #include "MirrorMode.h"
 #include "utils/Logger.h"
 
 
 Cartridge::Cartridge()
-    : _prgRomBanks(0),
+    : _prgROM(std::make_shared<const std::vector<uint8_t>>()),
+      _chrROM(std::make_shared<const std::vector<uint8_t>>()),
+      _prgRomBanks(0),
       _chrRomBanks(0),
       _mapperNumber(0),
       _mirrorMode(MirrorMode::MIRROR_MODE_HORIZONTAL),
       _hasBattery(false),
       _hasTrainer(false),
+      _prgPages(),
+      _chrPages(),
+      _chrGeneration(0),
+      _prgRAMDirty(0),
       _loaded(false)
 {
 }
@@ -29,6 +38,45 @@ Cartridge::~Cartridge()
 {
 }
 
+Cartridge::Cartridge(const Cartridge& other)
+    : Cartridge()
+{
+    *this = other;
+}
+
+Cartridge& Cartridge::operator=(const Cartridge& other)
+{
+    if (this == &other)
+        return *this;
+
+    _prgROM = other._prgROM;
+    _chrROM = other._chrROM;
+    _prgRAM = other._prgRAM;
+    _chrRAM = other._chrRAM;
+    _prgRomBanks = other._prgRomBanks;
+    _chrRomBanks = other._chrRomBanks;
+    _mapperNumber = other._mapperNumber;
+    _mirrorMode = other._mirrorMode;
+    _hasBattery = other._hasBattery;
+    _hasTrainer = other._hasTrainer;
+    _mapper = other._mapper ? other._mapper->Clone() : nullptr;
+    _prgRAMDirty = other._prgRAMDirty;
+    _loaded = other._loaded;
+    _filename = other._filename;
+
+    // Page pointers must come from this copy's own mapper state
+    if (_mapper)
+        RefreshPages();
+    else
+    {
+        std::fill(std::begin(_prgPages), std::end(_prgPages), nullptr);
+        std::fill(std::begin(_chrPages), std::end(_chrPages), nullptr);
+    }
+    _chrGeneration = other._chrGeneration;
+
+    return *this;
+}
+
 MirrorMode Cartridge::GetMirrorMode() const
 {
     if (_mapper)
@@ -54,6 +102,13 @@ bool Cartridge::LoadFromFile(const std::string &filename)
                                  std::istreambuf_iterator<char>());
     f.close();
 
+    return LoadFromMemory(romData);
+}
+
+bool Cartridge::LoadFromMemory(const std::vector<uint8_t> &romData)
+{
+    _loaded = false;
+
     if (romData.size() < sizeof(INESHeader))
     {
         LOG_ERROR("ROM file is too small!");
@@ -81,8 +136,7 @@ bool Cartridge::LoadFromFile(const std::string &filename)
         return false;
     }
 
-    _prgROM.resize(prgSize);
-    std::memcpy(_prgROM.data(), romData.data() + offset, prgSize);
+    _prgROM = std::make_shared<const std::vector<uint8_t>>(romData.begin() + offset, romData.begin() + offset + prgSize);
     offset += prgSize;
 
     // Read CHR-ROM (or allocate CHR-RAM)
@@ -94,19 +148,18 @@ bool Cartridge::LoadFromFile(const std::string &filename)
             LOG_ERROR("Invalid CHR-ROM size");
             return false;
         }
-        _chrROM.resize(chrSize);
-        std::memcpy(_chrROM.data(), romData.data() + offset, chrSize);
+        _chrROM = std::make_shared<const std::vector<uint8_t>>(romData.begin() + offset, romData.begin() + offset + chrSize);
     }
     else
     {
-        // No CHR-ROM, so we have CHR-RAM
-        _chrROM.resize(8192); // 8KB CHR-RAM
-        std::fill(_chrROM.begin(), _chrROM.end(), 0);
+        // No CHR-ROM, so we have 8KB of CHR-RAM
+        _chrROM = std::make_shared<const std::vector<uint8_t>>();
     }
+    _chrRAM.Clear();
 
-    // Allocate PRG-RAM (8KB)
-    _prgRAM.resize(8 * 1024);
-    std::fill(_prgRAM.begin(), _prgRAM.end(), 0);
+    // PRG-RAM (8KB)
+    _prgRAM.Clear();
+    _prgRAMDirty = 0;
 
     // Create Mapper
     switch (_mapperNumber)
@@ -115,7 +168,7 @@ bool Cartridge::LoadFromFile(const std::string &filename)
             _mapper = std::make_unique<MapperNROM>(_prgRomBanks, _chrRomBanks, _mirrorMode);
             break;
         case 1:
-            _mapper = std::make_unique<MapperMMC1>(_prgRomBanks, _chrRomBanks);
+            _mapper = std::make_unique<MapperSxROM>(_prgRomBanks, _chrRomBanks);
             break;
         case 2:
             _mapper = std::make_unique<MapperUxROM>(_prgRomBanks, _chrRomBanks, _mirrorMode);
@@ -126,11 +179,21 @@ bool Cartridge::LoadFromFile(const std::string &filename)
         case 4:
             _mapper = std::make_unique<MapperMMC3>(_prgRomBanks, _chrRomBanks, _mirrorMode);
             break;
+        case 7:
+            _mapper = std::make_unique<MapperAxROM>(_prgRomBanks, _chrRomBanks);
+            break;
+        case 66:
+            _mapper = std::make_unique<MapperGxROM>(_prgRomBanks, _chrRomBanks, _mirrorMode);
+            break;
         default:
             LOG_ERROR("Unsupported mapper: %d", (int)_mapperNumber);
             return false;
     }
 
+    _mapper->Reset();
+    RefreshPages();
+    ++_chrGeneration; // New CHR contents even if the pages look the same
+
     _loaded = true;
     LOG_INFO("ROM loaded successfully: %s", _filename.c_str());
     LOG_INFO("%s", GetRomInfo().c_str());
@@ -191,7 +254,7 @@ bool Cartridge::ParseHeader(const std::vector<uint8_t> &romData)
     return true;
 }
 
-uint8_t Cartridge::CPURead(uint16_t address)
+uint8_t Cartridge::CPUReadMapped(uint16_t address)
 {
     LOG_DEBUG("address=0x%04x", address);
 
@@ -199,13 +262,13 @@ uint8_t Cartridge::CPURead(uint16_t address)
 
     // Check PRG-RAM range ($6000-$7FFF)
     if (0x6000 <= address && address < 0x8000)
-        return _prgRAM[address - 0x6000];
+        return _prgRAM.Read(address - 0x6000);
 
     // Check PRG-ROM range via mapper
     if (_mapper->CPUMapRead(address, mappedAddress))
     {
-        if (mappedAddress < _prgROM.size())
-            return _prgROM[mappedAddress];
+        if (mappedAddress < _prgROM->size())
+            return (*_prgROM)[mappedAddress];
     }
 
     return 0x00;
@@ -220,27 +283,106 @@ void Cartridge::CPUWrite(uint16_t address, uint8_t data)
     // Check PRG-RAM range ($6000-$7FFF)
     if (0x6000 <= address && address < 0x8000)
     {
-        _prgRAM[address - 0x6000] = data;
+        uint16_t offset = address - 0x6000;
+        if (_prgRAM.Read(offset) != data)
+        {
+            _prgRAM.Write(offset, data);
+            _prgRAMDirty |= 1u << (offset / PRG_RAM_PAGE_SIZE);
+        }
         return;
     }
 
-    // Some mappers use writes to PRG-ROM area for bank switching
-    if (_mapper->CPUMapWrite(address, mappedAddress, data))
+    // Writes to the PRG-ROM area only reach mapper registers; the ROM
+    // itself is shared between copies and never written
+    _mapper->CPUMapWrite(address, mappedAddress, data);
+
+    // Register writes may have switched banks
+    if (address >= 0x8000)
+        RefreshPages();
+}
+
+void Cartridge::RefreshPages()
+{
+    // A page gets a direct pointer only if the mapper maps it linearly onto
+    // memory we own; anything else keeps going through the mapper
+    for (uint32_t i = 0; i < 4; ++i)
     {
-        // Most mappers dont actually write to ROM, but we support it for CHR-RAM
-        if (mappedAddress < _prgROM.size())
-            _prgROM[mappedAddress] = data;
+        uint16_t first = (uint16_t) (0x8000 + i * PRG_PAGE_SIZE);
+        uint16_t last = (uint16_t) (first + PRG_PAGE_SIZE - 1);
+        uint32_t start = 0, end = 0;
+
+        _prgPages[i] = nullptr;
+        if (_mapper->CPUMapRead(first, start) && _mapper->CPUMapRead(last, end)
+            && end == start + PRG_PAGE_SIZE - 1 && end < _prgROM->size())
+            _prgPages[i] = &(*_prgROM)[start];
     }
+
+    // Pages served by the mapper may have been switched without any pointer
+    // changing, so they count as a change too
+    bool chrChanged = false;
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const uint8_t* previous = _chrPages[i];
+        uint16_t first = (uint16_t) (i * CHR_PAGE_SIZE);
+        uint16_t last = (uint16_t) (first + CHR_PAGE_SIZE - 1);
+        uint32_t start = 0, end = 0;
+
+        _chrPages[i] = nullptr;
+        if (_mapper->PPUMapRead(first, start) && _mapper->PPUMapRead(last, end)
+            && end == start + CHR_PAGE_SIZE - 1 && end < GetCHRSize())
+        {
+            if (_chrRomBanks)
+                _chrPages[i] = &(*_chrROM)[start];
+            else if (start % CHR_PAGE_SIZE == 0)
+                _chrPages[i] = _chrRAM.GetPage(start / CHR_PAGE_SIZE);
+        }
+
+        chrChanged |= !_chrPages[i] || _chrPages[i] != previous;
+    }
+
+    if (chrChanged)
+        ++_chrGeneration;
+}
+
+int Cartridge::GetPRGBank(uint16_t address)
+{
+    uint32_t mappedAddress = 0;
+
+    if (MapPRGAddress(address, mappedAddress))
+        return (int) (mappedAddress / 0x2000);
+
+    return -1;
+}
+
+bool Cartridge::MapPRGAddress(uint16_t address, uint32_t &offset)
+{
+    // Mapper read translation has no side effects, so this is safe to call
+    // from tools (profiler, debugger, disassembler) at any time
+    if (address < 0x8000 || !_mapper || !_mapper->CPUMapRead(address, offset))
+        return false;
+
+    return offset < _prgROM->size();
+}
+
+uint32_t Cartridge::GetPRGWindowSize() const
+{
+    return _mapper ? _mapper->GetPRGWindowSize() : 0x8000;
+}
+
+bool Cartridge::IsPRGWindowFixed(uint16_t address) const
+{
+    return _mapper ? _mapper->IsPRGWindowFixed(address) : true;
 }
 
-uint8_t Cartridge::PPURead(uint16_t address)
+uint8_t Cartridge::PPUReadMapped(uint16_t address)
 {
     LOG_DEBUG("address=0x%04x", address);
 
     uint32_t mappedAddress = 0;
 
-    if (_mapper->PPUMapRead(address, mappedAddress) && (mappedAddress < _chrROM.size()))
-        return _chrROM[mappedAddress];
+    if (_mapper->PPUMapRead(address, mappedAddress) && (mappedAddress < GetCHRSize()))
+        return _chrRomBanks ? (*_chrROM)[mappedAddress] : _chrRAM.Read(mappedAddress);
 
     return 0x00;
 }
@@ -251,14 +393,29 @@ void Cartridge::PPUWrite(uint16_t address, uint8_t data)
 
     uint32_t mappedAddress = 0;
 
-    if (_mapper->PPUMapWrite(address, mappedAddress) && (mappedAddress < _chrROM.size()))
-        _chrROM[mappedAddress] = data;
+    // CHR-ROM is shared between copies, so only CHR-RAM takes writes
+    if (_chrRomBanks == 0 && _mapper->PPUMapWrite(address, mappedAddress) && (mappedAddress < CHR_RAM_SIZE))
+    {
+        bool moved = _chrRAM.IsShared(mappedAddress / CHR_PAGE_SIZE);
+        _chrRAM.Write(mappedAddress, data);
+        ++_chrGeneration;
+
+        // The first write after a copy gets this cartridge its own page
+        if (moved)
+            RefreshPages();
+    }
 }
 
 void Cartridge::Reset()
 {
     LOG_INFO("Cartridge Reset");
     _mapper->Reset();
+    RefreshPages();
+}
+
+std::unique_ptr<Cartridge> Cartridge::Clone() const
+{
+    return _loaded ? std::make_unique<Cartridge>(*this) : nullptr;
 }
 
 std::string Cartridge::GetRomInfo() const
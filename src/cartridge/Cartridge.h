@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "MirrorMode.h"
+#include "memory/CowBuffer.h"
 
 
 // Forward declarations
@@ -19,17 +20,53 @@ public:
     Cartridge();
     ~Cartridge();
 
+    // Copies fork the cartridge: ROM is shared, PRG/CHR-RAM are shared
+    // until written (see CowBuffer) and the mapper is cloned
+    Cartridge(const Cartridge& other);
+    Cartridge& operator=(const Cartridge& other);
+
     // Load ROM from file
     bool LoadFromFile(const std::string &filename);
 
+    // Load ROM from an in-memory iNES image
+    bool LoadFromMemory(const std::vector<uint8_t> &romData);
+
     // CPU memory access (PRG-ROM/RAM)
-    uint8_t CPURead(uint16_t address);
+    // PRG-ROM reads go straight through the page table; only unmapped pages
+    // and PRG-RAM take the mapper path
+    uint8_t CPURead(uint16_t address)
+    {
+        if (address >= 0x8000)
+        {
+            const uint8_t* page = _prgPages[(address >> 13) & 0x03];
+            if (page)
+                return page[address & (PRG_PAGE_SIZE - 1)];
+        }
+        return CPUReadMapped(address);
+    }
+
     void CPUWrite(uint16_t address, uint8_t data);
 
-    // PPU memory access (CHR-ROM/RAM)
-    uint8_t PPURead(uint16_t address);
+    // PPU memory access (CHR-ROM/RAM), same scheme in 1KB pages
+    uint8_t PPURead(uint16_t address)
+    {
+        if (address < 0x2000)
+        {
+            const uint8_t* page = _chrPages[address >> 10];
+            if (page)
+                return page[address & (CHR_PAGE_SIZE - 1)];
+        }
+        return PPUReadMapped(address);
+    }
+
+    // Writes always take the mapper path: a CHR-RAM page may have to be
+    // copied first, which moves it
     void PPUWrite(uint16_t address, uint8_t data);
 
+    // Bumped whenever CHR contents or CHR banking may have changed, so the
+    // PPU can keep pattern data fetched under an unchanged generation
+    uint32_t GetCHRGeneration() const { return _chrGeneration; }
+
     // Get mirroring mode
     MirrorMode GetMirrorMode() const;
 
@@ -40,22 +77,66 @@ public:
     std::string GetRomInfo() const;
     uint8_t GetMapperNumber() const { return _mapperNumber; }
 
+    // 8KB PRG-ROM bank currently mapped at address, or -1 outside PRG-ROM
+    int GetPRGBank(uint16_t address);
+
+    // PRG-ROM offset currently mapped at address (no side effects)
+    bool MapPRGAddress(uint16_t address, uint32_t &offset);
+
+    // PRG window layout of the mapper (see Mapper::GetPRGWindowSize)
+    uint32_t GetPRGWindowSize() const;
+    bool IsPRGWindowFixed(uint16_t address) const;
+
+    const std::vector<uint8_t> &GetPRGROM() const { return *_prgROM; }
+
+    // Battery-backed PRG-RAM ($6000-$7FFF). Writes mark 256-byte pages
+    // dirty; SaveRAM collects them (emulation thread only).
+    static constexpr uint32_t PRG_RAM_SIZE = 0x2000;
+    static constexpr uint32_t PRG_RAM_PAGE_SIZE = 0x0100;
+    bool HasBattery() const { return _hasBattery; }
+    void ReadPRGRAM(uint32_t offset, uint8_t* out, uint32_t size) const { _prgRAM.CopyTo(offset, out, size); }
+    void WritePRGRAM(uint32_t offset, const uint8_t* in, uint32_t size) { _prgRAM.CopyFrom(offset, in, size); }
+    uint32_t TakeDirtyPRGRAMPages() { uint32_t pages = _prgRAMDirty; _prgRAMDirty = 0; return pages; }
+    void MarkPRGRAMPagesDirty(uint32_t pages) { _prgRAMDirty |= pages; }
+
     // Reset Cartridge state
     void Reset();
 
+    // Copy for a second consumer such as the pipelined PPU renderer;
+    // nullptr if nothing is loaded
+    std::unique_ptr<Cartridge> Clone() const;
+
     // Mapper IRQ interface
     bool IRQState();
     void ClearIRQ();
     void OnScanline(); // Called once per scanline
 
 private:
+    static constexpr uint32_t PRG_PAGE_SIZE = 0x2000; // 4 pages at $8000-$FFFF
+    static constexpr uint32_t CHR_PAGE_SIZE = 0x0400; // 8 pages at $0000-$1FFF
+    static constexpr uint32_t CHR_RAM_SIZE = 0x2000;
+
     // Parse iNES header
     bool ParseHeader(const std::vector<uint8_t> &romData);
 
-    // ROM data
-    std::vector<uint8_t> _prgROM; // PRG-ROM (program ROM)
-    std::vector<uint8_t> _chrROM; // CHR-ROM (character/pattern ROM)
-    std::vector<uint8_t> _prgRAM; // PRG-RAM (save RAM)
+    // Mapper path for anything the page tables don't cover
+    uint8_t CPUReadMapped(uint16_t address);
+    uint8_t PPUReadMapped(uint16_t address);
+
+    // Rebuild the page tables from the mapper's current banking; called on
+    // load, reset and after every mapper register write
+    void RefreshPages();
+
+    // Size of CHR-ROM, or of CHR-RAM when there is none
+    uint32_t GetCHRSize() const { return _chrRomBanks ? (uint32_t) _chrROM->size() : CHR_RAM_SIZE; }
+
+    // ROM data, never written and shared by every copy
+    std::shared_ptr<const std::vector<uint8_t>> _prgROM; // PRG-ROM (program ROM)
+    std::shared_ptr<const std::vector<uint8_t>> _chrROM; // CHR-ROM (character/pattern ROM)
+
+    // RAM, copy-on-write between copies
+    CowBuffer<PRG_RAM_SIZE, PRG_RAM_PAGE_SIZE> _prgRAM; // PRG-RAM (save RAM)
+    CowBuffer<CHR_RAM_SIZE, CHR_PAGE_SIZE> _chrRAM;     // CHR-RAM (carts without CHR-ROM)
 
     // ROM info
     uint8_t _prgRomBanks;   // Number of 16KB PRG-ROM banks
@@ -68,6 +149,13 @@ private:
     // Mapper
     std::unique_ptr<Mapper> _mapper;
 
+    // Direct pointers into PRG/CHR for each page (nullptr = use the mapper)
+    const uint8_t* _prgPages[4];
+    const uint8_t* _chrPages[8];
+
+    uint32_t _chrGeneration;
+    uint32_t _prgRAMDirty; // One bit per PRG_RAM_PAGE_SIZE page
+
     // Status
     bool _loaded;
     std::string _filename;
@@ -2,6 +2,7 @@
 #define MAPPER_H
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "MirrorMode.h"
@@ -24,6 +25,9 @@ public:
     // Reset mapper state
     virtual void Reset() = 0;
 
+    // Independent copy with the same banking and IRQ state
+    virtual std::unique_ptr<Mapper> Clone() const = 0;
+
     // IRQ Support (for mappers that have it)
     virtual bool IRQState() { return false; }
     virtual void IRQClear() {}
@@ -31,6 +35,12 @@ public:
 
     virtual MirrorMode GetMirrorMode() const { return _mirrorMode; }
 
+    // PRG layout for static analysis: size of each independently switched
+    // CPU window, and whether the window containing address can never be
+    // switched away from its current bank
+    virtual uint32_t GetPRGWindowSize() const { return 0x8000; }
+    virtual bool IsPRGWindowFixed(uint16_t address) const { (void) address; return true; }
+
 protected:
     uint8_t _prgBanks; // Number of PRG-ROM banks
     uint8_t _chrBanks; // Number of CHR-ROM banks
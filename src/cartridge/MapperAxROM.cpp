@@ -0,0 +1,75 @@
+#include "MapperAxROM.h"
+#include "utils/Logger.h"
+
+
+MapperAxROM::MapperAxROM(uint8_t prgBanks, uint8_t chrBanks)
+    : Mapper(prgBanks, chrBanks, MirrorMode::MIRROR_MODE_ONE_SCREEN_LOWER),
+      _prgBankSelect(0)
+{
+    LOG_INFO("MapperAxROM created: prgBanks=%d", (int)prgBanks);
+}
+
+bool MapperAxROM::CPUMapRead(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%04x", address, mappedAddress);
+
+    if (address >= 0x8000)
+    {
+        // Header banks are 16KB; wrap the 32KB bank number to the ROM size
+        uint32_t banks32K = _prgBanks > 1 ? _prgBanks / 2 : 1;
+        mappedAddress = (_prgBankSelect % banks32K) * 0x8000 + (address & 0x7FFF);
+        return true;
+    }
+
+    return false;
+}
+
+bool MapperAxROM::CPUMapWrite(uint16_t address, uint32_t &mappedAddress, uint8_t data)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%04x  data=0x%02x", address, mappedAddress, data);
+
+    // $8000-$FFFF: xxxM xPPP (M = nametable page, P = 32KB PRG bank)
+    if (address >= 0x8000)
+    {
+        _prgBankSelect = data & 0x07;
+        _mirrorMode = (data & 0x10) ? MirrorMode::MIRROR_MODE_ONE_SCREEN_UPPER
+                                    : MirrorMode::MIRROR_MODE_ONE_SCREEN_LOWER;
+    }
+
+    (void) mappedAddress; // Suppress unused variable warning
+
+    return false;
+}
+
+bool MapperAxROM::PPUMapRead(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%02x", address, mappedAddress);
+
+    if (address < 0x2000)
+    {
+        mappedAddress = address;
+        return true;
+    }
+
+    return false;
+}
+
+bool MapperAxROM::PPUMapWrite(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%02x", address, mappedAddress);
+
+    // Boards ship with CHR-RAM; a CHR-ROM dump stays read-only
+    if (address < 0x2000 && _chrBanks == 0)
+    {
+        mappedAddress = address;
+        return true;
+    }
+
+    return false;
+}
+
+void MapperAxROM::Reset()
+{
+    _prgBankSelect = 0;
+    _mirrorMode = MirrorMode::MIRROR_MODE_ONE_SCREEN_LOWER;
+}
@@ -0,0 +1,32 @@
+#ifndef MAPPER_AXROM_H
+#define MAPPER_AXROM_H
+
+#include "Mapper.h"
+
+
+// AxROM (mapper 7): 32KB PRG switching, single-screen mirroring select,
+// 8KB CHR-RAM
+class MapperAxROM final : public Mapper
+{
+public:
+    MapperAxROM(uint8_t prgBanks, uint8_t chrBanks);
+    virtual ~MapperAxROM() override = default;
+
+    virtual bool CPUMapRead(uint16_t address, uint32_t &mappedAddress) override;
+    virtual bool CPUMapWrite(uint16_t address, uint32_t &mappedAddress, uint8_t data) override;
+
+    virtual bool PPUMapRead(uint16_t address, uint32_t &mappedAddress) override;
+    virtual bool PPUMapWrite(uint16_t address, uint32_t &mappedAddress) override;
+
+    virtual void Reset() override;
+
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperAxROM>(*this); }
+
+    // The whole $8000-$FFFF range switches at once
+    virtual bool IsPRGWindowFixed(uint16_t address) const override { (void) address; return false; }
+
+private:
+    uint8_t _prgBankSelect; // 32KB PRG bank (0-7)
+};
+
+#endif // MAPPER_AXROM_H
@@ -19,7 +19,6 @@ bool MapperCNROM::CPUMapRead(uint16_t address, uint32_t &mappedAddress)
     if (address >= 0x8000)
     {
         mappedAddress = address & (_prgBanks > 1 ? 0x7FFF : 0x3FFF);
-        LOG_INFO("CNROM: prg_bank -> %d. chr_bank -> %d", _prgBanks, _chrBanks);
         return true;
     }
 
@@ -4,7 +4,7 @@
 #include "Mapper.h"
 
 
-class MapperCNROM : public Mapper
+class MapperCNROM final : public Mapper
 {
 public:
     MapperCNROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror);
@@ -17,6 +17,8 @@ public:
     virtual bool PPUMapWrite(uint16_t address, uint32_t &mappedAddress) override;
 
     virtual void Reset() override;
+
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperCNROM>(*this); }
 };
 
 #endif // MAPPER_CNROM_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "MapperGxROM.h"
+#include "utils/Logger.h"
+
+
+MapperGxROM::MapperGxROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror)
+    : Mapper(prgBanks, chrBanks, mirror),
+      _prgBankSelect(0),
+      _chrBankSelect(0)
+{
+    LOG_INFO("MapperGxROM created: prgBanks=%d  chrBanks=%d", (int)prgBanks, (int)chrBanks);
+}
+
+bool MapperGxROM::CPUMapRead(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%04x", address, mappedAddress);
+
+    if (address >= 0x8000)
+    {
+        uint32_t banks32K = _prgBanks > 1 ? _prgBanks / 2 : 1;
+        mappedAddress = (_prgBankSelect % banks32K) * 0x8000 + (address & 0x7FFF);
+        return true;
+    }
+
+    return false;
+}
+
+bool MapperGxROM::CPUMapWrite(uint16_t address, uint32_t &mappedAddress, uint8_t data)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%04x  data=0x%02x", address, mappedAddress, data);
+
+    // $8000-$FFFF: xxPP xxCC
+    if (address >= 0x8000)
+    {
+        _prgBankSelect = (data >> 4) & 0x03;
+        _chrBankSelect = data & 0x03;
+    }
+
+    (void) mappedAddress; // Suppress unused variable warning
+
+    return false;
+}
+
+bool MapperGxROM::PPUMapRead(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%02x", address, mappedAddress);
+
+    if (address < 0x2000)
+    {
+        uint32_t banks = _chrBanks ? _chrBanks : 1;
+        mappedAddress = (_chrBankSelect % banks) * 0x2000 + address;
+        return true;
+    }
+
+    return false;
+}
+
+bool MapperGxROM::PPUMapWrite(uint16_t address, uint32_t &mappedAddress)
+{
+    LOG_DEBUG("address=0x%04x  mappedAddress=0x%02x", address, mappedAddress);
+    (void) mappedAddress; // Suppress unused variable warning
+    return false; // CHR-ROM is not writable
+}
+
+void MapperGxROM::Reset()
+{
+    _prgBankSelect = 0;
+    _chrBankSelect = 0;
+}
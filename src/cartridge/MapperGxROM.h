@@ -0,0 +1,31 @@
+#ifndef MAPPER_GXROM_H
+#define MAPPER_GXROM_H
+
+#include "Mapper.h"
+
+
+// GxROM (mapper 66): 32KB PRG and 8KB CHR switching through one register
+class MapperGxROM final : public Mapper
+{
+public:
+    MapperGxROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror);
+    virtual ~MapperGxROM() override = default;
+
+    virtual bool CPUMapRead(uint16_t address, uint32_t &mappedAddress) override;
+    virtual bool CPUMapWrite(uint16_t address, uint32_t &mappedAddress, uint8_t data) override;
+
+    virtual bool PPUMapRead(uint16_t address, uint32_t &mappedAddress) override;
+    virtual bool PPUMapWrite(uint16_t address, uint32_t &mappedAddress) override;
+
+    virtual void Reset() override;
+
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperGxROM>(*this); }
+
+    virtual bool IsPRGWindowFixed(uint16_t address) const override { (void) address; return false; }
+
+private:
+    uint8_t _prgBankSelect; // 32KB PRG bank (0-3)
+    uint8_t _chrBankSelect; // 8KB CHR bank (0-3)
+};
+
+#endif // MAPPER_GXROM_H
@@ -31,6 +31,22 @@ void MapperMMC1::Reset()
     _mirrorMode     = MirrorMode::MIRROR_MODE_HORIZONTAL;
 }
 
+uint32_t MapperMMC1::GetPRGWindowSize() const
+{
+    // Modes 0/1 switch all 32KB at once, modes 2/3 switch 16KB halves
+    return (_prgMode <= 1) ? 0x8000 : 0x4000;
+}
+
+bool MapperMMC1::IsPRGWindowFixed(uint16_t address) const
+{
+    if (_prgMode == 2)
+        return address < 0xC000;  // First bank fixed at $8000
+    if (_prgMode == 3)
+        return address >= 0xC000; // Last bank fixed at $C000
+
+    return false;
+}
+
 void MapperMMC1::ApplyRegister(uint16_t address, uint8_t data)
 {
     // bits 13-14 of address select which internal register
@@ -6,7 +6,7 @@
 #include "MirrorMode.h"
 
 
-class MapperMMC1 : public Mapper
+class MapperMMC1 final : public Mapper
 {
 public:
     MapperMMC1(uint8_t prgBanks, uint8_t chrBanks);
@@ -18,6 +18,11 @@ public:
     virtual bool PPUMapWrite(uint16_t address, uint32_t &mappedAddress) override;
     virtual void Reset() override;
 
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperMMC1>(*this); }
+
+    virtual uint32_t GetPRGWindowSize() const override;
+    virtual bool IsPRGWindowFixed(uint16_t address) const override;
+
     // MMC1 controls mirroring dynamically
     MirrorMode GetMirrorMode() const { return _mirrorMode; }
 
@@ -6,7 +6,7 @@
 #include "Mapper.h"
 
 
-class MapperMMC3 : public Mapper
+class MapperMMC3 final : public Mapper
 {
 public:
     MapperMMC3(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror);
@@ -20,6 +20,12 @@ public:
 
     virtual void Reset() override;
 
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperMMC3>(*this); }
+
+    // $8000/$C000 swap roles with the PRG mode, so only $E000 is truly fixed
+    virtual uint32_t GetPRGWindowSize() const override { return 0x2000; }
+    virtual bool IsPRGWindowFixed(uint16_t address) const override { return address >= 0xE000; }
+
     // Scanline counter and IRQ support
     virtual bool IRQState() override { return _irqActive; }
     virtual void IRQClear() override { _irqActive = false; }
@@ -4,7 +4,7 @@
 #include "Mapper.h"
 
 
-class MapperNROM : public Mapper
+class MapperNROM final : public Mapper
 {
 public:
     MapperNROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror);
@@ -17,6 +17,8 @@ public:
     virtual bool PPUMapWrite(uint16_t address, uint32_t &mappedAddress) override;
 
     virtual void Reset() override;
+
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperNROM>(*this); }
 };
 
 #endif // MAPPER_NROM_H
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef MAPPER_SXROM_H
+#define MAPPER_SXROM_H
+
+#include "MapperMMC1.h"
+
+
+// SxROM is the board family (SNROM, SLROM, SGROM, ...) built around the
+// MMC1; mapper 1 is the same chip on every one of them
+using MapperSxROM = MapperMMC1;
+
+#endif // MAPPER_SXROM_H
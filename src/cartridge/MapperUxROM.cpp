@@ -3,7 +3,8 @@
 
 
 MapperUxROM::MapperUxROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror)
-    : Mapper(prgBanks, chrBanks, mirror)
+    : Mapper(prgBanks, chrBanks, mirror),
+      _prgBankSelect(0)
 {
     LOG_INFO("MapperUxROM created: prgBanks=%d", (int)prgBanks);
 }
@@ -4,7 +4,7 @@
 #include "Mapper.h"
 
 
-class MapperUxROM : public Mapper
+class MapperUxROM final : public Mapper
 {
 public:
     MapperUxROM(uint8_t prgBanks, uint8_t chrBanks, MirrorMode mirror);
@@ -18,6 +18,11 @@ public:
 
     virtual void Reset() override;
 
+    virtual std::unique_ptr<Mapper> Clone() const override { return std::make_unique<MapperUxROM>(*this); }
+
+    virtual uint32_t GetPRGWindowSize() const override { return 0x4000; }
+    virtual bool IsPRGWindowFixed(uint16_t address) const override { return address >= 0xC000; }
+
 private:
     uint8_t _prgBankSelect; // Currently selected PRG bank (0-15)
 };
@@ -0,0 +1,62 @@
+#include "RomHeader.h"
+
+
+// NES 2.0 RAM sizes are stored as a shift count: 64 << n bytes (0 = none)
+static uint32_t ShiftSize(uint8_t shift)
+{
+    return shift ? (64u << shift) : 0;
+}
+
+// NES 2.0 ROM size: LSB from the iNES field, MSB nibble from byte 9;
+// an MSB nibble of $F selects exponent-multiplier notation
+static uint32_t RomSize(uint8_t lsb, uint8_t msb, uint32_t unit)
+{
+    if (msb == 0x0F)
+    {
+        uint32_t exponent = lsb >> 2;
+        uint32_t multiplier = (lsb & 0x03) * 2 + 1;
+        return exponent < 32 ? (1u << exponent) * multiplier : 0;
+    }
+
+    return ((uint32_t) msb << 8 | lsb) * unit;
+}
+
+bool RomHeader::Parse(const uint8_t* data, size_t size, RomHeader& header)
+{
+    if (size < SIZE || data[0] != 'N' || data[1] != 'E' || data[2] != 'S' || data[3] != 0x1A)
+        return false;
+
+    const uint8_t flags6 = data[6];
+    const uint8_t flags7 = data[7];
+
+    header.format = ((flags7 & 0x0C) == 0x08) ? FORMAT_NES20 : FORMAT_INES;
+    header.hasBattery = (flags6 & 0x02) != 0;
+    header.hasTrainer = (flags6 & 0x04) != 0;
+
+    if (flags6 & 0x08)
+        header.mirrorMode = MIRROR_MODE_FOUR_SCREEN;
+    else
+        header.mirrorMode = (flags6 & 0x01) ? MIRROR_MODE_VERTICAL : MIRROR_MODE_HORIZONTAL;
+
+    header.mapper = (flags7 & 0xF0) | (flags6 >> 4);
+
+    if (header.format == FORMAT_NES20)
+    {
+        header.mapper |= (uint16_t) (data[8] & 0x0F) << 8;
+        header.submapper = data[8] >> 4;
+        header.prgRomSize = RomSize(data[4], data[9] & 0x0F, 0x4000);
+        header.chrRomSize = RomSize(data[5], data[9] >> 4, 0x2000);
+        header.prgRamSize = ShiftSize(data[10] & 0x0F) + ShiftSize(data[10] >> 4);
+        header.chrRamSize = ShiftSize(data[11] & 0x0F) + ShiftSize(data[11] >> 4);
+    }
+    else
+    {
+        header.submapper = 0;
+        header.prgRomSize = data[4] * 0x4000u;
+        header.chrRomSize = data[5] * 0x2000u;
+        header.prgRamSize = 0;
+        header.chrRamSize = 0;
+    }
+
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef ROM_HEADER_H
+#define ROM_HEADER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MirrorMode.h"
+
+
+// iNES / NES 2.0 header, decoded without loading the ROM body.
+// Used by tools that only need to know what a file is (library indexing,
+// batch scheduling); Cartridge does the full load.
+struct RomHeader
+{
+    enum Format : uint8_t
+    {
+        FORMAT_INES,
+        FORMAT_NES20
+    };
+
+    Format format;
+    uint16_t mapper;      // 12 bits on NES 2.0, 8 on iNES
+    uint8_t submapper;    // NES 2.0 only
+    uint32_t prgRomSize;  // Bytes
+    uint32_t chrRomSize;  // Bytes (0 = CHR-RAM)
+    uint32_t prgRamSize;  // Bytes, NES 2.0 only (volatile + battery-backed)
+    uint32_t chrRamSize;  // Bytes, NES 2.0 only
+    MirrorMode mirrorMode;
+    bool hasBattery;
+    bool hasTrainer;
+
+    static constexpr size_t SIZE = 16;
+    static constexpr size_t TRAINER_SIZE = 512;
+
+    // Decode the first 16 bytes of a file; false if it isn't an NES ROM
+    static bool Parse(const uint8_t* data, size_t size, RomHeader& header);
+
+    // Offset of PRG-ROM in the file and the size the header promises
+    size_t GetDataOffset() const { return SIZE + (hasTrainer ? TRAINER_SIZE : 0); }
+    size_t GetExpectedFileSize() const { return GetDataOffset() + prgRomSize + chrRomSize; }
+};
+
+#endif // ROM_HEADER_H
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "SaveRAM.h"
+#include "Cartridge.h"
+#include "utils/Logger.h"
+
+
+// 8KB of PRG-RAM, one dirty bit per page
+static constexpr uint32_t PAGE_COUNT = 32;
+static_assert(PAGE_COUNT * Cartridge::PRG_RAM_PAGE_SIZE == Cartridge::PRG_RAM_SIZE, "One dirty bit per PRG-RAM page");
+
+SaveRAM::SaveRAM()
+    : _cartridge(nullptr),
+    _fd(-1),
+    _stagedPages(0),
+    _stop(false),
+    _flushes(0)
+{}
+
+SaveRAM::~SaveRAM()
+{
+    Close();
+}
+
+bool SaveRAM::Open(const std::string& filename, Cartridge* cartridge)
+{
+    Close();
+
+    // The cartridge keeps PRG-RAM in pages; load through a flat copy
+    std::vector<uint8_t> ram(Cartridge::PRG_RAM_SIZE);
+    cartridge->ReadPRGRAM(0, ram.data(), ram.size());
+
+    _fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0)
+    {
+        LOG_ERROR("Failed to open save file: %s", filename.c_str());
+        return false;
+    }
+
+    off_t size = ::lseek(_fd, 0, SEEK_END);
+    if (size > 0)
+    {
+        // Short files (other emulators, older RAM sizes) load what they have
+        ssize_t got = ::pread(_fd, ram.data(), std::min<size_t>(size, ram.size()), 0);
+        if (got < 0)
+            LOG_ERROR("Failed to read save file: %s", filename.c_str());
+        else
+        {
+            cartridge->WritePRGRAM(0, ram.data(), (uint32_t) got);
+            LOG_INFO("Loaded %zd bytes of save RAM from %s", got, filename.c_str());
+        }
+    }
+    if ((size_t) size < ram.size())
+    {
+        // Make the file full size so later page writes never leave holes
+        if (::pwrite(_fd, ram.data(), ram.size(), 0) != (ssize_t) ram.size())
+            LOG_ERROR("Failed to initialise save file: %s", filename.c_str());
+    }
+
+    // Loaded contents are not writes by the game
+    cartridge->TakeDirtyPRGRAMPages();
+
+    _cartridge = cartridge;
+    _staged.assign(ram.size(), 0);
+    _stagedPages = 0;
+    _stop = false;
+    _flusher = std::thread(&SaveRAM::FlusherLoop, this);
+    return true;
+}
+
+void SaveRAM::Close()
+{
+    if (_fd < 0)
+        return;
+
+    // Blocking is fine here: nothing else is running
+    uint32_t pages = _cartridge->TakeDirtyPRGRAMPages();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        StagePages(pages);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _flusher.join();
+
+    ::close(_fd);
+    _fd = -1;
+    _cartridge = nullptr;
+}
+
+void SaveRAM::Sync()
+{
+    if (_fd < 0)
+        return;
+
+    uint32_t pages = _cartridge->TakeDirtyPRGRAMPages();
+    if (!pages)
+        return;
+
+    // The flusher only holds the lock for an 8KB copy; if it has it right
+    // now, keep the pages dirty and try again next frame
+    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        _cartridge->MarkPRGRAMPagesDirty(pages);
+        return;
+    }
+
+    Clock::time_point now = Clock::now();
+    bool wasIdle = _stagedPages == 0;
+    if (wasIdle)
+        _firstWrite = now;
+    _lastWrite = now;
+    StagePages(pages);
+    lock.unlock();
+
+    // Only the first write of a burst needs to start the flusher's timer
+    if (wasIdle)
+        _wake.notify_one();
+}
+
+void SaveRAM::StagePages(uint32_t pages)
+{
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        if (pages & (1u << page))
+            _cartridge->ReadPRGRAM(page * Cartridge::PRG_RAM_PAGE_SIZE,
+                                   &_staged[page * Cartridge::PRG_RAM_PAGE_SIZE], Cartridge::PRG_RAM_PAGE_SIZE);
+    }
+    _stagedPages |= pages;
+}
+
+void SaveRAM::FlusherLoop()
+{
+    std::vector<uint8_t> pending(_staged.size());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+    {
+        if (!_stagedPages)
+        {
+            if (_stop)
+                break;
+            _wake.wait(lock);
+            continue;
+        }
+
+        // Coalesce a burst of writes: wait for a quiet period, bounded by MAX_DELAY
+        Clock::time_point due = std::min(_lastWrite + QUIET_PERIOD, _firstWrite + MAX_DELAY);
+        if (!_stop && Clock::now() < due)
+        {
+            _wake.wait_until(lock, due);
+            continue;
+        }
+
+        uint32_t pages = _stagedPages;
+        _stagedPages = 0;
+        pending = _staged;
+        lock.unlock();
+
+        WritePages(pages, pending);
+
+        lock.lock();
+    }
+}
+
+bool SaveRAM::WritePages(uint32_t pages, const std::vector<uint8_t>& data)
+{
+    bool ok = true;
+
+    // One pwrite per run of consecutive dirty pages
+    uint32_t page = 0;
+    while (page < PAGE_COUNT)
+    {
+        if (!(pages & (1u << page)))
+        {
+            ++page;
+            continue;
+        }
+
+        uint32_t first = page;
+        while (page < PAGE_COUNT && (pages & (1u << page)))
+            ++page;
+
+        size_t offset = first * Cartridge::PRG_RAM_PAGE_SIZE;
+        size_t length = (page - first) * Cartridge::PRG_RAM_PAGE_SIZE;
+        if (::pwrite(_fd, &data[offset], length, offset) != (ssize_t) length)
+            ok = false;
+    }
+
+    if (::fdatasync(_fd) != 0)
+        ok = false;
+
+    if (!ok)
+        LOG_ERROR("Failed to write save RAM");
+
+    _flushes.fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+std::string SaveRAM::GetSavePath(const std::string& romPath)
+{
+    size_t dot = romPath.find_last_of('.');
+    size_t slash = romPath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return romPath + ".sav";
+
+    return romPath.substr(0, dot) + ".sav";
+}
@@ -0,0 +1,76 @@
+#ifndef SAVE_RAM_H
+#define SAVE_RAM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Cartridge;
+
+
+// Battery save persistence for PRG-RAM.
+// Once per frame the emulation thread hands the pages the game wrote
+// (Cartridge dirty mask, 256 bytes each) to a staging buffer without ever
+// blocking; a flusher thread writes only those pages back to the .sav file
+// once writes have been quiet for a moment, or after MAX_DELAY at the
+// latest, so a crash loses at most MAX_DELAY worth of saves.
+class SaveRAM
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds QUIET_PERIOD{ 500 };
+    static constexpr std::chrono::milliseconds MAX_DELAY{ 2000 };
+
+    SaveRAM();
+    ~SaveRAM();
+
+    SaveRAM(const SaveRAM&) = delete;
+    SaveRAM& operator=(const SaveRAM&) = delete;
+
+    // Load an existing save into the cartridge's PRG-RAM (a new file starts
+    // from the current contents) and start the flusher
+    bool Open(const std::string& filename, Cartridge* cartridge);
+
+    // Hand over the remaining dirty pages, write them and stop the flusher
+    void Close();
+
+    bool IsOpen() const { return _fd >= 0; }
+
+    // Emulation thread, once per frame: stage dirty pages for the flusher
+    void Sync();
+
+    // Number of completed flushes to disk
+    uint64_t GetFlushCount() const { return _flushes.load(std::memory_order_relaxed); }
+
+    // "game.nes" -> "game.sav"
+    static std::string GetSavePath(const std::string& romPath);
+
+private:
+    void StagePages(uint32_t pages); // Caller holds _mutex
+    void FlusherLoop();
+    bool WritePages(uint32_t pages, const std::vector<uint8_t>& data);
+
+    Cartridge* _cartridge;
+    int _fd;
+
+    // Staged page contents, guarded by _mutex
+    std::vector<uint8_t> _staged;
+    uint32_t _stagedPages;
+    Clock::time_point _firstWrite; // Oldest unflushed write
+    Clock::time_point _lastWrite;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stop;
+    std::atomic<uint64_t> _flushes;
+
+    std::thread _flusher;
+};
+
+#endif // SAVE_RAM_H
@@ -14,6 +14,8 @@ void Controller::Write(uint8_t data)
     _strobe = (data & 0x01);
     if (_strobe)
     {
+        if (_provider)
+            _buttons = _provider();
         _shift = _buttons; // while strob is high, register tracks live state
     }
 }
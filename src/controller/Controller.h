@@ -2,6 +2,7 @@
 #define CONTROLLER_H
 
 #include <cstdint>
+#include <functional>
 
 class Controller
 {
@@ -18,9 +19,16 @@ public:
         RIGHT  = 0x01
     };
 
+    // Returns the current button state; called when the game strobes $4016
+    using InputProvider = std::function<uint8_t()>;
+
     // Live button state, refreshed each frame by the input layer
     void SetButtons(uint8_t state);
 
+    // Sample input at the strobe instead of once per frame (nullptr to
+    // go back to SetButtons)
+    void SetInputProvider(InputProvider provider) { _provider = std::move(provider); }
+
     // $4016 write: strobe signal to latch button states
     void Write(uint8_t data);
 
@@ -32,6 +40,7 @@ private:
     uint8_t _buttons = 0x00; // live state from the keyboard
     uint8_t _shift   = 0x00; // shift register
     bool    _strobe = false; // strobe state
+    InputProvider _provider; // optional late input source
 };
 
 #endif // CONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ACCURACY_H
+#define ACCURACY_H
+
+
+// Accuracy/speed trade-off of a core, fixed when a CPU or Machine is built
+enum class Accuracy
+{
+    FAST,     // Bus stepped a whole instruction at a time, no tool hooks
+    BALANCED, // Bus stepped per PPU dot (the default)
+    EXACT     // BALANCED plus dummy reads/writes and open bus
+};
+
+// Compile-time policies behind each tier. Code that differs between tiers
+// is a template on one of these and tests the flags with `if constexpr`,
+// so a tier never pays for checks it does not need.
+struct FastAccuracy
+{
+    static constexpr Accuracy TIER = Accuracy::FAST;
+    static constexpr bool DOT_STEPPED = false;    // Interleave CPU and PPU per dot
+    static constexpr bool TOOL_HOOKS = false;     // Debugger, tracer, profiler, access logs
+    static constexpr bool DUMMY_ACCESSES = false; // Indexed dummy reads, RMW dummy writes
+    static constexpr bool OPEN_BUS = false;       // Unmapped reads return the last bus value
+};
+
+struct BalancedAccuracy
+{
+    static constexpr Accuracy TIER = Accuracy::BALANCED;
+    static constexpr bool DOT_STEPPED = true;
+    static constexpr bool TOOL_HOOKS = true;
+    static constexpr bool DUMMY_ACCESSES = false;
+    static constexpr bool OPEN_BUS = false;
+};
+
+struct ExactAccuracy
+{
+    static constexpr Accuracy TIER = Accuracy::EXACT;
+    static constexpr bool DOT_STEPPED = true;
+    static constexpr bool TOOL_HOOKS = true;
+    static constexpr bool DUMMY_ACCESSES = true;
+    static constexpr bool OPEN_BUS = true;
+};
+
+#endif // ACCURACY_H
@@ -6,9 +6,30 @@
 #include "utils/Logger.h"
 
 
-CPU::CPU() : _bus(nullptr)
+CPU::CPU(Accuracy accuracy)
+    : _bus(nullptr),
+      _accuracy(accuracy),
+      _table(GetInstructionTable(accuracy)),
+      _read(&Bus::CPURead<BalancedAccuracy>),
+      _write(&Bus::CPUWrite<BalancedAccuracy>),
+      _cycles(0),
+      _totalCycles(0),
+      _instructionCount(0),
+      _nmiCount(0),
+      _irqCount(0)
 {
     LOG_INFO("CPU Init");
+
+    if (accuracy == Accuracy::FAST)
+    {
+        _read = &Bus::CPURead<FastAccuracy>;
+        _write = &Bus::CPUWrite<FastAccuracy>;
+    }
+    else if (accuracy == Accuracy::EXACT)
+    {
+        _read = &Bus::CPURead<ExactAccuracy>;
+        _write = &Bus::CPUWrite<ExactAccuracy>;
+    }
 }
 
 CPU::~CPU()
@@ -30,16 +51,21 @@ void CPU::Reset()
     P = F_UNUSED | F_INTERRUPT; // Set unused and interrupt disable flags
     
     // Set Program Counter to the address stored at the reset vector (0xFFFC)
-    PC = (_bus->CPURead(0xFFFD) << 8) | _bus->CPURead(0xFFFC);
+    PC = (Read(0xFFFD) << 8) | Read(0xFFFC);
     
     // Reset internal helper variables
     _addrAbs = 0;
     _addrRel = 0;
     _fetched = 0;
+    _opcode = 0;
+    _opcodeAddress = PC;
 
     // Reset takes time
     _cycles = 7; // Reset takes 7 _cycles
     _totalCycles = 0;
+    _instructionCount = 0;
+    _nmiCount = 0;
+    _irqCount = 0;
 }
 
 void CPU::WriteMemory(uint16_t address, uint8_t value)
@@ -52,6 +78,11 @@ uint8_t CPU::ReadMemory(uint16_t address) const
     return _bus->CPURead(address);
 }
 
+uint8_t CPU::PeekMemory(uint16_t address) const
+{
+    return _bus->CPUPeek(address);
+}
+
 void CPU::LoadProgram(const uint8_t* program, size_t size, uint16_t address)
 {
     for (size_t i = 0; i < size; ++i)
@@ -86,14 +117,14 @@ void CPU::UpdateZN(uint8_t value)
 
 void CPU::PushStack(uint8_t value)
 {
-    _bus->CPUWrite(0x0100 + SP, value);
+    Write(0x0100 + SP, value);
     SP--;
 }
 
 uint8_t CPU::PopStack()
 {
     SP++;
-    return _bus->CPURead(0x0100 + SP);
+    return Read(0x0100 + SP);
 }
 
 void CPU::PushStack16(uint16_t value)
@@ -111,7 +142,7 @@ uint16_t CPU::PopStack16()
 
 uint8_t CPU::ReadPC()
 {
-    return _bus->CPURead(PC++);
+    return Read(PC++);
 }
 
 uint16_t CPU::ReadPC16()
@@ -121,22 +152,48 @@ uint16_t CPU::ReadPC16()
     return (high << 8) | low;
 }
 
+uint8_t CPU::Read(uint16_t address)
+{
+    return (_bus->*_read)(address);
+}
+
+void CPU::Write(uint16_t address, uint8_t value)
+{
+    (_bus->*_write)(address, value);
+}
+
 uint8_t CPU::Fetch()
 {
     if (INSTRUCTION_TABLE[_opcode].addrMode == &CPU::ACC)
         _fetched = A;
     else
-        _fetched = _bus->CPURead(_addrAbs);
+        _fetched = Read(_addrAbs);
     return _fetched;
 }
 
+void CPU::Commit(uint8_t value)
+{
+    Commit<BalancedAccuracy>(value);
+}
+
+template <class Policy>
 void CPU::Commit(uint8_t value)
 {
     // write result back
     if (INSTRUCTION_TABLE[_opcode].addrMode == &CPU::ACC)
         A = value;
     else
-        _bus->CPUWrite(_addrAbs, value);
+        WriteBack<Policy>(value);
+}
+
+template <class Policy>
+void CPU::WriteBack(uint8_t value)
+{
+    // The 6502 writes the unmodified value back before the result
+    if constexpr (Policy::DUMMY_ACCESSES)
+        Write(_addrAbs, _fetched);
+
+    Write(_addrAbs, value);
 }
 
 const char* CPU::GetCurrentInstruction() const
@@ -156,8 +213,8 @@ void CPU::Interrupt(uint16_t vector)
     SetFlag(StatusFlag::F_INTERRUPT, true);
 
     // Load vector
-    uint16_t lo = _bus->CPURead(vector);
-    uint16_t hi = _bus->CPURead(vector + 1);
+    uint16_t lo = Read(vector);
+    uint16_t hi = Read(vector + 1);
     PC = (hi << 8) | lo;
 
     // Interrupt handling takes 7 cycles
@@ -177,19 +234,23 @@ void CPU::Clock()
         {
             // LOG_INFO("NMI Interrupt");
             _nmiPending = false;
+            _nmiCount++;
             Interrupt(0xFFFA); // NMI vector
         }
         else if (_irqPending && !GetFlag(StatusFlag::F_INTERRUPT))
         {
             LOG_DEBUG("IRQ Interrupt");
             _irqPending = false;
+            _irqCount++;
             Interrupt(0xFFFE); // IRQ vector
         }
         else
         {
             // Fetch the next opcode
+            _opcodeAddress = PC;
             _opcode = ReadPC();
-            const Instruction& instr = INSTRUCTION_TABLE[_opcode];
+            _instructionCount++;
+            const Instruction& instr = _table[_opcode];
 
             // Set base _cycles
             _cycles = instr.cycles;
@@ -200,6 +261,15 @@ void CPU::Clock()
             
             // Add extra cycle only if BOTH addressing mode AND operation require it
             _cycles += (additionalCycle1 & additionalCycle2);
+
+#ifdef CPU_OPCODE_STATS
+            // Branch() adds its own cycles: +1 taken, +1 more on page cross
+            uint64_t penalty = _cycles - instr.cycles;
+            if (instr.addrMode == &CPU::REL)
+                _opcodeStats.Record(_opcode, _cycles, penalty == 2, penalty > 0);
+            else
+                _opcodeStats.Record(_opcode, _cycles, penalty > 0, false);
+#endif
         }
     }
 
@@ -272,36 +342,80 @@ uint8_t CPU::REL()
     return 0;
 }
 
+// EXACT: the last byte on the data bus before the operand access is
+// the address high byte (or the pointer's), which is what an unmapped
+// read returns. An indexed access first reads from the address with the
+// carry not yet added to the high byte: reads only when the page is
+// crossed, stores and read-modify-writes every time.
+template <class Policy, bool WRITE>
+void CPU::IndexedDummyRead(uint16_t base)
+{
+    if constexpr (Policy::DUMMY_ACCESSES)
+    {
+        if (WRITE || (base & 0xFF00) != (_addrAbs & 0xFF00))
+            _bus->SetOpenBus(Read((base & 0xFF00) | (_addrAbs & 0x00FF)));
+    }
+}
+
 // Absolute - next two bytes are the full 16-bit address
 uint8_t CPU::ABS()
+{
+    return ABS<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::ABS()
 {
     uint16_t lo = ReadPC();
     uint16_t hi = ReadPC();
     
     _addrAbs = (hi << 8) | lo;
+
+    if constexpr (Policy::OPEN_BUS)
+        _bus->SetOpenBus((uint8_t) hi);
     
     return 0;
 }
 
 // Absolute,X - next two bytes + X register
 uint8_t CPU::ABX()
+{
+    return ABX<BalancedAccuracy>();
+}
+
+template <class Policy, bool WRITE>
+uint8_t CPU::ABX()
 {
     uint16_t lo = ReadPC();
     uint16_t hi = ReadPC();
     
     _addrAbs = ((hi << 8) | lo) + X;
 
+    if constexpr (Policy::OPEN_BUS)
+        _bus->SetOpenBus((uint8_t) hi);
+    IndexedDummyRead<Policy, WRITE>(hi << 8);
+
     // Return 1 if page boundary crossed
     return ((_addrAbs & 0xFF00) != (hi << 8)) ? 1 : 0;
 }
 
 // Absolute,Y - next two bytes + Y register
 uint8_t CPU::ABY()
+{
+    return ABY<BalancedAccuracy>();
+}
+
+template <class Policy, bool WRITE>
+uint8_t CPU::ABY()
 {
     uint16_t lo = ReadPC();
     uint16_t hi = ReadPC();
     
     _addrAbs = ((hi << 8) | lo) + Y;
+
+    if constexpr (Policy::OPEN_BUS)
+        _bus->SetOpenBus((uint8_t) hi);
+    IndexedDummyRead<Policy, WRITE>(hi << 8);
     
     // Return 1 if page boundary crossed
     return ((_addrAbs & 0xFF00) != (hi << 8)) ? 1 : 0;
@@ -316,34 +430,53 @@ uint8_t CPU::IND()
 
     // Simulate 6502 page boundary hardware bug
     if ((ptr & 0x00FF) == 0x00FF)
-        _addrAbs = (_bus->CPURead(ptr & 0xFF00) << 8) | _bus->CPURead(ptr);
+        _addrAbs = (Read(ptr & 0xFF00) << 8) | Read(ptr);
     else
-        _addrAbs = (_bus->CPURead(ptr + 1) << 8) | _bus->CPURead(ptr);
+        _addrAbs = (Read(ptr + 1) << 8) | Read(ptr);
 
     return 0;
 }
 
 // (Indirect,X) - next byte + X register points to zero page address
 uint8_t CPU::IZX()
+{
+    return IZX<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::IZX()
 {
     uint16_t t = ReadPC();
-    uint16_t lo = _bus->CPURead((t + X) & 0x00FF);
-    uint16_t hi = _bus->CPURead((t + X + 1) & 0x00FF);
+    uint16_t lo = Read((t + X) & 0x00FF);
+    uint16_t hi = Read((t + X + 1) & 0x00FF);
     
     _addrAbs = (hi << 8) | lo;
+
+    if constexpr (Policy::OPEN_BUS)
+        _bus->SetOpenBus((uint8_t) hi);
     
     return 0;
 }
 
 // (Indirect),Y - next byte points to zero page address, add Y register
 uint8_t CPU::IZY()
+{
+    return IZY<BalancedAccuracy>();
+}
+
+template <class Policy, bool WRITE>
+uint8_t CPU::IZY()
 {
     uint16_t t = ReadPC();
-    uint16_t lo = _bus->CPURead(t & 0x00FF);
-    uint16_t hi = _bus->CPURead((t + 1) & 0x00FF);
+    uint16_t lo = Read(t & 0x00FF);
+    uint16_t hi = Read((t + 1) & 0x00FF);
     
     uint16_t base = (hi << 8) | lo;
     _addrAbs = base + Y;
+
+    if constexpr (Policy::OPEN_BUS)
+        _bus->SetOpenBus((uint8_t) hi);
+    IndexedDummyRead<Policy, WRITE>(base);
  
     // Return 1 if page boundary crossed
     return ((base & 0xFF00) != (_addrAbs & 0xFF00)) ? 1 : 0;
@@ -377,19 +510,19 @@ uint8_t CPU::LDY()
 
 uint8_t CPU::STA()
 {
-    _bus->CPUWrite(_addrAbs, A);
+    Write(_addrAbs, A);
     return 0;
 }
 
 uint8_t CPU::STX()
 {
-    _bus->CPUWrite(_addrAbs, X);
+    Write(_addrAbs, X);
     return 0;
 }
 
 uint8_t CPU::STY()
 {
-    _bus->CPUWrite(_addrAbs, Y);
+    Write(_addrAbs, Y);
     return 0;
 }
 
@@ -465,20 +598,32 @@ uint8_t CPU::SBC()
     return 1;  // Can use extra cycle
 }
 
+uint8_t CPU::INC()
+{
+    return INC<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::INC()
 {
     Fetch();
     uint8_t result = _fetched + 1;
-    _bus->CPUWrite(_addrAbs, result);
+    WriteBack<Policy>(result);
     UpdateZN(result);
     return 0;
 }
 
+uint8_t CPU::DEC()
+{
+    return DEC<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::DEC()
 {
     Fetch();
     uint8_t result = _fetched - 1;
-    _bus->CPUWrite(_addrAbs, result);
+    WriteBack<Policy>(result);
     UpdateZN(result);
     return 0;
 }
@@ -552,6 +697,12 @@ uint8_t CPU::BIT()
 // SHIFT/ROTATE INSTRUCTIONS
 // ============================================================================
 
+uint8_t CPU::ASL()
+{
+    return ASL<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::ASL()
 {
     Fetch();
@@ -561,10 +712,16 @@ uint8_t CPU::ASL()
     SetFlag(F_ZERO, (result & 0x00FF) == 0);
     SetFlag(F_NEGATIVE, (result & 0x80) != 0);
     
-    Commit(result & 0xFF);
+    Commit<Policy>(result & 0xFF);
     return 0;
 }
 
+uint8_t CPU::LSR()
+{
+    return LSR<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::LSR()
 {
     Fetch();
@@ -572,10 +729,16 @@ uint8_t CPU::LSR()
     uint8_t result = _fetched >> 1;
     UpdateZN(result);
     
-    Commit(result);
+    Commit<Policy>(result);
     return 0;
 }
 
+uint8_t CPU::ROL()
+{
+    return ROL<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::ROL()
 {
     Fetch();
@@ -584,10 +747,16 @@ uint8_t CPU::ROL()
     result &= 0xFF;
     UpdateZN(result);
     
-    Commit(result);
+    Commit<Policy>(result);
     return 0;
 }
 
+uint8_t CPU::ROR()
+{
+    return ROR<BalancedAccuracy>();
+}
+
+template <class Policy>
 uint8_t CPU::ROR()
 {
     Fetch();
@@ -595,7 +764,7 @@ uint8_t CPU::ROR()
     SetFlag(F_CARRY, (_fetched & 0x01) != 0);
     UpdateZN(result);
     
-    Commit(result & 0x00FF);
+    Commit<Policy>(result & 0x00FF);
     return 0;
 }
 
@@ -640,7 +809,7 @@ uint8_t CPU::BRK()
     SetFlag(F_BREAK, true);
     PushStack(P);
     SetFlag(F_INTERRUPT, true);
-    PC = _bus->CPURead(0xFFFE) | (_bus->CPURead(0xFFFF) << 8);
+    PC = Read(0xFFFE) | (Read(0xFFFF) << 8);
     return 0;
 }
 
@@ -858,7 +1027,7 @@ uint8_t CPU::LAX()
 // Stores the bitwise AND of A and X to memory
 uint8_t CPU::SAX()
 {
-    _bus->CPUWrite(_addrAbs, A & X);
+    Write(_addrAbs, A & X);
     return 0;
 }
 
@@ -866,10 +1035,16 @@ uint8_t CPU::SAX()
 // Decrements memory value then compares with A
 // Equivalent to: DEC + CMP
 uint8_t CPU::DCP()
+{
+    return DCP<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::DCP()
 {
     Fetch();
     uint8_t value = _fetched - 1;
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
 
     // Compare A with decremented value
     uint16_t result = (uint16_t) A - (uint16_t) value;
@@ -884,11 +1059,17 @@ uint8_t CPU::DCP()
 // Increments memory value then subtracts from A
 // Equivalent to: INC + SBC
 uint8_t CPU::ISC()
+{
+    return ISC<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::ISC()
 {
     Fetch();
 
     uint8_t value = _fetched + 1;
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
     
     // SBC with incremented value
     uint16_t result = A + (value ^ 0xFF) + (GetFlag(StatusFlag::F_CARRY) ? 1 : 0);
@@ -906,6 +1087,12 @@ uint8_t CPU::ISC()
 // Shifts memory left then ORs result with A
 // Equivalent to: ASL + ORA
 uint8_t CPU::SLO()
+{
+    return SLO<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::SLO()
 {
     Fetch();
     uint8_t value = _fetched;
@@ -913,7 +1100,7 @@ uint8_t CPU::SLO()
     // ASL
     SetFlag(StatusFlag::F_CARRY, (value & 0x80) != 0);
     value <<= 1;
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
     
     // ORA
     A |= value;
@@ -926,6 +1113,12 @@ uint8_t CPU::SLO()
 // Rotates memory left then ANDs result with A
 // Equivalent to: ROL + AND
 uint8_t CPU::RLA()
+{
+    return RLA<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::RLA()
 {
     Fetch();
     uint8_t value = _fetched;
@@ -934,7 +1127,7 @@ uint8_t CPU::RLA()
     bool oldCarry = GetFlag(StatusFlag::F_CARRY);
     SetFlag(StatusFlag::F_CARRY, (value & 0x80) != 0);
     value = (value << 1) | (oldCarry ? 1 : 0);
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
     
     // AND
     A &= value;
@@ -947,6 +1140,12 @@ uint8_t CPU::RLA()
 // Shifts memory right then XORs result with A
 // Equivalent to: LSR + EOR
 uint8_t CPU::SRE()
+{
+    return SRE<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::SRE()
 {
     Fetch();
     uint8_t value = _fetched;
@@ -954,7 +1153,7 @@ uint8_t CPU::SRE()
     // LSR
     SetFlag(StatusFlag::F_CARRY, (value & 0x01) != 0);
     value >>= 1;
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
     
     // EOR
     A ^= value;
@@ -967,6 +1166,12 @@ uint8_t CPU::SRE()
 // Rotates memory right then adds result to A
 // Equivalent to: ROR + ADC
 uint8_t CPU::RRA()
+{
+    return RRA<BalancedAccuracy>();
+}
+
+template <class Policy>
+uint8_t CPU::RRA()
 {
     Fetch();
     uint8_t value = _fetched;
@@ -975,7 +1180,7 @@ uint8_t CPU::RRA()
     bool oldCarry = GetFlag(StatusFlag::F_CARRY);
     SetFlag(StatusFlag::F_CARRY, (value & 0x01) != 0);
     value = (value >> 1) | (oldCarry ? 0x80 : 0);
-    _bus->CPUWrite(_addrAbs, value);
+    WriteBack<Policy>(value);
     
     // ADC
     uint16_t result = A + value + (GetFlag(StatusFlag::F_CARRY) ? 1 : 0);
@@ -1042,4 +1247,26 @@ uint8_t CPU::SBX()
     UpdateZN(X);
     
     return 0;
-}
\ No newline at end of file
+}
+
+// EXACT instances (BALANCED ones are instantiated by the plain members)
+template uint8_t CPU::ABS<ExactAccuracy>();
+template uint8_t CPU::ABX<ExactAccuracy>();
+template uint8_t CPU::ABY<ExactAccuracy>();
+template uint8_t CPU::IZX<ExactAccuracy>();
+template uint8_t CPU::IZY<ExactAccuracy>();
+template uint8_t CPU::ABX<ExactAccuracy, true>();
+template uint8_t CPU::ABY<ExactAccuracy, true>();
+template uint8_t CPU::IZY<ExactAccuracy, true>();
+template uint8_t CPU::INC<ExactAccuracy>();
+template uint8_t CPU::DEC<ExactAccuracy>();
+template uint8_t CPU::ASL<ExactAccuracy>();
+template uint8_t CPU::LSR<ExactAccuracy>();
+template uint8_t CPU::ROL<ExactAccuracy>();
+template uint8_t CPU::ROR<ExactAccuracy>();
+template uint8_t CPU::DCP<ExactAccuracy>();
+template uint8_t CPU::ISC<ExactAccuracy>();
+template uint8_t CPU::SLO<ExactAccuracy>();
+template uint8_t CPU::RLA<ExactAccuracy>();
+template uint8_t CPU::SRE<ExactAccuracy>();
+template uint8_t CPU::RRA<ExactAccuracy>();
@@ -4,21 +4,42 @@
 #include <cstdint>
 #include <memory>
 
+#include "Accuracy.h"
+
+#ifdef CPU_OPCODE_STATS
+#include "OpcodeStats.h"
+#endif
+
 // Forward declarationc
 class Bus;
+struct Instruction;
 
 class CPU
 {
 private:
     Bus* _bus;
 
+    // Fixed at construction; EXACT dispatches through its own table
+    Accuracy _accuracy;
+    const Instruction* _table;
+
+    // Bus access instances for the same accuracy (see Read/Write)
+    uint8_t (Bus::*_read)(uint16_t);
+    void (Bus::*_write)(uint16_t, uint8_t);
+
     // Current opcode being executed
     uint8_t _opcode;
+    uint16_t _opcodeAddress; // PC the current opcode was fetched from
 
     // Cycle counter;
     uint64_t _cycles;
     uint64_t _totalCycles;
 
+    // Since reset: opcodes executed and interrupts serviced (telemetry)
+    uint64_t _instructionCount;
+    uint64_t _nmiCount;
+    uint64_t _irqCount;
+
     // Interrupt flags
     bool _nmiPending = false;
     bool _irqPending = false;
@@ -28,6 +49,10 @@ private:
     uint16_t _addrAbs;
     uint16_t _addrRel;
 
+#ifdef CPU_OPCODE_STATS
+    OpcodeStats _opcodeStats;
+#endif
+
 public:
     // Status flag bit positions
     enum StatusFlag
@@ -60,7 +85,7 @@ public:
         M_IZY  // (Indirect),Y
     };
 
-    CPU();
+    explicit CPU(Accuracy accuracy = Accuracy::BALANCED);
     ~CPU();
 
     void ConnectBus(Bus* bus);
@@ -82,6 +107,18 @@ public:
     // Execute one full instruction
     void Step();
 
+    // Account for the rest of the current instruction at once; returns the
+    // cycles skipped (FAST bus, which then runs the PPU to catch up)
+    uint64_t FinishInstruction()
+    {
+        uint64_t remaining = _cycles;
+        _cycles = 0;
+        _totalCycles += remaining;
+        return remaining;
+    }
+
+    Accuracy GetAccuracy() const { return _accuracy; }
+
     // Load a program into memory at a specified address
     void LoadProgram(const uint8_t* program, size_t size, uint16_t address = 0x8000);
 
@@ -100,10 +137,15 @@ public:
     const char* GetCurrentInstruction() const;
 
     // Data read/write helpers
+    uint8_t Read(uint16_t address);              // Through the tier's bus path
+    void Write(uint16_t address, uint8_t value);
     uint8_t Fetch();
     void Commit(uint8_t value);
+    template <class Policy> void Commit(uint8_t value);
+    template <class Policy> void WriteBack(uint8_t value); // Read-modify-write result
     void WriteMemory(uint16_t address, uint8_t value);
     uint8_t ReadMemory(uint16_t address) const;
+    uint8_t PeekMemory(uint16_t address) const; // No side effects (tools)
 
     // Branch helper
     uint8_t Branch(bool condition);
@@ -119,7 +161,16 @@ public:
     uint16_t GetAddressRelative() const { return _addrRel; }
     uint64_t GetCycles() const { return _cycles; }
     uint64_t GetTotalCycles() const { return _totalCycles; }
+    uint64_t GetInstructionCount() const { return _instructionCount; }
+    uint64_t GetNMICount() const { return _nmiCount; }
+    uint64_t GetIRQCount() const { return _irqCount; }
     uint8_t GetOpcode() const { return _opcode; }
+    uint16_t GetOpcodeAddress() const { return _opcodeAddress; }
+
+#ifdef CPU_OPCODE_STATS
+    // Per-opcode histogram (only in CPU_OPCODE_STATS builds)
+    OpcodeStats& GetOpcodeStats() { return _opcodeStats; }
+#endif
 
     // Interrupts
     void NMI() { _nmiPending = true; }
@@ -128,12 +179,33 @@ public:
     // Interrupt helpers
     void Interrupt(uint16_t vector_address);
 
+    // True if the next instruction boundary will service an interrupt
+    bool IsInterruptPending() const { return _nmiPending || (_irqPending && !GetFlag(F_INTERRUPT)); }
+
     // Addressing Modes - return 1 if additional cycle may be needed
     uint8_t IMP(); uint8_t ACC(); uint8_t IMM(); uint8_t REL();
     uint8_t ZP0(); uint8_t ZPX(); uint8_t ZPY();
     uint8_t ABS(); uint8_t ABX(); uint8_t ABY();
     uint8_t IND(); uint8_t IZX(); uint8_t IZY();
 
+    // Per-accuracy versions of the modes and instructions that make dummy
+    // accesses; the plain ones above and below are the BALANCED instances.
+    // WRITE marks the indexed modes of stores and read-modify-writes, which
+    // always make the dummy read, page crossed or not.
+    template <class Policy> uint8_t ABS();
+    template <class Policy, bool WRITE = false> uint8_t ABX();
+    template <class Policy, bool WRITE = false> uint8_t ABY();
+    template <class Policy> uint8_t IZX();
+    template <class Policy, bool WRITE = false> uint8_t IZY();
+    template <class Policy, bool WRITE> void IndexedDummyRead(uint16_t base);
+
+    template <class Policy> uint8_t INC(); template <class Policy> uint8_t DEC();
+    template <class Policy> uint8_t ASL(); template <class Policy> uint8_t LSR();
+    template <class Policy> uint8_t ROL(); template <class Policy> uint8_t ROR();
+    template <class Policy> uint8_t DCP(); template <class Policy> uint8_t ISC();
+    template <class Policy> uint8_t SLO(); template <class Policy> uint8_t RLA();
+    template <class Policy> uint8_t SRE(); template <class Policy> uint8_t RRA();
+
     // Instruction implementations - return 1 if additional cycle may be needed
     uint8_t LDA(); uint8_t LDX(); uint8_t LDY(); uint8_t STA();
     uint8_t STX(); uint8_t STY(); uint8_t TAX(); uint8_t TAY();
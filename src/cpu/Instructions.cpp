@@ -1,5 +1,6 @@
 #include "Instructions.h"
 #include "CPU.h"
+#include "OpcodeTable.h"
 
 // Complete 6502 opcode table including illegal/unofficial opcodes
 // Format: {Mnemonic, OperateFunction, AddressModeFunction, Cycles}
@@ -275,4 +276,67 @@ const Instruction INSTRUCTION_TABLE[256] = {
     /* 0xFD */ {"SBC", &CPU::SBC, &CPU::ABX, 4},
     /* 0xFE */ {"INC", &CPU::INC, &CPU::ABX, 7},
     /* 0xFF */ {"ISC", &CPU::ISC, &CPU::ABX, 7}
-};
\ No newline at end of file
+};
+
+const Instruction* GetInstructionTable(Accuracy accuracy)
+{
+    if (accuracy != Accuracy::EXACT)
+        return INSTRUCTION_TABLE;
+
+    // INSTRUCTION_TABLE with the EXACT instances of the addressing modes
+    // and read-modify-write instructions that make dummy accesses
+    static const struct ExactTable
+    {
+        Instruction table[256];
+
+        ExactTable()
+        {
+            static const struct { AddressModeFunc from, to; } MODES[] = {
+                { &CPU::ABS, &CPU::ABS<ExactAccuracy> }, { &CPU::ABX, &CPU::ABX<ExactAccuracy> },
+                { &CPU::ABY, &CPU::ABY<ExactAccuracy> }, { &CPU::IZX, &CPU::IZX<ExactAccuracy> },
+                { &CPU::IZY, &CPU::IZY<ExactAccuracy> }
+            };
+            // Stores and read-modify-writes make the indexed dummy read
+            // even without a page cross
+            static const struct { AddressModeFunc from, to; } WRITE_MODES[] = {
+                { &CPU::ABX, &CPU::ABX<ExactAccuracy, true> }, { &CPU::ABY, &CPU::ABY<ExactAccuracy, true> },
+                { &CPU::IZY, &CPU::IZY<ExactAccuracy, true> }
+            };
+            static const struct { OperateFunc from, to; } OPS[] = {
+                { &CPU::INC, &CPU::INC<ExactAccuracy> }, { &CPU::DEC, &CPU::DEC<ExactAccuracy> },
+                { &CPU::ASL, &CPU::ASL<ExactAccuracy> }, { &CPU::LSR, &CPU::LSR<ExactAccuracy> },
+                { &CPU::ROL, &CPU::ROL<ExactAccuracy> }, { &CPU::ROR, &CPU::ROR<ExactAccuracy> },
+                { &CPU::DCP, &CPU::DCP<ExactAccuracy> }, { &CPU::ISC, &CPU::ISC<ExactAccuracy> },
+                { &CPU::SLO, &CPU::SLO<ExactAccuracy> }, { &CPU::RLA, &CPU::RLA<ExactAccuracy> },
+                { &CPU::SRE, &CPU::SRE<ExactAccuracy> }, { &CPU::RRA, &CPU::RRA<ExactAccuracy> }
+            };
+
+            for (int op = 0; op < 256; ++op)
+            {
+                table[op] = INSTRUCTION_TABLE[op];
+                bool write = table[op].operate == &CPU::STA;
+
+                for (const auto& operate : OPS)
+                    if (table[op].operate == operate.from)
+                    {
+                        table[op].operate = operate.to;
+                        write = true;
+                    }
+                if (write)
+                    for (const auto& mode : WRITE_MODES)
+                        if (table[op].addrMode == mode.from)
+                            table[op].addrMode = mode.to;
+                for (const auto& mode : MODES)
+                    if (table[op].addrMode == mode.from)
+                        table[op].addrMode = mode.to;
+            }
+        }
+    } EXACT;
+
+    return EXACT.table;
+}
+
+bool IsOfficialOpcode(uint8_t opcode)
+{
+    return OPCODE_TABLE[opcode].official;
+}
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 
+#include "Accuracy.h"
+
 
 // Forward declaration
 class CPU;
@@ -23,4 +25,12 @@ struct Instruction
 // Opcode lookup table (256 entries)
 extern const Instruction INSTRUCTION_TABLE[256];
 
+// Table a CPU of the given accuracy dispatches through. FAST and
+// BALANCED share INSTRUCTION_TABLE; names and cycle counts are the
+// same in every table.
+const Instruction* GetInstructionTable(Accuracy accuracy);
+
+// True for the 151 documented 6502 opcodes
+bool IsOfficialOpcode(uint8_t opcode);
+
 #endif // INSTRUCTIONS_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <vector>
+
+#include "OpcodeStats.h"
+#include "CPU.h"
+#include "Instructions.h"
+#include "OpcodeTable.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+
+
+void OpcodeStats::Reset()
+{
+    _entries.fill(Entry());
+}
+
+uint64_t OpcodeStats::GetTotalExecutions() const
+{
+    uint64_t total = 0;
+    for (const Entry& e : _entries)
+        total += e.executions;
+    return total;
+}
+
+uint64_t OpcodeStats::GetTotalCycles() const
+{
+    uint64_t total = 0;
+    for (const Entry& e : _entries)
+        total += e.cycles;
+    return total;
+}
+
+void OpcodeStats::Dump(FILE* out) const
+{
+    std::vector<int> order;
+    for (int op = 0; op < 256; ++op)
+    {
+        if (_entries[op].executions > 0)
+            order.push_back(op);
+    }
+
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return _entries[a].cycles > _entries[b].cycles;
+    });
+
+    const uint64_t totalCycles = GetTotalCycles();
+
+    std::fprintf(out, "# opcode  name mode  executions        cycles  %%cycles  page_cross  br_taken\n");
+    for (int op : order)
+    {
+        const Entry& e = _entries[op];
+        const Instruction& instr = INSTRUCTION_TABLE[op];
+
+        std::fprintf(out, "  $%02X     %s  %s  %12llu  %12llu  %6.2f%%  %10llu  %8llu\n",
+                     op, instr.name, Disassembler::GetModeName(OPCODE_TABLE[op].mode),
+                     (unsigned long long) e.executions,
+                     (unsigned long long) e.cycles,
+                     totalCycles ? 100.0 * e.cycles / totalCycles : 0.0,
+                     (unsigned long long) e.pageCrossings,
+                     (unsigned long long) e.branchesTaken);
+    }
+
+    std::fprintf(out, "# total: %llu instructions, %llu cycles, %zu distinct opcodes\n",
+                 (unsigned long long) GetTotalExecutions(),
+                 (unsigned long long) totalCycles,
+                 order.size());
+}
+
+bool OpcodeStats::Dump(const std::string& filename) const
+{
+    FILE* out = std::fopen(filename.c_str(), "w");
+    if (!out)
+    {
+        LOG_ERROR("Failed to open opcode stats file: %s", filename.c_str());
+        return false;
+    }
+
+    Dump(out);
+    std::fclose(out);
+
+    LOG_INFO("Opcode stats written to %s", filename.c_str());
+    return true;
+}
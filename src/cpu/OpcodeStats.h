@@ -0,0 +1,47 @@
+#ifndef OPCODE_STATS_H
+#define OPCODE_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+// Per-opcode execution histogram.
+// The CPU only records into this when built with CPU_OPCODE_STATS
+// (make OPCODE_STATS=1); otherwise the hook in CPU::Clock() is compiled out.
+class OpcodeStats
+{
+public:
+    struct Entry
+    {
+        uint64_t executions    = 0;
+        uint64_t cycles        = 0; // Including page-cross and branch penalties
+        uint64_t pageCrossings = 0; // Instructions that paid a page-cross cycle
+        uint64_t branchesTaken = 0;
+    };
+
+    void Record(uint8_t opcode, uint64_t cycles, bool pageCrossed, bool branchTaken)
+    {
+        Entry& e = _entries[opcode];
+        e.executions++;
+        e.cycles += cycles;
+        e.pageCrossings += pageCrossed;
+        e.branchesTaken += branchTaken;
+    }
+
+    void Reset();
+
+    const Entry& Get(uint8_t opcode) const { return _entries[opcode]; }
+    uint64_t GetTotalExecutions() const;
+    uint64_t GetTotalCycles() const;
+
+    // Write the histogram sorted by cycles spent (hottest handlers first)
+    void Dump(FILE* out) const;
+    bool Dump(const std::string& filename) const;
+
+private:
+    std::array<Entry, 256> _entries;
+};
+
+#endif // OPCODE_STATS_H
@@ -0,0 +1,298 @@
+#ifndef OPCODE_TABLE_H
+#define OPCODE_TABLE_H
+
+#include <cstdint>
+
+#include "CPU.h"
+
+
+// Static per-opcode metadata for tools (disassembler, tracer, profiler).
+// Mirrors INSTRUCTION_TABLE but is constexpr and needs no member-function
+// pointer comparisons to answer "how long is this instruction".
+struct OpcodeInfo
+{
+    const char* mnemonic;
+    CPU::AddressingMode mode;
+    uint8_t length;  // Bytes including the opcode
+    bool official;   // One of the 151 documented opcodes
+};
+
+// Format: {Mnemonic, AddressingMode, Length, Official}
+inline constexpr OpcodeInfo OPCODE_TABLE[256] = {
+    /* 0x00 */ {"BRK", CPU::M_IMP, 1, true },
+    /* 0x01 */ {"ORA", CPU::M_IZX, 2, true },
+    /* 0x02 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x03 */ {"SLO", CPU::M_IZX, 2, false},
+    /* 0x04 */ {"NOP", CPU::M_ZP0, 2, false},
+    /* 0x05 */ {"ORA", CPU::M_ZP0, 2, true },
+    /* 0x06 */ {"ASL", CPU::M_ZP0, 2, true },
+    /* 0x07 */ {"SLO", CPU::M_ZP0, 2, false},
+    /* 0x08 */ {"PHP", CPU::M_IMP, 1, true },
+    /* 0x09 */ {"ORA", CPU::M_IMM, 2, true },
+    /* 0x0A */ {"ASL", CPU::M_ACC, 1, true },
+    /* 0x0B */ {"ANC", CPU::M_IMM, 2, false},
+    /* 0x0C */ {"NOP", CPU::M_ABS, 3, false},
+    /* 0x0D */ {"ORA", CPU::M_ABS, 3, true },
+    /* 0x0E */ {"ASL", CPU::M_ABS, 3, true },
+    /* 0x0F */ {"SLO", CPU::M_ABS, 3, false},
+
+    /* 0x10 */ {"BPL", CPU::M_REL, 2, true },
+    /* 0x11 */ {"ORA", CPU::M_IZY, 2, true },
+    /* 0x12 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x13 */ {"SLO", CPU::M_IZY, 2, false},
+    /* 0x14 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0x15 */ {"ORA", CPU::M_ZPX, 2, true },
+    /* 0x16 */ {"ASL", CPU::M_ZPX, 2, true },
+    /* 0x17 */ {"SLO", CPU::M_ZPX, 2, false},
+    /* 0x18 */ {"CLC", CPU::M_IMP, 1, true },
+    /* 0x19 */ {"ORA", CPU::M_ABY, 3, true },
+    /* 0x1A */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0x1B */ {"SLO", CPU::M_ABY, 3, false},
+    /* 0x1C */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0x1D */ {"ORA", CPU::M_ABX, 3, true },
+    /* 0x1E */ {"ASL", CPU::M_ABX, 3, true },
+    /* 0x1F */ {"SLO", CPU::M_ABX, 3, false},
+
+    /* 0x20 */ {"JSR", CPU::M_ABS, 3, true },
+    /* 0x21 */ {"AND", CPU::M_IZX, 2, true },
+    /* 0x22 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x23 */ {"RLA", CPU::M_IZX, 2, false},
+    /* 0x24 */ {"BIT", CPU::M_ZP0, 2, true },
+    /* 0x25 */ {"AND", CPU::M_ZP0, 2, true },
+    /* 0x26 */ {"ROL", CPU::M_ZP0, 2, true },
+    /* 0x27 */ {"RLA", CPU::M_ZP0, 2, false},
+    /* 0x28 */ {"PLP", CPU::M_IMP, 1, true },
+    /* 0x29 */ {"AND", CPU::M_IMM, 2, true },
+    /* 0x2A */ {"ROL", CPU::M_ACC, 1, true },
+    /* 0x2B */ {"ANC", CPU::M_IMM, 2, false},
+    /* 0x2C */ {"BIT", CPU::M_ABS, 3, true },
+    /* 0x2D */ {"AND", CPU::M_ABS, 3, true },
+    /* 0x2E */ {"ROL", CPU::M_ABS, 3, true },
+    /* 0x2F */ {"RLA", CPU::M_ABS, 3, false},
+
+    /* 0x30 */ {"BMI", CPU::M_REL, 2, true },
+    /* 0x31 */ {"AND", CPU::M_IZY, 2, true },
+    /* 0x32 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x33 */ {"RLA", CPU::M_IZY, 2, false},
+    /* 0x34 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0x35 */ {"AND", CPU::M_ZPX, 2, true },
+    /* 0x36 */ {"ROL", CPU::M_ZPX, 2, true },
+    /* 0x37 */ {"RLA", CPU::M_ZPX, 2, false},
+    /* 0x38 */ {"SEC", CPU::M_IMP, 1, true },
+    /* 0x39 */ {"AND", CPU::M_ABY, 3, true },
+    /* 0x3A */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0x3B */ {"RLA", CPU::M_ABY, 3, false},
+    /* 0x3C */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0x3D */ {"AND", CPU::M_ABX, 3, true },
+    /* 0x3E */ {"ROL", CPU::M_ABX, 3, true },
+    /* 0x3F */ {"RLA", CPU::M_ABX, 3, false},
+
+    /* 0x40 */ {"RTI", CPU::M_IMP, 1, true },
+    /* 0x41 */ {"EOR", CPU::M_IZX, 2, true },
+    /* 0x42 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x43 */ {"SRE", CPU::M_IZX, 2, false},
+    /* 0x44 */ {"NOP", CPU::M_ZP0, 2, false},
+    /* 0x45 */ {"EOR", CPU::M_ZP0, 2, true },
+    /* 0x46 */ {"LSR", CPU::M_ZP0, 2, true },
+    /* 0x47 */ {"SRE", CPU::M_ZP0, 2, false},
+    /* 0x48 */ {"PHA", CPU::M_IMP, 1, true },
+    /* 0x49 */ {"EOR", CPU::M_IMM, 2, true },
+    /* 0x4A */ {"LSR", CPU::M_ACC, 1, true },
+    /* 0x4B */ {"ALR", CPU::M_IMM, 2, false},
+    /* 0x4C */ {"JMP", CPU::M_ABS, 3, true },
+    /* 0x4D */ {"EOR", CPU::M_ABS, 3, true },
+    /* 0x4E */ {"LSR", CPU::M_ABS, 3, true },
+    /* 0x4F */ {"SRE", CPU::M_ABS, 3, false},
+
+    /* 0x50 */ {"BVC", CPU::M_REL, 2, true },
+    /* 0x51 */ {"EOR", CPU::M_IZY, 2, true },
+    /* 0x52 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x53 */ {"SRE", CPU::M_IZY, 2, false},
+    /* 0x54 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0x55 */ {"EOR", CPU::M_ZPX, 2, true },
+    /* 0x56 */ {"LSR", CPU::M_ZPX, 2, true },
+    /* 0x57 */ {"SRE", CPU::M_ZPX, 2, false},
+    /* 0x58 */ {"CLI", CPU::M_IMP, 1, true },
+    /* 0x59 */ {"EOR", CPU::M_ABY, 3, true },
+    /* 0x5A */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0x5B */ {"SRE", CPU::M_ABY, 3, false},
+    /* 0x5C */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0x5D */ {"EOR", CPU::M_ABX, 3, true },
+    /* 0x5E */ {"LSR", CPU::M_ABX, 3, true },
+    /* 0x5F */ {"SRE", CPU::M_ABX, 3, false},
+
+    /* 0x60 */ {"RTS", CPU::M_IMP, 1, true },
+    /* 0x61 */ {"ADC", CPU::M_IZX, 2, true },
+    /* 0x62 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x63 */ {"RRA", CPU::M_IZX, 2, false},
+    /* 0x64 */ {"NOP", CPU::M_ZP0, 2, false},
+    /* 0x65 */ {"ADC", CPU::M_ZP0, 2, true },
+    /* 0x66 */ {"ROR", CPU::M_ZP0, 2, true },
+    /* 0x67 */ {"RRA", CPU::M_ZP0, 2, false},
+    /* 0x68 */ {"PLA", CPU::M_IMP, 1, true },
+    /* 0x69 */ {"ADC", CPU::M_IMM, 2, true },
+    /* 0x6A */ {"ROR", CPU::M_ACC, 1, true },
+    /* 0x6B */ {"ARR", CPU::M_IMM, 2, false},
+    /* 0x6C */ {"JMP", CPU::M_IND, 3, true },
+    /* 0x6D */ {"ADC", CPU::M_ABS, 3, true },
+    /* 0x6E */ {"ROR", CPU::M_ABS, 3, true },
+    /* 0x6F */ {"RRA", CPU::M_ABS, 3, false},
+
+    /* 0x70 */ {"BVS", CPU::M_REL, 2, true },
+    /* 0x71 */ {"ADC", CPU::M_IZY, 2, true },
+    /* 0x72 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x73 */ {"RRA", CPU::M_IZY, 2, false},
+    /* 0x74 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0x75 */ {"ADC", CPU::M_ZPX, 2, true },
+    /* 0x76 */ {"ROR", CPU::M_ZPX, 2, true },
+    /* 0x77 */ {"RRA", CPU::M_ZPX, 2, false},
+    /* 0x78 */ {"SEI", CPU::M_IMP, 1, true },
+    /* 0x79 */ {"ADC", CPU::M_ABY, 3, true },
+    /* 0x7A */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0x7B */ {"RRA", CPU::M_ABY, 3, false},
+    /* 0x7C */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0x7D */ {"ADC", CPU::M_ABX, 3, true },
+    /* 0x7E */ {"ROR", CPU::M_ABX, 3, true },
+    /* 0x7F */ {"RRA", CPU::M_ABX, 3, false},
+
+    /* 0x80 */ {"NOP", CPU::M_IMM, 2, false},
+    /* 0x81 */ {"STA", CPU::M_IZX, 2, true },
+    /* 0x82 */ {"NOP", CPU::M_IMM, 2, false},
+    /* 0x83 */ {"SAX", CPU::M_IZX, 2, false},
+    /* 0x84 */ {"STY", CPU::M_ZP0, 2, true },
+    /* 0x85 */ {"STA", CPU::M_ZP0, 2, true },
+    /* 0x86 */ {"STX", CPU::M_ZP0, 2, true },
+    /* 0x87 */ {"SAX", CPU::M_ZP0, 2, false},
+    /* 0x88 */ {"DEY", CPU::M_IMP, 1, true },
+    /* 0x89 */ {"NOP", CPU::M_IMM, 2, false},
+    /* 0x8A */ {"TXA", CPU::M_IMP, 1, true },
+    /* 0x8B */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x8C */ {"STY", CPU::M_ABS, 3, true },
+    /* 0x8D */ {"STA", CPU::M_ABS, 3, true },
+    /* 0x8E */ {"STX", CPU::M_ABS, 3, true },
+    /* 0x8F */ {"SAX", CPU::M_ABS, 3, false},
+
+    /* 0x90 */ {"BCC", CPU::M_REL, 2, true },
+    /* 0x91 */ {"STA", CPU::M_IZY, 2, true },
+    /* 0x92 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x93 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x94 */ {"STY", CPU::M_ZPX, 2, true },
+    /* 0x95 */ {"STA", CPU::M_ZPX, 2, true },
+    /* 0x96 */ {"STX", CPU::M_ZPY, 2, true },
+    /* 0x97 */ {"SAX", CPU::M_ZPY, 2, false},
+    /* 0x98 */ {"TYA", CPU::M_IMP, 1, true },
+    /* 0x99 */ {"STA", CPU::M_ABY, 3, true },
+    /* 0x9A */ {"TXS", CPU::M_IMP, 1, true },
+    /* 0x9B */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x9C */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x9D */ {"STA", CPU::M_ABX, 3, true },
+    /* 0x9E */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0x9F */ {"XXX", CPU::M_IMP, 1, false},
+
+    /* 0xA0 */ {"LDY", CPU::M_IMM, 2, true },
+    /* 0xA1 */ {"LDA", CPU::M_IZX, 2, true },
+    /* 0xA2 */ {"LDX", CPU::M_IMM, 2, true },
+    /* 0xA3 */ {"LAX", CPU::M_IZX, 2, false},
+    /* 0xA4 */ {"LDY", CPU::M_ZP0, 2, true },
+    /* 0xA5 */ {"LDA", CPU::M_ZP0, 2, true },
+    /* 0xA6 */ {"LDX", CPU::M_ZP0, 2, true },
+    /* 0xA7 */ {"LAX", CPU::M_ZP0, 2, false},
+    /* 0xA8 */ {"TAY", CPU::M_IMP, 1, true },
+    /* 0xA9 */ {"LDA", CPU::M_IMM, 2, true },
+    /* 0xAA */ {"TAX", CPU::M_IMP, 1, true },
+    /* 0xAB */ {"LAX", CPU::M_IMM, 2, false},
+    /* 0xAC */ {"LDY", CPU::M_ABS, 3, true },
+    /* 0xAD */ {"LDA", CPU::M_ABS, 3, true },
+    /* 0xAE */ {"LDX", CPU::M_ABS, 3, true },
+    /* 0xAF */ {"LAX", CPU::M_ABS, 3, false},
+
+    /* 0xB0 */ {"BCS", CPU::M_REL, 2, true },
+    /* 0xB1 */ {"LDA", CPU::M_IZY, 2, true },
+    /* 0xB2 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0xB3 */ {"LAX", CPU::M_IZY, 2, false},
+    /* 0xB4 */ {"LDY", CPU::M_ZPX, 2, true },
+    /* 0xB5 */ {"LDA", CPU::M_ZPX, 2, true },
+    /* 0xB6 */ {"LDX", CPU::M_ZPY, 2, true },
+    /* 0xB7 */ {"LAX", CPU::M_ZPY, 2, false},
+    /* 0xB8 */ {"CLV", CPU::M_IMP, 1, true },
+    /* 0xB9 */ {"LDA", CPU::M_ABY, 3, true },
+    /* 0xBA */ {"TSX", CPU::M_IMP, 1, true },
+    /* 0xBB */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0xBC */ {"LDY", CPU::M_ABX, 3, true },
+    /* 0xBD */ {"LDA", CPU::M_ABX, 3, true },
+    /* 0xBE */ {"LDX", CPU::M_ABY, 3, true },
+    /* 0xBF */ {"LAX", CPU::M_ABY, 3, false},
+
+    /* 0xC0 */ {"CPY", CPU::M_IMM, 2, true },
+    /* 0xC1 */ {"CMP", CPU::M_IZX, 2, true },
+    /* 0xC2 */ {"NOP", CPU::M_IMM, 2, false},
+    /* 0xC3 */ {"DCP", CPU::M_IZX, 2, false},
+    /* 0xC4 */ {"CPY", CPU::M_ZP0, 2, true },
+    /* 0xC5 */ {"CMP", CPU::M_ZP0, 2, true },
+    /* 0xC6 */ {"DEC", CPU::M_ZP0, 2, true },
+    /* 0xC7 */ {"DCP", CPU::M_ZP0, 2, false},
+    /* 0xC8 */ {"INY", CPU::M_IMP, 1, true },
+    /* 0xC9 */ {"CMP", CPU::M_IMM, 2, true },
+    /* 0xCA */ {"DEX", CPU::M_IMP, 1, true },
+    /* 0xCB */ {"SBX", CPU::M_IMM, 2, false},
+    /* 0xCC */ {"CPY", CPU::M_ABS, 3, true },
+    /* 0xCD */ {"CMP", CPU::M_ABS, 3, true },
+    /* 0xCE */ {"DEC", CPU::M_ABS, 3, true },
+    /* 0xCF */ {"DCP", CPU::M_ABS, 3, false},
+
+    /* 0xD0 */ {"BNE", CPU::M_REL, 2, true },
+    /* 0xD1 */ {"CMP", CPU::M_IZY, 2, true },
+    /* 0xD2 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0xD3 */ {"DCP", CPU::M_IZY, 2, false},
+    /* 0xD4 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0xD5 */ {"CMP", CPU::M_ZPX, 2, true },
+    /* 0xD6 */ {"DEC", CPU::M_ZPX, 2, true },
+    /* 0xD7 */ {"DCP", CPU::M_ZPX, 2, false},
+    /* 0xD8 */ {"CLD", CPU::M_IMP, 1, true },
+    /* 0xD9 */ {"CMP", CPU::M_ABY, 3, true },
+    /* 0xDA */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0xDB */ {"DCP", CPU::M_ABY, 3, false},
+    /* 0xDC */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0xDD */ {"CMP", CPU::M_ABX, 3, true },
+    /* 0xDE */ {"DEC", CPU::M_ABX, 3, true },
+    /* 0xDF */ {"DCP", CPU::M_ABX, 3, false},
+
+    /* 0xE0 */ {"CPX", CPU::M_IMM, 2, true },
+    /* 0xE1 */ {"SBC", CPU::M_IZX, 2, true },
+    /* 0xE2 */ {"NOP", CPU::M_IMM, 2, false},
+    /* 0xE3 */ {"ISC", CPU::M_IZX, 2, false},
+    /* 0xE4 */ {"CPX", CPU::M_ZP0, 2, true },
+    /* 0xE5 */ {"SBC", CPU::M_ZP0, 2, true },
+    /* 0xE6 */ {"INC", CPU::M_ZP0, 2, true },
+    /* 0xE7 */ {"ISC", CPU::M_ZP0, 2, false},
+    /* 0xE8 */ {"INX", CPU::M_IMP, 1, true },
+    /* 0xE9 */ {"SBC", CPU::M_IMM, 2, true },
+    /* 0xEA */ {"NOP", CPU::M_IMP, 1, true },
+    /* 0xEB */ {"SBC", CPU::M_IMM, 2, false},
+    /* 0xEC */ {"CPX", CPU::M_ABS, 3, true },
+    /* 0xED */ {"SBC", CPU::M_ABS, 3, true },
+    /* 0xEE */ {"INC", CPU::M_ABS, 3, true },
+    /* 0xEF */ {"ISC", CPU::M_ABS, 3, false},
+
+    /* 0xF0 */ {"BEQ", CPU::M_REL, 2, true },
+    /* 0xF1 */ {"SBC", CPU::M_IZY, 2, true },
+    /* 0xF2 */ {"XXX", CPU::M_IMP, 1, false},
+    /* 0xF3 */ {"ISC", CPU::M_IZY, 2, false},
+    /* 0xF4 */ {"NOP", CPU::M_ZPX, 2, false},
+    /* 0xF5 */ {"SBC", CPU::M_ZPX, 2, true },
+    /* 0xF6 */ {"INC", CPU::M_ZPX, 2, true },
+    /* 0xF7 */ {"ISC", CPU::M_ZPX, 2, false},
+    /* 0xF8 */ {"SED", CPU::M_IMP, 1, true },
+    /* 0xF9 */ {"SBC", CPU::M_ABY, 3, true },
+    /* 0xFA */ {"NOP", CPU::M_IMP, 1, false},
+    /* 0xFB */ {"ISC", CPU::M_ABY, 3, false},
+    /* 0xFC */ {"NOP", CPU::M_ABX, 3, false},
+    /* 0xFD */ {"SBC", CPU::M_ABX, 3, true },
+    /* 0xFE */ {"INC", CPU::M_ABX, 3, true },
+    /* 0xFF */ {"ISC", CPU::M_ABX, 3, false}
+};
+
+static_assert(OPCODE_TABLE[0x4C].length == 3 && OPCODE_TABLE[0x0A].mode == CPU::M_ACC,
+              "OPCODE_TABLE out of sync");
+
+#endif // OPCODE_TABLE_H
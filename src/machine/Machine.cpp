@@ -0,0 +1,156 @@
+#include "Machine.h"
+
+
+Machine::Machine(Accuracy accuracy)
+    : _accuracy(accuracy),
+      _cpu(accuracy),
+      _frameCount(0)
+{
+    _bus.ConnectMemory(&_memory);
+    _bus.ConnectCPU(&_cpu);
+    _bus.ConnectPPU(&_ppu);
+}
+
+Machine::~Machine()
+{
+    SetPipelinedPPU(false);
+}
+
+bool Machine::LoadFromFile(const std::string& filename)
+{
+    // The render thread has a copy of the old cartridge
+    bool pipelined = IsPipelinedPPU();
+    SetPipelinedPPU(false);
+
+    if (!_cartridge.LoadFromFile(filename))
+        return false;
+
+    _bus.InsertCartridge(&_cartridge);
+    Reset();
+    return SetPipelinedPPU(pipelined);
+}
+
+bool Machine::LoadFromMemory(const std::vector<uint8_t>& romData)
+{
+    bool pipelined = IsPipelinedPPU();
+    SetPipelinedPPU(false);
+
+    if (!_cartridge.LoadFromMemory(romData))
+        return false;
+
+    _bus.InsertCartridge(&_cartridge);
+    Reset();
+    return SetPipelinedPPU(pipelined);
+}
+
+void Machine::Reset()
+{
+    _bus.Reset();
+    _frameCount = 0;
+}
+
+void Machine::RunFrame()
+{
+    switch (_accuracy)
+    {
+    case Accuracy::FAST:     RunFrameAs<FastAccuracy>(); break;
+    case Accuracy::BALANCED: RunFrameAs<BalancedAccuracy>(); break;
+    case Accuracy::EXACT:    RunFrameAs<ExactAccuracy>(); break;
+    }
+}
+
+template <class Policy>
+void Machine::RunFrameAs()
+{
+    do
+    {
+        _bus.Tick<Policy>();
+    } while (!_ppu.IsFrameComplete());
+
+    _ppu.ClearFrameComplete();
+    ++_frameCount;
+
+    if (_pipeline)
+        _pipeline->Sync();
+}
+
+Machine::Machine(Machine& source, ForkTag)
+    : _accuracy(source._accuracy),
+      _memory(source._memory),
+      _cpu(source._cpu),
+      _ppu(source._ppu),
+      _cartridge(source._cartridge),
+      _frameCount(source._frameCount)
+{
+    _bus.CopyStateFrom(source._bus);
+    _bus.ConnectMemory(&_memory);
+    RewireCopiedParts(source);
+}
+
+std::unique_ptr<Machine> Machine::Fork()
+{
+    // The render thread holds the pixels of a pipelined machine
+    if (_pipeline)
+        _pipeline->Sync();
+
+    return std::unique_ptr<Machine>(new Machine(*this, ForkTag()));
+}
+
+void Machine::CopyStateFrom(Machine& other)
+{
+    if (&other == this)
+        return;
+
+    SetPipelinedPPU(false);
+
+    // The render thread holds the pixels of a pipelined machine
+    if (other._pipeline)
+        other._pipeline->Sync();
+
+    _accuracy = other._accuracy;
+    _memory = other._memory;
+    _cpu = other._cpu;
+    _ppu = other._ppu;
+    _cartridge = other._cartridge;
+    _bus.CopyStateFrom(other._bus);
+    _frameCount = other._frameCount;
+
+    RewireCopiedParts(other);
+}
+
+void Machine::RewireCopiedParts(const Machine& source)
+{
+    // The copies still point at the source machine's parts
+    _ppu.AttachPipeline(nullptr);
+    _ppu.SetOutputBuffer(nullptr, 0);
+    if (source._pipeline)
+    {
+        _ppu.SetSkipRender(source._pipeline->GetRenderer().IsSkipRender());
+        _ppu.CopyScreen(source._pipeline->GetRenderer());
+    }
+
+    _bus.ConnectCPU(&_cpu);
+    _bus.ConnectPPU(&_ppu);
+    _bus.InsertCartridge(source._cartridge.IsLoaded() ? &_cartridge : nullptr);
+}
+
+bool Machine::SetPipelinedPPU(bool enabled)
+{
+    if (!enabled)
+    {
+        _pipeline.reset();
+        return true;
+    }
+
+    if (_pipeline)
+        return true;
+
+    _pipeline = std::make_unique<PPUPipeline>();
+    if (!_pipeline->Start(&_ppu, _cartridge.IsLoaded() ? &_cartridge : nullptr))
+    {
+        _pipeline.reset();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef MACHINE_H
+#define MACHINE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bus/Bus.h"
+#include "ppu/PPUPipeline.h"
+
+
+// A complete headless console: owns and wires every component.
+// Tools and tests that just want to "run a ROM" use this instead of
+// connecting CPU/PPU/Memory/Cartridge to a Bus by hand.
+class Machine
+{
+public:
+    // The accuracy tier is fixed for the machine's lifetime (see Accuracy.h)
+    explicit Machine(Accuracy accuracy = Accuracy::BALANCED);
+    ~Machine();
+
+    Machine(const Machine&) = delete;
+    Machine& operator=(const Machine&) = delete;
+
+    bool LoadFromFile(const std::string& filename);
+    bool LoadFromMemory(const std::vector<uint8_t>& romData);
+
+    void Reset();
+
+    // Clock until the PPU finishes the current frame
+    void RunFrame();
+
+    // Render on a second thread (see PPUPipeline). Frames come out
+    // identical; RunFrame() waits for the render thread at the end.
+    bool SetPipelinedPPU(bool enabled);
+    bool IsPipelinedPPU() const { return _pipeline != nullptr; }
+
+    // Independent copy of the whole console at this instant. ROM is
+    // shared; RAM, VRAM and cartridge RAM are shared page by page until
+    // either side writes. The fork runs serially and has no tools, input
+    // providers or output buffer attached.
+    // Forking also takes this machine's in-place write access to the pages
+    // it now shares, so it must not be running on another thread at the
+    // time. Afterwards the fork and this machine may run on any threads.
+    std::unique_ptr<Machine> Fork();
+
+    // Turn this machine into a fork of another, reusing its allocation
+    // (stops this machine's render thread first). Takes on the other's
+    // accuracy too.
+    void CopyStateFrom(Machine& other);
+
+    void SetControllerState(int index, uint8_t state) { _bus.SetControllerState(index, state); }
+
+    Bus& GetBus() { return _bus; }
+    CPU& GetCPU() { return _cpu; }
+    PPU& GetPPU() { return _ppu; }
+    Memory& GetMemory() { return _memory; }
+    Cartridge& GetCartridge() { return _cartridge; }
+
+    uint64_t GetFrameCount() const { return _frameCount; }
+    Accuracy GetAccuracy() const { return _accuracy; }
+
+private:
+    // Fork(): every part is copy-constructed from the source, so none of
+    // them runs its own init (or logs) only to be overwritten
+    struct ForkTag {};
+    Machine(Machine& source, ForkTag);
+
+    // Point the copied parts at this machine instead of the source's
+    void RewireCopiedParts(const Machine& source);
+
+    template <class Policy> void RunFrameAs();
+
+    Accuracy _accuracy;
+    Memory _memory;
+    CPU _cpu;
+    PPU _ppu;
+    Cartridge _cartridge;
+    Bus _bus;
+    std::unique_ptr<PPUPipeline> _pipeline;
+
+    uint64_t _frameCount;
+};
+
+#endif // MACHINE_H
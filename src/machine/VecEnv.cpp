@@ -0,0 +1,219 @@
+#include <algorithm>
+
+#include "VecEnv.h"
+#include "ppu/Palette.h"
+#include "utils/Logger.h"
+
+
+VecEnv::VecEnv()
+    : _observationSize(0),
+      _luma(),
+      _actions(nullptr),
+      _next(0),
+      _batch(0),
+      _pending(0),
+      _stop(false)
+{
+    // BT.601 luma, full range
+    for (size_t i = 0; i < _luma.size(); ++i)
+    {
+        uint32_t argb = Palette::ARGB[i];
+        uint32_t r = (argb >> 16) & 0xFF;
+        uint32_t g = (argb >> 8) & 0xFF;
+        uint32_t b = argb & 0xFF;
+        _luma[i] = (uint8_t) ((77 * r + 150 * g + 29 * b + 128) >> 8);
+    }
+}
+
+VecEnv::~VecEnv()
+{
+    StopWorkers();
+}
+
+bool VecEnv::Init(const std::vector<uint8_t>& romData, size_t count, const Config& config)
+{
+    StopWorkers();
+
+    if (count == 0 || config.frameSkip < 1
+        || (config.downsample != 1 && config.downsample != 2 && config.downsample != 4))
+    {
+        LOG_ERROR("Invalid environment configuration");
+        return false;
+    }
+
+    _config = config;
+    _snapshot = std::make_unique<Machine>(_config.accuracy);
+    if (!_snapshot->LoadFromMemory(romData))
+        return false;
+
+    _machines.clear();
+    for (size_t i = 0; i < count; ++i)
+        _machines.push_back(std::make_unique<Machine>(_config.accuracy));
+
+    _observationSize = (_config.frames ? (size_t) GetFrameWidth() * GetFrameHeight() : 0)
+                     + (_config.ram ? RAM_SIZE : 0);
+    _observations.assign(count * _observationSize, 0);
+
+    Reset();
+
+    unsigned threads = _config.threads ? _config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned) std::min<size_t>(threads, count);
+
+    _stop = false;
+    for (unsigned t = 1; t < threads; ++t)
+        _workers.emplace_back(&VecEnv::WorkerLoop, this, _batch);
+
+    LOG_INFO("%zu environments, %u threads, %zu-byte observations", count, threads, _observationSize);
+    return true;
+}
+
+int VecEnv::GetFrameWidth() const
+{
+    return _config.frames ? PPU::SCREEN_WIDTH / _config.downsample : 0;
+}
+
+int VecEnv::GetFrameHeight() const
+{
+    return _config.frames ? PPU::SCREEN_HEIGHT / _config.downsample : 0;
+}
+
+void VecEnv::Reset()
+{
+    for (size_t i = 0; i < _machines.size(); ++i)
+        Reset(i);
+}
+
+void VecEnv::Reset(size_t index)
+{
+    _machines[index]->CopyStateFrom(*_snapshot);
+    Observe(index);
+}
+
+void VecEnv::Step(const uint8_t* actions)
+{
+    _actions = actions;
+    RunBatch();
+    _actions = nullptr;
+}
+
+void VecEnv::StepOne(size_t index)
+{
+    Machine& machine = *_machines[index];
+    PPU& ppu = machine.GetPPU();
+
+    machine.SetControllerState(0, _actions[index]);
+    for (int frame = 0; frame < _config.frameSkip; ++frame)
+    {
+        // Only the last frame's pixels are looked at
+        ppu.SetSkipRender(!_config.frames || frame + 1 < _config.frameSkip);
+        machine.RunFrame();
+    }
+
+    Observe(index);
+}
+
+void VecEnv::Observe(size_t index)
+{
+    Machine& machine = *_machines[index];
+    uint8_t* out = &_observations[index * _observationSize];
+
+    if (_config.frames)
+    {
+        const uint8_t* screen = machine.GetPPU().GetScreenBuffer();
+        const int scale = _config.downsample;
+        const int width = GetFrameWidth();
+        const int height = GetFrameHeight();
+
+        if (!_config.grayscale)
+        {
+            // Palette indices: nearest sample
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8_t* row = screen + y * scale * PPU::SCREEN_WIDTH;
+                for (int x = 0; x < width; ++x)
+                    *out++ = row[x * scale] & 0x3F;
+            }
+        }
+        else if (scale == 1)
+        {
+            for (int i = 0; i < PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT; ++i)
+                *out++ = _luma[screen[i] & 0x3F];
+        }
+        else
+        {
+            // Box filter over scale x scale blocks
+            const int shift = scale == 2 ? 2 : 4;
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8_t* row = screen + y * scale * PPU::SCREEN_WIDTH;
+                for (int x = 0; x < width; ++x)
+                {
+                    uint32_t sum = 0;
+                    for (int dy = 0; dy < scale; ++dy)
+                        for (int dx = 0; dx < scale; ++dx)
+                            sum += _luma[row[dy * PPU::SCREEN_WIDTH + x * scale + dx] & 0x3F];
+                    *out++ = (uint8_t) (sum >> shift);
+                }
+            }
+        }
+    }
+
+    if (_config.ram)
+        machine.GetMemory().CopyTo(0x0000, out, RAM_SIZE);
+}
+
+void VecEnv::RunBatch()
+{
+    _next.store(0, std::memory_order_relaxed);
+
+    if (!_workers.empty())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_batch;
+        _pending = (unsigned) _workers.size();
+        _wake.notify_all();
+    }
+
+    for (size_t i; (i = _next.fetch_add(1, std::memory_order_relaxed)) < _machines.size(); )
+        StepOne(i);
+
+    if (!_workers.empty())
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _pending == 0; });
+    }
+}
+
+void VecEnv::WorkerLoop(uint64_t seen)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (;;)
+    {
+        _wake.wait(lock, [&] { return _stop || _batch != seen; });
+        if (_stop)
+            break;
+        seen = _batch;
+        lock.unlock();
+
+        for (size_t i; (i = _next.fetch_add(1, std::memory_order_relaxed)) < _machines.size(); )
+            StepOne(i);
+
+        lock.lock();
+        if (--_pending == 0)
+            _done.notify_one();
+    }
+}
+
+void VecEnv::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _wake.notify_all();
+    }
+
+    for (std::thread& worker : _workers)
+        worker.join();
+    _workers.clear();
+}
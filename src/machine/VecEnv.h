@@ -0,0 +1,106 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Machine.h"
+
+
+// A batch of machines running the same ROM, stepped together with one
+// controller byte each (reinforcement learning environments).
+//
+// Step() runs every machine for frameSkip frames on a fixed pool of
+// worker threads and writes one observation per machine into a single
+// preallocated buffer: the last frame (optionally grayscale and
+// downsampled) followed by the 2KB of CPU RAM. Frames that are not
+// observed skip pixel output. Reset() turns machines back into forks of
+// the snapshot machine, so their memory is shared with it until written.
+//
+// Stepping allocates nothing apart from the first write to each page
+// after a reset.
+class VecEnv
+{
+public:
+    struct Config
+    {
+        int frameSkip = 4;      // Frames per Step(), same action held (>= 1)
+        int downsample = 1;     // 1, 2 or 4; grayscale averages each block
+        bool frames = true;     // Include the screen in the observation
+        bool grayscale = true;  // Luma instead of palette indices
+        bool ram = true;        // Include $0000-$07FF
+        unsigned threads = 0;   // Including the caller; 0 = hardware concurrency
+        Accuracy accuracy = Accuracy::BALANCED;
+    };
+
+    static constexpr size_t RAM_SIZE = 0x0800;
+
+    VecEnv();
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    // Load the ROM into the snapshot machine (power-on state) and set up
+    // `count` environments reset to it
+    bool Init(const std::vector<uint8_t>& romData, size_t count, const Config& config);
+
+    // The state Reset() goes back to. Run or load it, then Reset().
+    Machine& GetSnapshot() { return *_snapshot; }
+
+    // Back to the snapshot; refreshes the observations of those machines
+    void Reset();
+    void Reset(size_t index);
+
+    // Hold actions[i] on pad 1 of machine i for frameSkip frames
+    void Step(const uint8_t* actions);
+
+    size_t GetCount() const { return _machines.size(); }
+    Machine& GetMachine(size_t index) { return *_machines[index]; }
+
+    // GetCount() observations of GetObservationSize() bytes each: a
+    // GetFrameWidth() x GetFrameHeight() frame, then the RAM
+    const uint8_t* GetObservations() const { return _observations.data(); }
+    const uint8_t* GetObservation(size_t index) const { return &_observations[index * _observationSize]; }
+    size_t GetObservationSize() const { return _observationSize; }
+    int GetFrameWidth() const;
+    int GetFrameHeight() const;
+
+private:
+    void Observe(size_t index);
+    void StepOne(size_t index);
+
+    // Worker threads share out the machines through _next; the calling
+    // thread works too. Workers start at the batch count of their creation.
+    void RunBatch();
+    void WorkerLoop(uint64_t seen);
+    void StopWorkers();
+
+    Config _config;
+    std::unique_ptr<Machine> _snapshot;
+    std::vector<std::unique_ptr<Machine>> _machines;
+
+    std::vector<uint8_t> _observations;
+    size_t _observationSize;
+    std::array<uint8_t, 64> _luma; // Palette index to 8-bit luma
+
+    const uint8_t* _actions;
+
+    std::vector<std::thread> _workers;
+    std::atomic<size_t> _next;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    uint64_t _batch;    // Bumped per RunBatch(), under _mutex
+    unsigned _pending;  // Workers still in the current batch
+    bool _stop;
+};
+
+#endif // VEC_ENV_H
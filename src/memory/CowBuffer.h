@@ -0,0 +1,156 @@
+#ifndef COW_BUFFER_H
+#define COW_BUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+
+// Fixed-size byte buffer split into pages that copies share until one of
+// them writes (copy-on-write). Copying is how a buffer gets forked: the
+// copy and the source both see every page as shared, and the first write
+// to a page gives the writer its own. Never-written pages all point at one
+// zero page.
+//
+// An instance belongs to one thread; copies may move to other threads,
+// since pages are reference counted and never written while shared.
+// Copying revokes the source's in-place writes too, so the source must
+// not be in use on another thread while it is copied.
+template <size_t SIZE, size_t PAGE_SIZE>
+class CowBuffer
+{
+    static_assert(PAGE_SIZE && (PAGE_SIZE & (PAGE_SIZE - 1)) == 0, "Page size must be a power of two");
+    static_assert(SIZE % PAGE_SIZE == 0, "Size must be a whole number of pages");
+
+public:
+    static constexpr size_t PAGE_COUNT = SIZE / PAGE_SIZE;
+
+    CowBuffer() { Clear(); }
+
+    CowBuffer(const CowBuffer& other) { *this = other; }
+
+    CowBuffer& operator=(const CowBuffer& other)
+    {
+        if (this != &other)
+        {
+            _pages = other._pages;
+            _read = other._read;
+        }
+
+        // Neither side may write in place any more
+        _writable.fill(nullptr);
+        other._writable.fill(nullptr);
+        return *this;
+    }
+
+    uint8_t Read(size_t offset) const
+    {
+        return _read[offset / PAGE_SIZE][offset % PAGE_SIZE];
+    }
+
+    void Write(size_t offset, uint8_t value)
+    {
+        GetWritablePage(offset / PAGE_SIZE)[offset % PAGE_SIZE] = value;
+    }
+
+    // Page contents; a pointer stays valid until this buffer writes to a
+    // shared page (see IsShared) or is cleared or assigned
+    const uint8_t* GetPage(size_t page) const { return _read[page]; }
+
+    uint8_t* GetWritablePage(size_t page)
+    {
+        uint8_t* data = _writable[page];
+        return data ? data : Detach(page);
+    }
+
+    // True until this buffer has its own copy of the page, i.e. the next
+    // write to it moves the page
+    bool IsShared(size_t page) const { return !_writable[page]; }
+
+    // Pages this buffer does not share with anything (tests, statistics)
+    size_t GetOwnedPageCount() const
+    {
+        size_t owned = 0;
+        for (size_t i = 0; i < PAGE_COUNT; ++i)
+            owned += _pages[i] != ZeroPage() && _pages[i].use_count() == 1;
+        return owned;
+    }
+
+    // Back to all zeroes; drops every page
+    void Clear()
+    {
+        for (size_t i = 0; i < PAGE_COUNT; ++i)
+        {
+            _pages[i] = ZeroPage();
+            _read[i] = _pages[i]->data();
+        }
+        _writable.fill(nullptr);
+    }
+
+    void CopyTo(size_t offset, uint8_t* out, size_t size) const
+    {
+        while (size)
+        {
+            size_t chunk = std::min(size, PAGE_SIZE - offset % PAGE_SIZE);
+            std::memcpy(out, _read[offset / PAGE_SIZE] + offset % PAGE_SIZE, chunk);
+            offset += chunk;
+            out += chunk;
+            size -= chunk;
+        }
+    }
+
+    void CopyFrom(size_t offset, const uint8_t* in, size_t size)
+    {
+        while (size)
+        {
+            size_t chunk = std::min(size, PAGE_SIZE - offset % PAGE_SIZE);
+            std::memcpy(GetWritablePage(offset / PAGE_SIZE) + offset % PAGE_SIZE, in, chunk);
+            offset += chunk;
+            in += chunk;
+            size -= chunk;
+        }
+    }
+
+private:
+    using Page = std::shared_ptr<std::array<uint8_t, PAGE_SIZE>>;
+
+    static const Page& ZeroPage()
+    {
+        static const Page zero = std::make_shared<std::array<uint8_t, PAGE_SIZE>>();
+        return zero;
+    }
+
+    uint8_t* Detach(size_t page)
+    {
+        // Copies only ever drop their references from other threads, so
+        // a count of one means the page is already ours alone. use_count()
+        // is a relaxed load; the fence orders our writes after the other
+        // thread's last reads of the page, which its release decrement
+        // published.
+        if (_pages[page].use_count() != 1)
+        {
+            _pages[page] = std::make_shared<std::array<uint8_t, PAGE_SIZE>>(*_pages[page]);
+            _read[page] = _pages[page]->data();
+        }
+        else
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+
+        _writable[page] = _pages[page]->data();
+        return _writable[page];
+    }
+
+    std::array<Page, PAGE_COUNT> _pages;
+    std::array<const uint8_t*, PAGE_COUNT> _read;
+
+    // Pages this buffer may write in place (nullptr while shared); copying
+    // from a buffer revokes its own as well
+    mutable std::array<uint8_t*, PAGE_COUNT> _writable;
+};
+
+#endif // COW_BUFFER_H
@@ -1,4 +1,3 @@
-#include <cstring>
 #include "Memory.h"
 
 
@@ -12,17 +11,7 @@ Memory::~Memory()
     // Nothing to clean up
 }
 
-uint8_t Memory::Read(uint16_t address) const
-{
-    return ram[address];
-}
-
-void Memory::Write(uint16_t address, uint8_t value)
-{
-    ram[address] = value;
-}
-
 void Memory::Clear()
 {
-    std::memset(ram, 0, sizeof(ram));
+    _ram.Clear();
 }
\ No newline at end of file
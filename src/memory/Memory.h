@@ -2,8 +2,11 @@
 #define MEMORY_H
 
 
+#include <cstddef>
 #include <cstdint>
 
+#include "CowBuffer.h"
+
 
 class Memory
 {
@@ -11,17 +14,29 @@ public:
     Memory();
     virtual ~Memory();
 
+    // Copies share pages until either side writes (see CowBuffer)
+    Memory(const Memory&) = default;
+    Memory& operator=(const Memory&) = default;
+
     // Read a byte from memory
-    uint8_t Read(uint16_t address) const;
+    uint8_t Read(uint16_t address) const { return _ram.Read(address); }
 
     // Write a byte to memory
-    void Write(uint16_t address, uint8_t value);
+    void Write(uint16_t address, uint8_t value) { _ram.Write(address, value); }
 
     // Clear all memory to zero
     void Clear();
 
+    // Copy a range out (state hashing, snapshots)
+    void CopyTo(uint16_t address, uint8_t* out, size_t size) const { _ram.CopyTo(address, out, size); }
+    static constexpr size_t SIZE = 0x10000;
+    static constexpr size_t PAGE_SIZE = 0x0400;
+
+    // 1KB pages written since the last copy (tests, statistics)
+    size_t GetOwnedPageCount() const { return _ram.GetOwnedPageCount(); }
+
 private:
     // 64KB of memory
-    uint8_t ram[0x10000];
+    CowBuffer<SIZE, PAGE_SIZE> _ram;
 };
 #endif // MEMORY_H
\ No newline at end of file
@@ -1,22 +1,11 @@
 #include <iostream>
 
 #include "Display.h"
+#include "Palette.h"
 #include "controller/Controller.h"
 #include "utils/Logger.h"
 
 
-// NES Color Palette (RGB values for all 64 colors)
-const std::array<uint32_t, 64> Display::_nesPalette = {
-    0xFF545454, 0xFF001E74, 0xFF081090, 0xFF300088, 0xFF440064, 0xFF5C0030, 0xFF540400, 0xFF3C1800,
-    0xFF202A00, 0xFF083A00, 0xFF004000, 0xFF003C00, 0xFF00323C, 0xFF000000, 0xFF000000, 0xFF000000,
-    0xFF989698, 0xFF084CC4, 0xFF3032EC, 0xFF5C1EE4, 0xFF8814B0, 0xFFA01464, 0xFF982220, 0xFF783C00,
-    0xFF545A00, 0xFF287200, 0xFF087C00, 0xFF007628, 0xFF006678, 0xFF000000, 0xFF000000, 0xFF000000,
-    0xFFECEEEC, 0xFF4C9AEC, 0xFF787CEC, 0xFFB062EC, 0xFFE454EC, 0xFFEC58B4, 0xFFEC6A64, 0xFFD48820,
-    0xFFA0AA00, 0xFF74C400, 0xFF4CD020, 0xFF38CC6C, 0xFF38B4CC, 0xFF3C3C3C, 0xFF000000, 0xFF000000,
-    0xFFECEEEC, 0xFFA8CCEC, 0xFFBCBCEC, 0xFFD4B2EC, 0xFFECAEEC, 0xFFECAED4, 0xFFECB4B0, 0xFFE4C490,
-    0xFFCCD278, 0xFFB4DE78, 0xFFA8E290, 0xFF98E2B4, 0xFFA0D6E4, 0xFFA0A2A0, 0xFF000000, 0xFF000000
-};
-
 Display::Display(const char* title, int width, int height, int scale)
 {
     _title = title;
@@ -108,18 +97,39 @@ void Display::Render(const uint8_t* screenBuffer)
         return;
     }
 
+    ConvertFrame(screenBuffer, pixels, pitch);
+
+    SDL_UnlockTexture(_texture);
+    SDL_RenderCopy(_renderer, _texture, nullptr, nullptr);
+}
+
+bool Display::LockFrame(uint32_t** pixels, int* pitch)
+{
+    if (SDL_LockTexture(_texture, nullptr, (void**) pixels, pitch) < 0)
+    {
+        LOG_ERROR("Failed to lock texture: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void Display::UnlockFrame()
+{
+    SDL_UnlockTexture(_texture);
+    SDL_RenderCopy(_renderer, _texture, nullptr, nullptr);
+}
+
+void Display::ConvertFrame(const uint8_t* screenBuffer, uint32_t* pixels, int pitch)
+{
     // Convert NES palette indices to RGB
     for (int y = 0; y < NES_HEIGHT; ++y)
     {
         for (int x = 0; x < NES_WIDTH; ++x)
         {
             uint8_t paletteIndex = screenBuffer[y * NES_WIDTH + x] & 0x3F;
-            pixels[y * (pitch / 4) + x] = _nesPalette[paletteIndex];
+            pixels[y * (pitch / 4) + x] = Palette::ARGB[paletteIndex];
         }
     }
-
-    SDL_UnlockTexture(_texture);
-    SDL_RenderCopy(_renderer, _texture, nullptr, nullptr);
 }
 
 void Display::Present()
@@ -174,6 +184,12 @@ void Display::Shutdown()
     SDL_Quit();
 }
 
+uint8_t Display::PollControllerState(int deviceIndex) const
+{
+    SDL_PumpEvents();
+    return GetControllerState(deviceIndex);
+}
+
 uint8_t Display::GetControllerState(int deviceIndex) const
 {
     if (deviceIndex < 0 || deviceIndex >= MAX_PLAYERS)
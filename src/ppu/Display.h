@@ -16,6 +16,14 @@ public:
     bool Init();
     void Clear();
     void Render(const uint8_t* screenBuffer);
+
+    // Convert a frame of palette indices to ARGB8888 (pitch in bytes)
+    static void ConvertFrame(const uint8_t* screenBuffer, uint32_t* pixels, int pitch);
+
+    // Direct output: lock the streaming texture for the PPU to draw into
+    // (see PPU::SetOutputBuffer), then unlock and copy it to the renderer
+    bool LockFrame(uint32_t** pixels, int* pitch);
+    void UnlockFrame();
     void Present();
     bool IsRunning() const { return _running; }
     void HandleEvents();
@@ -28,6 +36,10 @@ public:
     // into an NES controller byte.
     uint8_t GetControllerState(int deviceIndex) const;
 
+    // Pump pending SDL input, then read one player's state; used as a
+    // Controller::InputProvider. Main thread only (SDL event rule).
+    uint8_t PollControllerState(int deviceIndex) const;
+
     static constexpr int NES_WIDTH = 256;
     static constexpr int NES_HEIGHT = 240;
     static constexpr int MAX_PLAYERS = 2;
@@ -45,9 +57,6 @@ private:
     int _windowHeight;
     int _scale;
     bool _running;
-
-    // NES Color Palette (64 colors)
-    static const std::array<uint32_t, 64> _nesPalette;
 };
 
 #endif // DISPLAY_H
\ No newline at end of file
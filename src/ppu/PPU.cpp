@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <iostream>
 
 #include "PPU.h"
+#include "PPUPipeline.h"
+#include "Palette.h"
 #include "bus/Bus.h"
 #include "cartridge/Cartridge.h"
+#include "utils/Debugger.h"
 #include "utils/Logger.h"
 
 
@@ -24,11 +28,24 @@ PPU::PPU()
       _frameComplete(false),
       _nmiOutput(false),
       _frameCount(0),
+      _dot(0),
+      _outputPixels(nullptr),
+      _outputPitch(0),
+      _skipRender(false),
+      _spriteShifterLo(0),
+      _spriteShifterHi(0),
+      _spriteX(0),
+      _spriteLanes(0),
       _spriteCount(0),
       _sprite0HitPossible(false),
       _sprite0Rendering(false),
+      _spriteBinsValid(false),
+      _spriteBinsFrame(~0ULL),
+      _patternTableWrites(0),
       _bus(nullptr),
-	  _cartridge(nullptr)
+	  _cartridge(nullptr),
+      _debugger(nullptr),
+      _pipeline(nullptr)
 {
     LOG_INFO("PPU Init");
 
@@ -38,12 +55,20 @@ PPU::PPU()
     _vramAddr.reg = 0;
     _tramAddr.reg = 0;
 
-    _nametable.fill(0);
+    _nametable.Clear();
     _palette.fill(0);
     _oam.fill(0);
     _secondaryOam.fill(0);
     _screen.fill(0);
     _patternTable.fill(0);
+    _spriteBins.fill(0);
+    _spriteBinCount.fill(0);
+    _spriteBinOverflow.fill(0);
+    _spriteBinPatternLo.fill(0);
+    _spriteBinPatternHi.fill(0);
+    InvalidateSpriteBins();
+    UpdateNametableMapping();
+    UpdatePaletteCache();
     
     _bgShifters.patternLo = 0;
     _bgShifters.patternHi = 0;
@@ -55,6 +80,9 @@ void PPU::Reset()
 {
     LOG_INFO("PPU Reset");
 
+    if (_pipeline)
+        _pipeline->Push(_dot, PPUPipeline::EVENT_RESET, 0, 0);
+
     _ctrl.reg = 0;
     _mask.reg = 0;
     _status.reg = 0;
@@ -69,6 +97,10 @@ void PPU::Reset()
     _cycle = 0;
     _frameComplete = false;
     _nmiOutput = false;
+
+    InvalidateSpriteBins();
+    UpdateNametableMapping();
+    UpdatePaletteCache();
     
     _bgShifters.patternLo = 0;
     _bgShifters.patternHi = 0;
@@ -76,46 +108,111 @@ void PPU::Reset()
     _bgShifters.attributeHi = 0;
 }
 
-// address here is already masked to 0x0000-0x0FFF (the 4 logical nametables)
-uint16_t PPU::MapNametable(uint16_t address) const
+void PPU::UpdateNametableMapping()
 {
     MirrorMode mode = _cartridge ? _cartridge->GetMirrorMode()
                                  : MIRROR_MODE_HORIZONTAL;
-    uint16_t table = (address & 0x0C00) >> 10;  // which of the 4 logical NTs (0-3)
-    uint16_t offset = address & 0x03FF;
 
-    uint16_t physical = 0; // which physical 1KB nametable (0 or 1)
+    // Physical 1KB page for each of the 4 logical nametables
+    uint8_t pages[4];
     switch (mode)
     {
         case MIRROR_MODE_VERTICAL:
             // NT0,NT2 -> physical 0 ; NT1,NT3 -> physical 1
-            physical = (table & 0x01);
-            break;
-        case MIRROR_MODE_HORIZONTAL:
-            // NT0,NT1 -> physical 0 ; NT2,NT3 -> physical 1
-            physical = (table >> 1);
+            pages[0] = 0; pages[1] = 1; pages[2] = 0; pages[3] = 1;
             break;
         case MIRROR_MODE_ONE_SCREEN_LOWER:
-            physical = 0;
+            pages[0] = 0; pages[1] = 0; pages[2] = 0; pages[3] = 0;
             break;
         case MIRROR_MODE_ONE_SCREEN_UPPER:
-            physical = 1;
+            pages[0] = 1; pages[1] = 1; pages[2] = 1; pages[3] = 1;
+            break;
+        case MIRROR_MODE_FOUR_SCREEN:
+            // Pages 2 and 3 live in the extra VRAM on the cartridge
+            pages[0] = 0; pages[1] = 1; pages[2] = 2; pages[3] = 3;
             break;
+        case MIRROR_MODE_HORIZONTAL:
         default:
-            physical = (table >> 1); // treat unknown as horizontal
+            // NT0,NT1 -> physical 0 ; NT2,NT3 -> physical 1
+            pages[0] = 0; pages[1] = 0; pages[2] = 1; pages[3] = 1;
             break;
     }
-    return physical * 0x0400 + offset;
+
+    for (int i = 0; i < 4; ++i)
+        _nametablePage[i] = pages[i] * 0x0400;
+}
+
+void PPU::OnCartridgeWrite(uint16_t address, uint8_t value)
+{
+    if (_pipeline)
+        _pipeline->Push(_dot, PPUPipeline::EVENT_CARTRIDGE_WRITE, address, value);
+
+    UpdateNametableMapping();
+}
+
+const uint8_t* PPU::GetScreenBuffer() const
+{
+    return _pipeline ? _pipeline->GetScreenBuffer() : _screen.data();
 }
 
+void PPU::SetOutputBuffer(uint32_t* pixels, int pitch)
+{
+    if (_pipeline)
+    {
+        _pipeline->SetOutputBuffer(pixels, pitch);
+        return;
+    }
+
+    _outputPixels = pixels;
+    _outputPitch = pitch / 4;
+}
+
+void PPU::SetSkipRender(bool skip)
+{
+    if (_pipeline)
+    {
+        _pipeline->Push(_dot, PPUPipeline::EVENT_SKIP_RENDER, 0, skip ? 1 : 0);
+        return;
+    }
+
+    _skipRender = skip;
+}
+
+void PPU::UpdatePaletteEntry(uint8_t entry)
+{
+    // $3F10/$3F14/$3F18/$3F1C mirror the background entries below them
+    uint8_t physical = ((entry & 0x13) == 0x10) ? (entry & 0x0F) : entry;
+    uint8_t colour = _palette[physical] & (_mask.grayscale ? 0x30 : 0x3F);
+
+    _paletteCache[entry] = colour;
+    _paletteARGB[entry] = Palette::ARGB[colour];
+}
+
+void PPU::UpdatePaletteCache()
+{
+    for (uint8_t entry = 0; entry < 32; ++entry)
+        UpdatePaletteEntry(entry);
+}
+
+uint8_t PPU::CPURead(uint16_t address)
+{
+    return CPURead<BalancedAccuracy>(address);
+}
+
+template <class Policy>
 uint8_t PPU::CPURead(uint16_t address)
 {
-    LOG_DEBUG("address=0x%04x", address);
+    if constexpr (Policy::TOOL_HOOKS)
+        LOG_DEBUG("address=0x%04x", address);
 
     uint8_t data = 0x0;
 
     address &= 0x0007; // Mirror down to $2000-$2007
 
+    // Only PPUSTATUS and PPUDATA reads change state
+    if (_pipeline && (address == 0x0002 || address == 0x0007))
+        _pipeline->Push(_dot, PPUPipeline::EVENT_REGISTER_READ, address, 0);
+
     switch (address)
     {
         case 0x0000: // PPUCTRL - write only
@@ -150,7 +247,7 @@ uint8_t PPU::CPURead(uint16_t address)
         case 0x0007: // PPUDATA
         {
             data = _ppuDataBuffer;
-            _ppuDataBuffer = PPURead(_vramAddr.reg);
+            _ppuDataBuffer = PPURead<Policy>(_vramAddr.reg);
 
             // Palette reads are not buffered
             if (_vramAddr.reg >= 0x3F00)
@@ -168,14 +265,27 @@ uint8_t PPU::CPURead(uint16_t address)
 
 void PPU::CPUWrite(uint16_t address, uint8_t data)
 {
-    LOG_DEBUG("address=0x%04x  data=0x%02x", address, data);
+    CPUWrite<BalancedAccuracy>(address, data);
+}
+
+template <class Policy>
+void PPU::CPUWrite(uint16_t address, uint8_t data)
+{
+    if constexpr (Policy::TOOL_HOOKS)
+        LOG_DEBUG("address=0x%04x  data=0x%02x", address, data);
 
     address &= 0x0007; // Mirror down to $2000-$2007
 
+    if (_pipeline)
+        _pipeline->Push(_dot, PPUPipeline::EVENT_REGISTER_WRITE, address, data);
+
     switch (address)
     {
         case 0x0000: // PPUCTRL
         {
+            if ((_ctrl.reg ^ data) & 0x20) // Sprite size changes every bin
+                _spriteBinsValid = false;
+
             _ctrl.reg = data;
             _tramAddr.nametableX = _ctrl.nametableX;
             _tramAddr.nametableY = _ctrl.nametableY;
@@ -185,7 +295,10 @@ void PPU::CPUWrite(uint16_t address, uint8_t data)
 
         case 0x0001: // PPUMASK
         {
+            bool grayscale = _mask.grayscale;
             _mask.reg = data;
+            if (_mask.grayscale != grayscale)
+                UpdatePaletteCache();
             break;
         }
 
@@ -201,6 +314,7 @@ void PPU::CPUWrite(uint16_t address, uint8_t data)
         case 0x0004: // OAMDATA
         {
             _oam[_oamAddress++] = data;
+            _spriteBinsValid = false;
             break;
         }
 
@@ -245,7 +359,7 @@ void PPU::CPUWrite(uint16_t address, uint8_t data)
 
         case 0x0007: // PPUDATA
         {
-            PPUWrite(_vramAddr.reg, data);
+            PPUWrite<Policy>(_vramAddr.reg, data);
             _vramAddr.reg += (_ctrl.incrementMode ? 32 : 1);
             break;
         }
@@ -254,7 +368,19 @@ void PPU::CPUWrite(uint16_t address, uint8_t data)
 
 uint8_t PPU::PPURead(uint16_t address)
 {
-    LOG_DEBUG("address=0x%04x", address);
+    return PPURead<BalancedAccuracy>(address);
+}
+
+template <class Policy>
+uint8_t PPU::PPURead(uint16_t address)
+{
+    if constexpr (Policy::TOOL_HOOKS)
+    {
+        LOG_DEBUG("address=0x%04x", address);
+
+        if (_debugger)
+            _debugger->OnPPURead(address);
+    }
 
     address &= 0x3FFF; // Mirror down to 14-bit address space
 
@@ -270,21 +396,12 @@ uint8_t PPU::PPURead(uint16_t address)
     // nametables
     else if (address < 0x3F00)
     {
-        address &= 0x0FFF;
-        return _nametable[MapNametable(address)];
+        return _nametable.Read(_nametablePage[(address >> 10) & 0x03] + (address & 0x03FF));
     }
     // Palette RAM
     else if (address < 0x4000)
     {
-        address &= 0x001F;
-
-        // Mirror background palette indices
-        if (address == 0x0010) address = 0x0000;
-        if (address == 0x0014) address = 0x0004;
-        if (address == 0x0018) address = 0x0008;
-        if (address == 0x001C) address = 0x000C;
-
-        return _palette[address] & (_mask.grayscale ? 0x30 : 0x3F);
+        return _paletteCache[address & 0x001F];
     }
     
     return 0x00;
@@ -292,7 +409,19 @@ uint8_t PPU::PPURead(uint16_t address)
 
 void PPU::PPUWrite(uint16_t address, uint8_t data)
 {
-    LOG_DEBUG("address=0x%04x  data=0x%02x", address, data);
+    PPUWrite<BalancedAccuracy>(address, data);
+}
+
+template <class Policy>
+void PPU::PPUWrite(uint16_t address, uint8_t data)
+{
+    if constexpr (Policy::TOOL_HOOKS)
+    {
+        LOG_DEBUG("address=0x%04x  data=0x%02x", address, data);
+
+        if (_debugger)
+            _debugger->OnPPUWrite(address, data);
+    }
 
     address &= 0x3FFF; // Mirror down to 14-bit address space
 
@@ -303,13 +432,15 @@ void PPU::PPUWrite(uint16_t address, uint8_t data)
 		if (_cartridge)
 			_cartridge->PPUWrite(address, data);
 		else
+        {
 	        _patternTable[address] = data;
+            ++_patternTableWrites;
+        }
     }
     // Nametables
     else if (address < 0x3F00)
     {
-        address &= 0x0FFF;
-        _nametable[MapNametable(address)] = data;
+        _nametable.Write(_nametablePage[(address >> 10) & 0x03] + (address & 0x03FF), data);
     }
     // Palette RAM
     else if (address < 0x4000)
@@ -323,10 +454,20 @@ void PPU::PPUWrite(uint16_t address, uint8_t data)
         if (address == 0x001C) address = 0x000C;
 
         _palette[address] = data;
+
+        UpdatePaletteEntry(address);
+        if ((address & 0x03) == 0)
+            UpdatePaletteEntry(address | 0x10);
     }
 
 }
 
+void PPU::Clock()
+{
+    Clock<BalancedAccuracy>();
+}
+
+template <class Policy>
 void PPU::Clock()
 {
     // ==========================================
@@ -335,6 +476,13 @@ void PPU::Clock()
     // Visible scanlines (0-239) and pre-render scanline (261/-1)
     if (_scanline >= -1 && _scanline < 240)
     {
+        // Skip cycle 0 on odd frames (NTSC timing quirk); before the flag
+        // clear below, which would otherwise never see dot 1 on those frames
+        if (_scanline == -1 && _cycle == 0 && (_frameCount & 1))
+        {
+            _cycle = 1;
+        }
+
         // Clear flags at start of pre-render scanline
         if (_scanline == -1 && _cycle == 1)
         {
@@ -344,12 +492,6 @@ void PPU::Clock()
             _sprite0HitPossible = false;
             _nmiOutput = false;
         }
-
-        // Skip cycle 0 on odd frames (NTSC timing quirk)
-        if (_scanline == -1 && _cycle == 0 && (_frameCount & 1))
-        {
-            _cycle = 1;
-        }
         
         if ((_cycle >= 2 && _cycle < 258) || (_cycle >= 321 && _cycle < 338))
         {
@@ -359,7 +501,7 @@ void PPU::Clock()
             {
                 case 0:
                     LoadBackgroundShifters();
-                    _bgNextTileId = PPURead(0x2000 | (_vramAddr.reg & 0x0FFF));
+                    _bgNextTileId = PPURead<Policy>(0x2000 | (_vramAddr.reg & 0x0FFF));
                     break;
                 case 2:
                     {
@@ -367,7 +509,7 @@ void PPU::Clock()
                                             (_vramAddr.nametableX << 10) |
                                             ((_vramAddr.coarseY >> 2) << 3) |
                                             (_vramAddr.coarseX >> 2);
-                        _bgNextTileAttrib = PPURead(attribAddr);
+                        _bgNextTileAttrib = PPURead<Policy>(attribAddr);
                         
                         if (_vramAddr.coarseY & 0x02) _bgNextTileAttrib >>= 4;
                         if (_vramAddr.coarseX & 0x02) _bgNextTileAttrib >>= 2;
@@ -379,7 +521,7 @@ void PPU::Clock()
                         uint16_t patternAddr = (_ctrl.bgPattern << 12) +
                                              ((uint16_t)_bgNextTileId << 4) +
                                              _vramAddr.fineY;
-                        _bgNextTileLsb = PPURead(patternAddr);
+                        _bgNextTileLsb = PPURead<Policy>(patternAddr);
                     }
                     break;
                 case 6:
@@ -387,7 +529,7 @@ void PPU::Clock()
                         uint16_t patternAddr = (_ctrl.bgPattern << 12) +
                                              ((uint16_t)_bgNextTileId << 4) +
                                              _vramAddr.fineY + 8;
-                        _bgNextTileMsb = PPURead(patternAddr);
+                        _bgNextTileMsb = PPURead<Policy>(patternAddr);
                     }
                     break;
                 case 7:
@@ -408,7 +550,7 @@ void PPU::Clock()
             
             if (_scanline >= 0)
             {
-                EvaluateSprites();
+                EvaluateSprites<Policy>();
             }
         }
         
@@ -447,8 +589,10 @@ void PPU::Clock()
         }
     }
     
-    // Rendering logic for visible scanlines
-    if (_scanline >= 0 && _scanline < 240 && _cycle >= 1 && _cycle < 257)
+    // Rendering logic for visible scanlines. When skipping, pixels are
+    // only composed while they can still raise sprite 0 hit.
+    if (_scanline >= 0 && _scanline < 240 && _cycle >= 1 && _cycle < 257
+        && (!_skipRender || (_sprite0HitPossible && !_status.sprite0Hit)))
     {
         uint8_t bgPixel = 0x00;
         uint8_t bgPalette = 0x00;
@@ -474,25 +618,22 @@ void PPU::Clock()
         if (_mask.showSprites && (_mask.showSpritesLeft || _cycle >= 9))
         {
             fgPixel = GetSpritePixel(fgPriority);
-            
-            for (uint8_t i = 0; i < _spriteCount; i++)
+
+            // First sprite in OAM order whose counter has expired and whose
+            // current pixel is opaque
+            uint64_t opaque = (_spriteShifterLo | _spriteShifterHi) & GetExpiredSpriteLanes();
+            if (opaque)
             {
-                if (_spriteScanline[i].x == 0) {
-                    uint8_t fgPixelLo = (_spriteShifterPatternLo[i] & 0x80) > 0;
-                    uint8_t fgPixelHi = (_spriteShifterPatternHi[i] & 0x80) > 0;
-                    fgPixel = (fgPixelHi << 1) | fgPixelLo;
-                    
-                    fgPalette = (_spriteScanline[i].attribute & 0x03) + 0x04;
-                    fgPriority = (_spriteScanline[i].attribute & 0x20) == 0;
-                    
-                    if (fgPixel != 0)
-                    {
-                        if (i == 0)
-                        {
-                            _sprite0Rendering = true;
-                        }
-                        break;
-                    }
+                int lane = __builtin_ctzll(opaque) >> 3;
+                int bit = lane * 8 + 7;
+
+                fgPixel = (uint8_t) ((((_spriteShifterHi >> bit) & 1) << 1) | ((_spriteShifterLo >> bit) & 1));
+                fgPalette = (_spriteScanline[lane].attribute & 0x03) + 0x04;
+                fgPriority = (_spriteScanline[lane].attribute & 0x20) == 0;
+
+                if (lane == 0)
+                {
+                    _sprite0Rendering = true;
                 }
             }
         }
@@ -543,8 +684,19 @@ void PPU::Clock()
             }
         }
 
-        uint8_t colorIndex = PPURead(0x3F00 + (paletteIndex << 2) + pixel);
-        _screen[(_scanline * 256) + (_cycle - 1)] = colorIndex & 0x3F;
+        if (!_skipRender)
+        {
+            uint8_t entry = (paletteIndex << 2) + pixel;
+            if constexpr (Policy::TOOL_HOOKS)
+            {
+                if (_debugger)
+                    _debugger->OnPPURead(0x3F00 + entry);
+            }
+
+            _screen[(_scanline * 256) + (_cycle - 1)] = _paletteCache[entry];
+            if (_outputPixels)
+                _outputPixels[_scanline * _outputPitch + (_cycle - 1)] = _paletteARGB[entry];
+        }
     }
     
 
@@ -553,6 +705,7 @@ void PPU::Clock()
     // THIS IS CRITICAL - MUST HAPPEN EVERY CLOCK!
     // ==========================================
     _cycle++;
+    _dot++;
     
     // End of scanline (341 cycles per scanline)
     if (_cycle >= 341)
@@ -560,6 +713,10 @@ void PPU::Clock()
         _cycle = 0;
         _scanline++;
 
+        // Let the render thread run up to here
+        if (_pipeline)
+            _pipeline->Publish(_dot);
+
         // End of frame (262 scanlines: -1 to 260)
         if (_scanline >= 261)
         {
@@ -570,6 +727,22 @@ void PPU::Clock()
     }
 }
 
+template void PPU::Clock<FastAccuracy>();
+template void PPU::Clock<BalancedAccuracy>();
+template void PPU::Clock<ExactAccuracy>();
+template uint8_t PPU::CPURead<FastAccuracy>(uint16_t);
+template uint8_t PPU::CPURead<BalancedAccuracy>(uint16_t);
+template uint8_t PPU::CPURead<ExactAccuracy>(uint16_t);
+template void PPU::CPUWrite<FastAccuracy>(uint16_t, uint8_t);
+template void PPU::CPUWrite<BalancedAccuracy>(uint16_t, uint8_t);
+template void PPU::CPUWrite<ExactAccuracy>(uint16_t, uint8_t);
+template uint8_t PPU::PPURead<FastAccuracy>(uint16_t);
+template uint8_t PPU::PPURead<BalancedAccuracy>(uint16_t);
+template uint8_t PPU::PPURead<ExactAccuracy>(uint16_t);
+template void PPU::PPUWrite<FastAccuracy>(uint16_t, uint8_t);
+template void PPU::PPUWrite<BalancedAccuracy>(uint16_t, uint8_t);
+template void PPU::PPUWrite<ExactAccuracy>(uint16_t, uint8_t);
+
 void PPU::IncrementScrollX()
 {
     if (!_mask.showBg && !_mask.showSprites)
@@ -657,35 +830,179 @@ void PPU::UpdateShifters()
 
     if (_mask.showSprites && _cycle >= 1 && _cycle < 258)
     {
-        for (int i = 0; i < _spriteCount; ++i)
+        // All 8 sprites at once: running counters tick down, expired ones
+        // shift their pattern out (a shift never carries into the next lane)
+        uint64_t expired = GetExpiredSpriteLanes();
+        uint64_t shifting = (expired >> 7) * 0xFF;
+
+        _spriteX -= (_spriteLanes & ~expired) >> 7;
+        _spriteShifterLo = (_spriteShifterLo & ~shifting) | ((_spriteShifterLo << 1) & LANE_SHIFT_MASK & shifting);
+        _spriteShifterHi = (_spriteShifterHi & ~shifting) | ((_spriteShifterHi << 1) & LANE_SHIFT_MASK & shifting);
+    }
+}
+
+uint64_t PPU::GetExpiredSpriteLanes() const
+{
+    // Bit 7 of a lane is set iff its low 7 bits or its top bit are non-zero
+    uint64_t nonZero = ((_spriteX & LANE_LOW_BITS) + LANE_LOW_BITS) | _spriteX;
+    return ~nonZero & _spriteLanes;
+}
+
+void PPU::LoadSpriteShifters(const uint8_t* lo, const uint8_t* hi)
+{
+    _spriteShifterLo = 0;
+    _spriteShifterHi = 0;
+    _spriteX = 0;
+    _spriteLanes = 0;
+
+    for (uint8_t i = 0; i < _spriteCount; ++i)
+    {
+        int shift = i * 8;
+        _spriteShifterLo |= (uint64_t) lo[i] << shift;
+        _spriteShifterHi |= (uint64_t) hi[i] << shift;
+        _spriteX |= (uint64_t) _spriteScanline[i].x << shift;
+        _spriteLanes |= (uint64_t) 0x80 << shift;
+    }
+}
+
+void PPU::InvalidateSpriteBins()
+{
+    _spriteBinsValid = false;
+    _spriteBinsFrame = ~0ULL;
+    _spriteBinPatternKey.fill(NO_PATTERN_KEY);
+}
+
+uint64_t PPU::GetSpritePatternKey() const
+{
+    uint64_t generation = (_cartridge ? _cartridge->GetCHRGeneration() : 0) + (uint64_t) _patternTableWrites;
+    return (generation << 1) | _ctrl.spritePattern;
+}
+
+void PPU::BuildSpriteBins()
+{
+    // Same selection as a per-scanline scan: first 8 sprites in OAM order
+    // whose rows cover the scanline, and whether a 9th one does too
+    _spriteBinCount.fill(0);
+    _spriteBinOverflow.fill(0);
+    _spriteBinPatternKey.fill(NO_PATTERN_KEY);
+
+    const int height = _ctrl.spriteSize ? 16 : 8;
+
+    for (uint8_t oamEntry = 0; oamEntry < 64; ++oamEntry)
+    {
+        int top = _oam[oamEntry * 4];
+        int bottom = std::min(top + height, (int) SCREEN_HEIGHT);
+
+        for (int line = top; line < bottom; ++line)
         {
-            if (_spriteScanline[i].x > 0)
-            {
-                _spriteScanline[i].x--;
-            }
+            uint8_t& count = _spriteBinCount[line];
+            if (count < 8)
+                _spriteBins[line * 8 + count++] = oamEntry;
             else
-            {
-                _spriteShifterPatternLo[i] <<= 1;
-                _spriteShifterPatternHi[i] <<= 1;
-            }
+                _spriteBinOverflow[line] = 1;
         }
     }
+
+    _spriteBinsValid = true;
+    _spriteBinsFrame = _frameCount;
+}
+
+template <class Policy>
+void PPU::FetchSpritePattern(const SpriteData& s, uint8_t& lo, uint8_t& hi)
+{
+    uint8_t  row   = (uint8_t)(_scanline - s.y);
+    bool     flipV = (s.attribute & 0x80);
+    bool     flipH = (s.attribute & 0x40);
+    uint16_t addr;
+
+    if (!_ctrl.spriteSize)            // 8x8
+    {
+        if (flipV) row = 7 - row;
+        addr = (_ctrl.spritePattern << 12) | (s.tileId << 4) | row;
+    }
+    else                              // 8x16
+    {
+        if (flipV) row = 15 - row;
+        uint16_t bank = (s.tileId & 0x01) << 12;
+        uint8_t  tile = (s.tileId & 0xFE) + (row >= 8 ? 1 : 0);
+        addr = bank | (tile << 4) | (row & 0x07);
+    }
+
+    lo = PPURead<Policy>(addr);
+    hi = PPURead<Policy>(addr + 8);
+    if (flipH) { lo = ReverseByte(lo); hi = ReverseByte(hi); }
 }
 
+template <class Policy>
 void PPU::EvaluateSprites()
 {
-    _spriteCount = 0;
     _sprite0HitPossible = false;
     _sprite0Rendering   = false;   // reset each scanline so the hit can re-arm
 
+    // Rebuild at most once per frame; games that keep writing $2004 during
+    // rendering get the plain per-scanline scan for the rest of the frame
+    if (!_spriteBinsValid)
+    {
+        if (_spriteBinsFrame == _frameCount)
+        {
+            EvaluateSpritesDirect<Policy>();
+            return;
+        }
+
+        BuildSpriteBins();
+    }
+
+    const size_t bin = (size_t) _scanline * 8;
+    _spriteCount = _spriteBinCount[_scanline];
+    if (_spriteBinOverflow[_scanline])
+        _status.spriteOverflow = 1;
+
+    // A debugger sees every pattern fetch, so don't serve it from the cache
+    const uint64_t key = GetSpritePatternKey();
+    const bool fetch = (Policy::TOOL_HOOKS && _debugger) || _spriteBinPatternKey[_scanline] != key;
+
+    for (uint8_t i = 0; i < _spriteCount; ++i)
+    {
+        uint8_t oamEntry = _spriteBins[bin + i];
+        if (oamEntry == 0)
+            _sprite0HitPossible = true;
+
+        SpriteData& s = _spriteScanline[i];
+        s.y         = _oam[oamEntry * 4 + 0];
+        s.tileId    = _oam[oamEntry * 4 + 1];
+        s.attribute = _oam[oamEntry * 4 + 2];
+        s.x         = _oam[oamEntry * 4 + 3];
+
+        if (fetch)
+            FetchSpritePattern<Policy>(s, _spriteBinPatternLo[bin + i], _spriteBinPatternHi[bin + i]);
+    }
+
+    _spriteBinPatternKey[_scanline] = key;
+    LoadSpriteShifters(&_spriteBinPatternLo[bin], &_spriteBinPatternHi[bin]);
+}
+
+template <class Policy>
+void PPU::EvaluateSpritesDirect()
+{
+    _spriteCount = 0;
+
+    uint8_t lo[8], hi[8];
     uint8_t oamEntry = 0;
+    const int16_t height = _ctrl.spriteSize ? 16 : 8;
 
-    while (oamEntry < 64 && _spriteCount < 9)
+    while (oamEntry < 64)
     {
         int16_t diff = (int16_t)_scanline - (int16_t)_oam[oamEntry * 4];
 
-        if (diff >= 0 && diff < (_ctrl.spriteSize ? 16 : 8) && _spriteCount < 8)
+        if (diff >= 0 && diff < height)
         {
+            // A 9th sprite on the line only sets the flag
+            if (_spriteCount == 8)
+            {
+                _status.spriteOverflow = 1;
+                break;
+            }
+
             if (oamEntry == 0)
                 _sprite0HitPossible = true;
 
@@ -695,43 +1012,13 @@ void PPU::EvaluateSprites()
             s.attribute = _oam[oamEntry * 4 + 2];
             s.x         = _oam[oamEntry * 4 + 3];
 
-            // --- fetch this sprite's pattern bytes into the shifters ---
-            uint8_t  row   = (uint8_t)diff;
-            bool     flipV = (s.attribute & 0x80);
-            bool     flipH = (s.attribute & 0x40);
-            uint16_t addr;
-
-            if (!_ctrl.spriteSize)            // 8x8
-            {
-                if (flipV) row = 7 - row;
-                addr = (_ctrl.spritePattern << 12) | (s.tileId << 4) | row;
-            }
-            else                              // 8x16
-            {
-                if (flipV) row = 15 - row;
-                uint16_t bank = (s.tileId & 0x01) << 12;
-                uint8_t  tile = (s.tileId & 0xFE) + (row >= 8 ? 1 : 0);
-                addr = bank | (tile << 4) | (row & 0x07);
-            }
-
-            uint8_t lo = PPURead(addr);
-            uint8_t hi = PPURead(addr + 8);
-            if (flipH) { lo = ReverseByte(lo); hi = ReverseByte(hi); }
-
-            _spriteShifterPatternLo[_spriteCount] = lo;
-            _spriteShifterPatternHi[_spriteCount] = hi;
-            // -----------------------------------------------------------
-
+            FetchSpritePattern<Policy>(s, lo[_spriteCount], hi[_spriteCount]);
             _spriteCount++;
         }
         oamEntry++;
     }
 
-    if (_spriteCount > 8)
-    {
-        _status.spriteOverflow = 1;
-        _spriteCount = 8;
-    }
+    LoadSpriteShifters(lo, hi);
 }
 
 uint8_t PPU::GetBackgroundPixel()
@@ -4,9 +4,14 @@
 #include <array>
 #include <cstdint>
 
+#include "cpu/Accuracy.h"
+#include "memory/CowBuffer.h"
+
 // Forward declarations
 class Bus;
 class Cartridge;
+class Debugger;
+class PPUPipeline;
 
 
 class PPU
@@ -22,7 +27,23 @@ public:
     void ConnectBus(Bus* b) { _bus = b; }
 
     // Connect to Cartridge for CHR memory
-    void ConnectCartridge(Cartridge* cart) { _cartridge = cart; }
+    void ConnectCartridge(Cartridge* cart) { _cartridge = cart; InvalidateSpriteBins(); UpdateNametableMapping(); }
+
+    // Recompute the nametable page table from the cartridge mirroring.
+    // Must be called whenever the mapper may have changed mirroring.
+    void UpdateNametableMapping();
+
+    // Mapper register write on the CPU bus ($8000-$FFFF): mirroring and,
+    // when pipelined, CHR banking may have changed
+    void OnCartridgeWrite(uint16_t address, uint8_t value);
+
+    // Watchpoints on the PPU address space (nullptr to detach)
+    void AttachDebugger(Debugger* debugger) { _debugger = debugger; }
+
+    // Hand pixel generation to a render thread (see PPUPipeline, which
+    // attaches itself). CPU-side accesses are then logged for replay.
+    void AttachPipeline(PPUPipeline* pipeline) { _pipeline = pipeline; }
+    bool IsPipelined() const { return _pipeline != nullptr; }
 
     // Clock the PPU (called 3 times per CPU cycle)
     void Clock();
@@ -39,6 +60,14 @@ public:
     // PPU writes to its own memory space
     void PPUWrite(uint16_t address, uint8_t value);
 
+    // The same under an accuracy policy (the Bus's per-tier paths); the
+    // plain ones are the BALANCED instances
+    template <class Policy> void Clock();
+    template <class Policy> uint8_t CPURead(uint16_t address);
+    template <class Policy> void CPUWrite(uint16_t address, uint8_t value);
+    template <class Policy> uint8_t PPURead(uint16_t address);
+    template <class Policy> void PPUWrite(uint16_t address, uint8_t value);
+
     // Check if frame is complete (ready to render)
     bool IsFrameComplete() const { return _frameComplete; }
     void ClearFrameComplete() { _frameComplete = false; }
@@ -47,13 +76,31 @@ public:
     bool NMIOccurred() const { return _nmiOutput; };
     void ClearNMI() { _nmiOutput = false; };
 
-    // Get screen buffer (256x240 pixels, NES color palette indices 0-63)
-    const uint8_t* GetScreenBuffer() const { return _screen.data(); };
+    // Get screen buffer (256x240 pixels, NES color palette indices 0-63).
+    // When pipelined this is the render thread's; PPUPipeline::Sync() first.
+    const uint8_t* GetScreenBuffer() const;
+    void CopyScreen(const PPU& other) { _screen = other._screen; }
+
+    // Also write each pixel as ARGB8888 straight into a host framebuffer
+    // (e.g. a locked streaming texture; pitch in bytes). nullptr disables.
+    // When pipelined this waits for the render thread to catch up.
+    void SetOutputBuffer(uint32_t* pixels, int pitch);
+
+    // Skip pixel output (fast-forward / headless). Timing, sprite 0 hit,
+    // sprite overflow, VRAM addressing and mapper scanline IRQs are the
+    // same as when rendering; the screen buffer keeps whatever was last
+    // drawn. Set between frames.
+    // A pipelined PPU always skips; the setting goes to the render thread.
+    void SetSkipRender(bool skip);
+    bool IsSkipRender() const { return _skipRender; }
 
     uint16_t GetScanline() { return _scanline; }
     uint16_t GetCycle() { return _cycle; }
     uint64_t GetFrameCount() { return _frameCount; }
 
+    // PPU clocks since construction (not reset); timestamps pipeline events
+    uint64_t GetDotCount() const { return _dot; }
+
     static constexpr int SCREEN_WIDTH  = 256;
     static constexpr int SCREEN_HEIGHT = 240;
 
@@ -143,10 +190,14 @@ private:
     bool _frameComplete;
     bool _nmiOutput;
     uint64_t _frameCount;
+    uint64_t _dot;
 
     // PPU Memory
-    std::array<uint8_t, 2048> _nametable;    // 2KB nametable RAM
+    CowBuffer<4096, 0x0400>   _nametable;    // 2KB CIRAM + 2KB cartridge VRAM (four-screen), shared by copies until written
+    std::array<uint16_t, 4>   _nametablePage; // Offset into _nametable for each logical 1KB nametable
     std::array<uint8_t, 32>   _palette;      // 32 bytes palette RAM
+    std::array<uint8_t, 32>   _paletteCache; // Resolved colour per entry (mirroring + grayscale)
+    std::array<uint32_t, 32>  _paletteARGB;  // _paletteCache through the system palette
     std::array<uint8_t, 256>  _oam;          // 256 bytes Object Attribute Memory (sprites)
     std::array<uint8_t, 32>   _secondaryOam; // 32 bytes secondary OAM for current scanline
 
@@ -157,6 +208,11 @@ private:
     // Screen buffer - stores palette indices for each pixel
     std::array<uint8_t, SCREEN_WIDTH * SCREEN_HEIGHT> _screen;
 
+    // Optional ARGB output (see SetOutputBuffer)
+    uint32_t* _outputPixels;
+    int _outputPitch; // In pixels
+    bool _skipRender;
+
     // Rendering pipeline data
     struct BackgroundShifters
     {
@@ -180,12 +236,38 @@ private:
         uint8_t x;
     };
     std::array<SpriteData, 8> _spriteScanline;
-    std::array<uint8_t, 8> _spriteShifterPatternLo;
-    std::array<uint8_t, 8> _spriteShifterPatternHi;
+
+    // Sprite shifters and X counters packed one byte lane per sprite
+    // (sprite i in bits 8i..8i+7), so a dot updates all 8 in a few
+    // instructions and the priority mux is a find-first-set
+    static constexpr uint64_t LANE_LOW_BITS   = 0x7F7F7F7F7F7F7F7FULL;
+    static constexpr uint64_t LANE_SHIFT_MASK = 0xFEFEFEFEFEFEFEFEULL;
+
+    uint64_t _spriteShifterLo;
+    uint64_t _spriteShifterHi;
+    uint64_t _spriteX;
+    uint64_t _spriteLanes; // 0x80 in each lane holding a sprite
     uint8_t _spriteCount;
     bool _sprite0HitPossible;
     bool _sprite0Rendering;
 
+    // Sprite evaluation cache. OAM normally changes once per frame (DMA), so
+    // the sprites on each scanline are binned up front and rebuilt only when
+    // OAM or the sprite size changes. Pattern bytes are kept per bin along
+    // with the pattern key they were fetched under (CHR generation and
+    // sprite pattern table) and refetched when that key moves.
+    static constexpr uint64_t NO_PATTERN_KEY = ~0ULL;
+
+    std::array<uint8_t, SCREEN_HEIGHT * 8> _spriteBins;      // OAM indices, 8 per scanline
+    std::array<uint8_t, SCREEN_HEIGHT> _spriteBinCount;
+    std::array<uint8_t, SCREEN_HEIGHT> _spriteBinOverflow;   // More than 8 sprites on the scanline
+    std::array<uint8_t, SCREEN_HEIGHT * 8> _spriteBinPatternLo;
+    std::array<uint8_t, SCREEN_HEIGHT * 8> _spriteBinPatternHi;
+    std::array<uint64_t, SCREEN_HEIGHT> _spriteBinPatternKey;
+    bool _spriteBinsValid;
+    uint64_t _spriteBinsFrame;    // Frame the bins were last built in
+    uint32_t _patternTableWrites; // Internal pattern table (no cartridge)
+
     // Helper functions
     void IncrementScrollX();
     void IncrementScrollY();
@@ -193,11 +275,20 @@ private:
     void TransferAddressY();
     void LoadBackgroundShifters();
     void UpdateShifters();
-    
-    uint16_t MapNametable(uint16_t address) const;
+    void LoadSpriteShifters(const uint8_t* lo, const uint8_t* hi);
+    uint64_t GetExpiredSpriteLanes() const; // 0x80 per lane whose X reached 0
+
+    // Palette cache, refreshed on palette writes and PPUMASK grayscale changes
+    void UpdatePaletteEntry(uint8_t entry);
+    void UpdatePaletteCache();
 
     // Sprite evaluation
-    void EvaluateSprites();
+    template <class Policy> void EvaluateSprites();
+    template <class Policy> void EvaluateSpritesDirect();
+    template <class Policy> void FetchSpritePattern(const SpriteData& sprite, uint8_t& lo, uint8_t& hi);
+    void BuildSpriteBins();
+    void InvalidateSpriteBins();
+    uint64_t GetSpritePatternKey() const;
     
     // Rendering
     uint8_t GetBackgroundPixel();
@@ -208,6 +299,12 @@ private:
 
     // Cartridge connection
     Cartridge* _cartridge;
+
+    // Optional debugger
+    Debugger* _debugger;
+
+    // Render thread, if pipelined
+    PPUPipeline* _pipeline;
 };
 
 #endif // PPU_H
\ No newline at end of file
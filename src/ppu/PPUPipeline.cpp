@@ -0,0 +1,202 @@
+#include <chrono>
+
+#include "PPUPipeline.h"
+#include "cartridge/Cartridge.h"
+#include "utils/Logger.h"
+
+
+PPUPipeline::PPUPipeline()
+    : _ppu(nullptr),
+      _ring(),
+      _head(0),
+      _tailSeen(0),
+      _publishedDot(0),
+      _tail(0),
+      _renderedDot(0),
+      _stop(false)
+{
+}
+
+PPUPipeline::~PPUPipeline()
+{
+    Stop();
+}
+
+bool PPUPipeline::Start(PPU* ppu, Cartridge* cartridge)
+{
+    if (!ppu || IsRunning())
+        return false;
+
+    _cartridge = cartridge ? cartridge->Clone() : nullptr;
+    if (cartridge && cartridge->IsLoaded() && !_cartridge)
+        return false;
+
+    // The copy carries every piece of rendering state; only the
+    // connections are its own
+    _renderer = *ppu;
+    _renderer.ConnectBus(nullptr);
+    _renderer.AttachDebugger(nullptr);
+    _renderer.AttachPipeline(nullptr);
+    _renderer.ConnectCartridge(_cartridge.get());
+
+    _head.store(0, std::memory_order_relaxed);
+    _tailSeen = 0;
+    _tail.store(0, std::memory_order_relaxed);
+    _publishedDot.store(ppu->GetDotCount(), std::memory_order_relaxed);
+    _renderedDot.store(ppu->GetDotCount(), std::memory_order_relaxed);
+    _stop.store(false, std::memory_order_relaxed);
+
+    // From here on the timing PPU only draws what sprite 0 hit needs
+    ppu->SetSkipRender(true);
+    ppu->SetOutputBuffer(nullptr, 0);
+    ppu->AttachPipeline(this);
+    _ppu = ppu;
+
+    _thread = std::thread(&PPUPipeline::Run, this);
+
+    LOG_INFO("PPU pipeline started at dot %llu", (unsigned long long) ppu->GetDotCount());
+    return true;
+}
+
+void PPUPipeline::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    Sync();
+
+    _stop.store(true, std::memory_order_release);
+    _thread.join();
+
+    _ppu->AttachPipeline(nullptr);
+    _ppu->SetSkipRender(_renderer.IsSkipRender());
+    _ppu->CopyScreen(_renderer);
+    _ppu = nullptr;
+    _cartridge.reset();
+}
+
+void PPUPipeline::Sync()
+{
+    if (!IsRunning())
+        return;
+
+    uint64_t dot = _ppu->GetDotCount();
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    Publish(dot);
+
+    unsigned spins = 0;
+    while (_tail.load(std::memory_order_acquire) != head
+           || _renderedDot.load(std::memory_order_acquire) < dot)
+        Wait(spins);
+}
+
+void PPUPipeline::SetOutputBuffer(uint32_t* pixels, int pitch)
+{
+    // The render thread is idle until the next Publish(), which orders
+    // this write before its next pixel
+    Sync();
+    _renderer.SetOutputBuffer(pixels, pitch);
+}
+
+void PPUPipeline::Push(uint64_t dot, EventType type, uint16_t address, uint8_t value)
+{
+    uint64_t head = _head.load(std::memory_order_relaxed);
+
+    if (head - _tailSeen == RING_CAPACITY)
+    {
+        // Full: let the render thread run up to this event's dot
+        Publish(dot);
+
+        unsigned spins = 0;
+        while (head - (_tailSeen = _tail.load(std::memory_order_acquire)) == RING_CAPACITY)
+            Wait(spins);
+    }
+
+    _ring[head % RING_CAPACITY] = { dot, address, type, value };
+    _head.store(head + 1, std::memory_order_release);
+}
+
+void PPUPipeline::Run()
+{
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+    unsigned spins = 0;
+
+    for (;;)
+    {
+        // Events up to the published dot are all in the ring by the time
+        // it is visible, so read it before the head
+        uint64_t target = _publishedDot.load(std::memory_order_acquire);
+        uint64_t head = _head.load(std::memory_order_acquire);
+        bool progressed = false;
+
+        for (; tail != head; ++tail)
+        {
+            const Event& event = _ring[tail % RING_CAPACITY];
+            while (_renderer.GetDotCount() < event.dot)
+                _renderer.Clock();
+
+            Apply(event);
+            _tail.store(tail + 1, std::memory_order_release);
+            progressed = true;
+        }
+
+        while (_renderer.GetDotCount() < target)
+        {
+            _renderer.Clock();
+            progressed = true;
+        }
+
+        _renderedDot.store(_renderer.GetDotCount(), std::memory_order_release);
+
+        if (progressed)
+        {
+            spins = 0;
+            continue;
+        }
+
+        // Stop() syncs first, so nothing is left once it is set
+        if (_stop.load(std::memory_order_acquire))
+            break;
+
+        Wait(spins);
+    }
+}
+
+void PPUPipeline::Apply(const Event& event)
+{
+    switch (event.type)
+    {
+        case EVENT_REGISTER_WRITE:
+            _renderer.CPUWrite(event.address, event.value);
+            break;
+
+        case EVENT_REGISTER_READ:
+            _renderer.CPURead(event.address);
+            break;
+
+        case EVENT_CARTRIDGE_WRITE:
+            if (_cartridge)
+                _cartridge->CPUWrite(event.address, event.value);
+            _renderer.OnCartridgeWrite(event.address, event.value);
+            break;
+
+        case EVENT_RESET:
+            _renderer.Reset();
+            if (_cartridge)
+                _cartridge->Reset();
+            _renderer.UpdateNametableMapping();
+            break;
+
+        case EVENT_SKIP_RENDER:
+            _renderer.SetSkipRender(event.value != 0);
+            break;
+    }
+}
+
+void PPUPipeline::Wait(unsigned& spins)
+{
+    if (++spins < 64)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
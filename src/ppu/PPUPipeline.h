@@ -0,0 +1,110 @@
+#ifndef PPU_PIPELINE_H
+#define PPU_PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "PPU.h"
+
+class Cartridge;
+
+
+// Runs pixel generation for a PPU on a second thread.
+//
+// The attached (timing) PPU keeps running on the emulation thread in skip
+// render mode, so vblank, NMI, sprite 0 hit and VRAM addressing stay exact
+// there. Everything that can change what gets drawn is logged with the dot
+// it happened at: $2000-$2007 writes (OAM DMA included), PPUSTATUS and
+// PPUDATA reads, mapper register writes (CHR banking, mirroring) and
+// resets. The render thread replays the log on a copy of the PPU and of
+// the cartridge, clocking that copy to each event's dot first, so it
+// produces exactly the frames the serial PPU would.
+//
+// Debugger hooks only see the timing PPU, and direct PPUWrite() calls
+// while pipelined are not replayed.
+class PPUPipeline
+{
+public:
+    enum EventType : uint8_t
+    {
+        EVENT_REGISTER_WRITE,  // CPUWrite(address, value)
+        EVENT_REGISTER_READ,   // CPURead(address)
+        EVENT_CARTRIDGE_WRITE, // Cartridge CPUWrite(address, value)
+        EVENT_RESET,           // PPU and cartridge reset (Bus::Reset)
+        EVENT_SKIP_RENDER      // SetSkipRender(value)
+    };
+
+    PPUPipeline();
+    ~PPUPipeline();
+
+    PPUPipeline(const PPUPipeline&) = delete;
+    PPUPipeline& operator=(const PPUPipeline&) = delete;
+
+    // Snapshot the PPU and cartridge (nullptr if none) and start rendering
+    // on the worker thread. Call between Bus::Clock() calls.
+    bool Start(PPU* ppu, Cartridge* cartridge);
+
+    // Catch up, stop the thread and hand the last frame back to the PPU
+    void Stop();
+
+    bool IsRunning() const { return _ppu != nullptr; }
+
+    // Wait until the render thread has reached the timing PPU
+    void Sync();
+
+    // The render thread's screen buffer (valid after Sync())
+    const uint8_t* GetScreenBuffer() const { return _renderer.GetScreenBuffer(); }
+
+    // The render thread's PPU (only safe to look at after Sync())
+    const PPU& GetRenderer() const { return _renderer; }
+
+    // Syncs, then sets the render thread's output buffer
+    void SetOutputBuffer(uint32_t* pixels, int pitch);
+
+    // Producer side, called by the timing PPU
+    void Push(uint64_t dot, EventType type, uint16_t address, uint8_t value);
+    void Publish(uint64_t dot) { _publishedDot.store(dot, std::memory_order_release); }
+
+private:
+    // 16K events covers a full vblank of $2007 uploads plus OAM DMA; the
+    // producer waits when the render thread is that far behind
+    static constexpr size_t RING_CAPACITY = 16384;
+
+    struct Event
+    {
+        uint64_t dot;
+        uint16_t address;
+        EventType type;
+        uint8_t value;
+    };
+
+    void Run();
+    void Apply(const Event& event);
+
+    // Spin briefly, then back off to yielding and short sleeps
+    static void Wait(unsigned& spins);
+
+    PPU* _ppu;
+    std::unique_ptr<Cartridge> _cartridge;
+    PPU _renderer;
+    std::thread _thread;
+
+    std::array<Event, RING_CAPACITY> _ring;
+
+    // Producer: next slot to write, last consumer position seen
+    alignas(64) std::atomic<uint64_t> _head;
+    uint64_t _tailSeen;
+
+    // Dot the timing PPU has published (end of every scanline and Sync)
+    alignas(64) std::atomic<uint64_t> _publishedDot;
+
+    // Consumer progress
+    alignas(64) std::atomic<uint64_t> _tail;
+    std::atomic<uint64_t> _renderedDot;
+    std::atomic<bool> _stop;
+};
+
+#endif // PPU_PIPELINE_H
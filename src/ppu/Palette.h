@@ -0,0 +1,16 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <array>
+#include <cstdint>
+
+
+// NES master palette (64 colours, ARGB8888).
+// Shared by the SDL display and the offline encoders, which must not
+// depend on SDL.
+struct Palette
+{
+    static const std::array<uint32_t, 64> ARGB;
+};
+
+#endif // PALETTE_H
@@ -0,0 +1,201 @@
+#include <algorithm>
+
+#include "Debugger.h"
+#include "utils/Logger.h"
+
+
+Debugger::Debugger()
+    : _execCount(0),
+    _nextWatchpointId(1),
+    _instructionHook(false),
+    _paused(false),
+    _pauseRequested(false),
+    _stepping(false),
+    _stepsRemaining(0),
+    _skipBreakpoint(false),
+    _hasPending(false),
+    _pending(),
+    _lastBreak()
+{
+    _execBits.fill(0);
+    _cpuTraps.fill(0);
+    _ppuTraps.fill(0);
+}
+
+void Debugger::AddBreakpoint(uint16_t address)
+{
+    if (HasBreakpoint(address))
+        return;
+
+    _execBits[address >> 6] |= (uint64_t) 1 << (address & 63);
+    _execCount++;
+    UpdateInstructionHook();
+}
+
+void Debugger::RemoveBreakpoint(uint16_t address)
+{
+    if (!HasBreakpoint(address))
+        return;
+
+    _execBits[address >> 6] &= ~((uint64_t) 1 << (address & 63));
+    _execCount--;
+    UpdateInstructionHook();
+}
+
+int Debugger::AddWatchpoint(Space space, uint16_t start, uint16_t end, uint8_t access)
+{
+    if (space == SPACE_PPU)
+    {
+        start &= 0x3FFF;
+        end &= 0x3FFF;
+    }
+    if (end < start)
+        std::swap(start, end);
+
+    Watchpoint w;
+    w.id = _nextWatchpointId++;
+    w.space = space;
+    w.start = start;
+    w.end = end;
+    w.access = access & (ACCESS_READ | ACCESS_WRITE);
+
+    _watchpoints.push_back(w);
+    RebuildTraps();
+    return w.id;
+}
+
+void Debugger::RemoveWatchpoint(int id)
+{
+    _watchpoints.erase(std::remove_if(_watchpoints.begin(), _watchpoints.end(),
+                                      [id](const Watchpoint& w) { return w.id == id; }),
+                       _watchpoints.end());
+    RebuildTraps();
+}
+
+void Debugger::ClearAll()
+{
+    _execBits.fill(0);
+    _execCount = 0;
+    _watchpoints.clear();
+    RebuildTraps();
+    UpdateInstructionHook();
+}
+
+void Debugger::Pause()
+{
+    _pauseRequested = true;
+    UpdateInstructionHook();
+}
+
+void Debugger::Resume()
+{
+    _skipBreakpoint = _paused;
+    _paused = false;
+    _pauseRequested = false;
+    _stepping = false;
+    UpdateInstructionHook();
+}
+
+void Debugger::Step(uint32_t count)
+{
+    Resume();
+    _stepping = true;
+    _stepsRemaining = count;
+    UpdateInstructionHook();
+}
+
+bool Debugger::CheckInstruction(uint16_t pc)
+{
+    if (_paused)
+        return true;
+
+    if (_skipBreakpoint)
+    {
+        _skipBreakpoint = false;
+    }
+    else if (_execCount && HasBreakpoint(pc))
+    {
+        _pending = BreakInfo{ ACCESS_EXECUTE, SPACE_CPU, pc, 0, pc, -1 };
+        _hasPending = true;
+        _pauseRequested = true;
+    }
+
+    if (!_pauseRequested && _stepping)
+    {
+        if (_stepsRemaining == 0)
+            _pauseRequested = true;
+        else
+            _stepsRemaining--;
+    }
+
+    if (!_pauseRequested)
+        return false;
+
+    Break(pc);
+    return true;
+}
+
+void Debugger::CheckWatchpoints(Space space, uint16_t address, uint8_t access, uint8_t value)
+{
+    // Page is trapped: find the exact watchpoint
+    for (const Watchpoint& w : _watchpoints)
+    {
+        if (w.space == space && (w.access & access) && w.start <= address && address <= w.end)
+        {
+            // Keep the first trigger if several land in one instruction
+            if (!_hasPending)
+            {
+                _pending = BreakInfo{ access, space, address, value, 0, w.id };
+                _hasPending = true;
+            }
+
+            _pauseRequested = true;
+            _instructionHook = true;
+            return;
+        }
+    }
+}
+
+void Debugger::Break(uint16_t pc)
+{
+    // Pause() and finished steps have no trigger of their own
+    if (!_hasPending)
+        _pending = BreakInfo{ ACCESS_NONE, SPACE_CPU, pc, 0, pc, -1 };
+
+    _pending.pc = pc;
+    _lastBreak = _pending;
+    _hasPending = false;
+
+    _paused = true;
+    _pauseRequested = false;
+    _stepping = false;
+    UpdateInstructionHook();
+
+    LOG_DEBUG("Debugger break at PC=0x%04x (access=%d address=0x%04x)",
+              pc, (int) _lastBreak.access, _lastBreak.address);
+
+    if (_callback)
+        _callback(_lastBreak);
+}
+
+void Debugger::RebuildTraps()
+{
+    _cpuTraps.fill(0);
+    _ppuTraps.fill(0);
+
+    for (const Watchpoint& w : _watchpoints)
+    {
+        for (unsigned page = w.start >> 8; page <= (unsigned) (w.end >> 8); ++page)
+        {
+            if (w.space == SPACE_CPU)
+                _cpuTraps[page] |= w.access;
+            else
+                _ppuTraps[page & 0x3F] |= w.access;
+        }
+    }
+}
+
+void Debugger::UpdateInstructionHook()
+{
+    _instructionHook = _execCount || _paused || _pauseRequested || _stepping;
+}
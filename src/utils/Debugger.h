@@ -0,0 +1,151 @@
+#ifndef DEBUGGER_H
+#define DEBUGGER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+// Execution breakpoints, CPU/PPU watchpoints and single-step.
+//
+// Designed to stay attached in release builds at no cost when nothing is
+// armed: memory hooks only test a per-page trap byte (and the exact
+// watchpoint list is scanned only when that page is trapped), and the
+// per-instruction check is a single flag test unless an execution
+// breakpoint, a step or a pause request is pending.
+//
+// Every stop happens at an instruction boundary. While paused, Bus::Clock
+// does nothing, so run loops must check IsPaused() instead of waiting for
+// the frame to complete.
+class Debugger
+{
+public:
+    enum Space : uint8_t
+    {
+        SPACE_CPU,
+        SPACE_PPU
+    };
+
+    enum Access : uint8_t
+    {
+        ACCESS_READ    = (1 << 0),
+        ACCESS_WRITE   = (1 << 1),
+        ACCESS_EXECUTE = (1 << 2),
+        ACCESS_NONE    = 0          // Pause request or finished step
+    };
+
+    struct Watchpoint
+    {
+        int id;
+        Space space;
+        uint16_t start, end; // Inclusive range
+        uint8_t access;      // ACCESS_READ | ACCESS_WRITE
+    };
+
+    // Why execution stopped
+    struct BreakInfo
+    {
+        uint8_t access;   // What triggered it (ACCESS_NONE for pause/step)
+        Space space;
+        uint16_t address; // Accessed address, or PC for execute
+        uint8_t value;    // Written value (writes only)
+        uint16_t pc;      // PC of the instruction about to execute
+        int watchpoint;   // Watchpoint id, -1 otherwise
+    };
+
+    using BreakCallback = std::function<void(const BreakInfo&)>;
+
+    Debugger();
+
+    // Execution breakpoints (CPU address space)
+    void AddBreakpoint(uint16_t address);
+    void RemoveBreakpoint(uint16_t address);
+    bool HasBreakpoint(uint16_t address) const { return (_execBits[address >> 6] >> (address & 63)) & 1; }
+
+    // Watchpoints; returns an id for RemoveWatchpoint
+    int AddWatchpoint(Space space, uint16_t start, uint16_t end, uint8_t access);
+    void RemoveWatchpoint(int id);
+    const std::vector<Watchpoint>& GetWatchpoints() const { return _watchpoints; }
+
+    void ClearAll();
+
+    // Run control
+    void Pause();                // Stop at the next instruction boundary
+    void Resume();
+    void Step(uint32_t count = 1); // Run count instructions, then stop
+    bool IsPaused() const { return _paused; }
+
+    const BreakInfo& GetLastBreak() const { return _lastBreak; }
+    void SetBreakCallback(BreakCallback callback) { _callback = std::move(callback); }
+
+    // ---- Hooks (called by Bus and PPU) ----
+
+    // Anything to check at instruction boundaries (breakpoints, step, pause)
+    bool IsInstructionHookArmed() const { return _instructionHook; }
+
+    // At each CPU instruction boundary; true means hold the system
+    bool OnInstruction(uint16_t pc)
+    {
+        if (!_instructionHook)
+            return false;
+        return CheckInstruction(pc);
+    }
+
+    void OnCPURead(uint16_t address)
+    {
+        if (_cpuTraps[address >> 8] & ACCESS_READ)
+            CheckWatchpoints(SPACE_CPU, address, ACCESS_READ, 0);
+    }
+
+    void OnCPUWrite(uint16_t address, uint8_t value)
+    {
+        if (_cpuTraps[address >> 8] & ACCESS_WRITE)
+            CheckWatchpoints(SPACE_CPU, address, ACCESS_WRITE, value);
+    }
+
+    void OnPPURead(uint16_t address)
+    {
+        if (_ppuTraps[(address & 0x3FFF) >> 8] & ACCESS_READ)
+            CheckWatchpoints(SPACE_PPU, address & 0x3FFF, ACCESS_READ, 0);
+    }
+
+    void OnPPUWrite(uint16_t address, uint8_t value)
+    {
+        if (_ppuTraps[(address & 0x3FFF) >> 8] & ACCESS_WRITE)
+            CheckWatchpoints(SPACE_PPU, address & 0x3FFF, ACCESS_WRITE, value);
+    }
+
+private:
+    bool CheckInstruction(uint16_t pc);
+    void CheckWatchpoints(Space space, uint16_t address, uint8_t access, uint8_t value);
+    void Break(uint16_t pc);
+
+    void RebuildTraps();
+    void UpdateInstructionHook();
+
+    // One bit per CPU address
+    std::array<uint64_t, 1024> _execBits;
+    uint32_t _execCount;
+
+    // ACCESS_* bits per 256-byte page, set if any watchpoint touches it
+    std::array<uint8_t, 256> _cpuTraps;
+    std::array<uint8_t, 64> _ppuTraps;
+
+    std::vector<Watchpoint> _watchpoints;
+    int _nextWatchpointId;
+
+    bool _instructionHook; // Anything to do at instruction boundaries
+    bool _paused;
+    bool _pauseRequested;
+    bool _stepping;
+    uint32_t _stepsRemaining;
+    bool _skipBreakpoint;  // Don't re-trigger on the PC we resumed from
+
+    bool _hasPending;
+    BreakInfo _pending;    // Trigger waiting for the next boundary
+    BreakInfo _lastBreak;
+    BreakCallback _callback;
+};
+
+#endif // DEBUGGER_H
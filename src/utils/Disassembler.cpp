@@ -0,0 +1,119 @@
+#include <cstdio>
+
+#include "Disassembler.h"
+#include "bus/Bus.h"
+
+
+int Disassembler::FormatInstruction(uint16_t address, const uint8_t* bytes, char* buffer, size_t size)
+{
+    const OpcodeInfo& info = OPCODE_TABLE[bytes[0]];
+    const uint8_t op1 = bytes[1];
+    const uint16_t abs = bytes[1] | (bytes[2] << 8);
+
+    switch (info.mode)
+    {
+        case CPU::M_IMP: return std::snprintf(buffer, size, "%s", info.mnemonic);
+        case CPU::M_ACC: return std::snprintf(buffer, size, "%s A", info.mnemonic);
+        case CPU::M_IMM: return std::snprintf(buffer, size, "%s #$%02X", info.mnemonic, op1);
+        case CPU::M_ZP0: return std::snprintf(buffer, size, "%s $%02X", info.mnemonic, op1);
+        case CPU::M_ZPX: return std::snprintf(buffer, size, "%s $%02X,X", info.mnemonic, op1);
+        case CPU::M_ZPY: return std::snprintf(buffer, size, "%s $%02X,Y", info.mnemonic, op1);
+        case CPU::M_ABS: return std::snprintf(buffer, size, "%s $%04X", info.mnemonic, abs);
+        case CPU::M_ABX: return std::snprintf(buffer, size, "%s $%04X,X", info.mnemonic, abs);
+        case CPU::M_ABY: return std::snprintf(buffer, size, "%s $%04X,Y", info.mnemonic, abs);
+        case CPU::M_IND: return std::snprintf(buffer, size, "%s ($%04X)", info.mnemonic, abs);
+        case CPU::M_IZX: return std::snprintf(buffer, size, "%s ($%02X,X)", info.mnemonic, op1);
+        case CPU::M_IZY: return std::snprintf(buffer, size, "%s ($%02X),Y", info.mnemonic, op1);
+        case CPU::M_REL:
+            return std::snprintf(buffer, size, "%s $%04X", info.mnemonic,
+                                 (uint16_t) (address + 2 + (int8_t) op1));
+    }
+
+    return std::snprintf(buffer, size, "%s", info.mnemonic);
+}
+
+int Disassembler::FormatLine(uint16_t address, const uint8_t* bytes, char* buffer, size_t size)
+{
+    char text[32];
+    FormatInstruction(address, bytes, text, sizeof(text));
+
+    switch (OPCODE_TABLE[bytes[0]].length)
+    {
+        case 1:
+            return std::snprintf(buffer, size, "%04X  %02X        %s", address, bytes[0], text);
+        case 2:
+            return std::snprintf(buffer, size, "%04X  %02X %02X     %s", address, bytes[0], bytes[1], text);
+        default:
+            return std::snprintf(buffer, size, "%04X  %02X %02X %02X  %s",
+                                 address, bytes[0], bytes[1], bytes[2], text);
+    }
+}
+
+int Disassembler::Disassemble(Bus& bus, uint16_t address, char* buffer, size_t size)
+{
+    uint8_t bytes[3] = { bus.CPUPeek(address), 0, 0 };
+
+    int length = OPCODE_TABLE[bytes[0]].length;
+    for (int i = 1; i < length; ++i)
+        bytes[i] = bus.CPUPeek(address + i);
+
+    return FormatLine(address, bytes, buffer, size);
+}
+
+const char* Disassembler::GetModeName(CPU::AddressingMode mode)
+{
+    switch (mode)
+    {
+        case CPU::M_IMP: return "IMP";
+        case CPU::M_ACC: return "ACC";
+        case CPU::M_IMM: return "IMM";
+        case CPU::M_ZP0: return "ZP0";
+        case CPU::M_ZPX: return "ZPX";
+        case CPU::M_ZPY: return "ZPY";
+        case CPU::M_REL: return "REL";
+        case CPU::M_ABS: return "ABS";
+        case CPU::M_ABX: return "ABX";
+        case CPU::M_ABY: return "ABY";
+        case CPU::M_IND: return "IND";
+        case CPU::M_IZX: return "IZX";
+        case CPU::M_IZY: return "IZY";
+    }
+    return "???";
+}
+
+std::string Disassembler::Disassemble(CPU& cpu, uint16_t address)
+{
+    uint8_t bytes[3] = { cpu.PeekMemory(address), 0, 0 };
+
+    int length = OPCODE_TABLE[bytes[0]].length;
+    for (int i = 1; i < length; ++i)
+        bytes[i] = cpu.PeekMemory(address + i);
+
+    char line[64];
+    FormatLine(address, bytes, line, sizeof(line));
+    return line;
+}
+
+std::string Disassembler::FormatInstruction(uint16_t address, const uint8_t* bytes)
+{
+    char text[32];
+    FormatInstruction(address, bytes, text, sizeof(text));
+    return text;
+}
+
+std::string Disassembler::LogState(CPU& cpu)
+{
+    char line[128];
+    int length = std::snprintf(line, sizeof(line), "%-48s", Disassemble(cpu, cpu.PC).c_str());
+
+    // PPU position derived from the CPU cycle count (3 dots per cycle)
+    uint64_t cycles = cpu.GetTotalCycles();
+    uint64_t dots = cycles * 3;
+
+    std::snprintf(line + length, sizeof(line) - length,
+                  "A:%02X X:%02X Y:%02X P:%02X SP:%02X PPU:%3d,%3d CYC:%llu\n",
+                  cpu.A, cpu.X, cpu.Y, cpu.P, cpu.SP,
+                  (int) ((dots / 341) % 262), (int) (dots % 341),
+                  (unsigned long long) cycles);
+    return line;
+}
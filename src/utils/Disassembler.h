@@ -1,172 +1,43 @@
 #ifndef DISASSEMBLER_H
 #define DISASSEMBLER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <sstream>
-#include <iomanip>
+
 #include "cpu/CPU.h"
-#include "cpu/Instructions.h"
+#include "cpu/OpcodeTable.h"
+
+
+// Forward declaration
+class Bus;
 
 
+// Table-driven 6502 disassembler.
+// The core routines format into caller-provided buffers and never allocate;
+// memory is read through Bus::CPUPeek so disassembling never disturbs
+// hardware state (e.g. clearing PPU vblank by touching $2002).
 class Disassembler
 {
 public:
-    static std::string Disassemble(CPU& cpu, uint16_t address)
-    {
-        uint8_t opcode = cpu.ReadMemory(address);
-        const Instruction& instr = INSTRUCTION_TABLE[opcode];
-
-        std::ostringstream oss;
-        oss << std::hex << std::uppercase << std::setfill('0');
-
-        // Address
-        oss << std::setw(4) << address << "  ";
-
-        // Opcde bytes
-        oss << std::setw(2) << (int) opcode << "  ";
-
-        // Operand bytes (depends on addressing mode)
-        int bytes = GetInstructionBytes(instr.addrMode);
-        for (int i = 0; i < bytes; ++i)
-        {
-            oss << std::setw(2) << (int) cpu.ReadMemory(address + i) << " ";
-        }
-
-        // Padding
-        for (int i = bytes; i < 3; ++i)
-        {
-            oss << "   ";
-        }
-
-        // Mnemonic
-        oss << " " << instr.name << " ";
-
-        // Operand format
-        oss << FormatOperand(cpu, address, instr.addrMode);
-        
-        return oss.str();
-    }
-    
-    static std::string LogState(CPU& cpu)
-    {
-        std::ostringstream oss;
-        oss << std::hex << std::uppercase << std::setfill('0');
-        
-        uint16_t pc = cpu.PC;
-        auto addrmode = INSTRUCTION_TABLE[cpu.GetOpcode()].addrMode;
-
-        // PC and opcode bytes
-        oss << std::setw(4) << pc << "  ";
-        
-        int length = GetInstructionBytes(addrmode);
-        for (int i = 0; i < length; i++)
-        {
-            oss << std::setw(2) << (int)cpu.ReadMemory(pc + i) << " ";
-        }
-        
-        // Padding to align instruction (nestest uses 3 bytes max)
-        for (int i = length; i < 3; i++)
-        {
-            oss << "   ";
-        }
-        
-        // Instruction
-        oss << std::hex << std::uppercase << std::setfill(' ');
-        oss << " " << std::setw(32) << std::left << FormatOperand(cpu, pc, addrmode);
-        
-        // Registers
-        oss << "A:"  << std::setw(2) << std::setfill('0') << std::right << (int)cpu.A << " ";
-        oss << "X:"  << std::setw(2) << std::setfill('0') << std::right << (int)cpu.X << " ";
-        oss << "Y:"  << std::setw(2) << std::setfill('0') << std::right << (int)cpu.Y << " ";
-        oss << "P:"  << std::setw(2) << std::setfill('0') << std::right << (int)cpu.P << " ";
-        oss << "SP:" << std::setw(2) << std::setfill('0') << std::right << (int)cpu.SP << " ";
+    // Instruction text from raw bytes (opcode first), e.g. "LDA $0200,X"
+    static int FormatInstruction(uint16_t address, const uint8_t* bytes, char* buffer, size_t size);
 
-        // PPU
-        uint64_t ppu_cycles = cpu.GetTotalCycles() * 3;
+    // Listing line, e.g. "8000  BD 00 02  LDA $0200,X"
+    static int FormatLine(uint16_t address, const uint8_t* bytes, char* buffer, size_t size);
 
-        int scanline = (ppu_cycles / 341) % 262;
-        int dot = ppu_cycles % 341;
+    // Listing line for the instruction at address, read without side effects
+    static int Disassemble(Bus& bus, uint16_t address, char* buffer, size_t size);
 
-        oss << "PPU:"
-            << std::dec << std::setw(3) << std::setfill(' ') << std::right
-            << scanline << ","
-            << std::dec << std::setw(3) << std::setfill(' ') << std::right
-            << dot << " ";
-        
-        // Cycles (PPU cycles = CPU cycles * 3)
-        oss << "CYC:" << std::dec << cpu.GetTotalCycles() << std::endl;
-        
-        return oss.str();
-    }
+    static int GetInstructionLength(uint8_t opcode) { return OPCODE_TABLE[opcode].length; }
 
-private:
-    static int GetInstructionBytes(AddressModeFunc addrMode)
-    {
-        // Return instruction length based on addressing mode
-        if (addrMode == &CPU::IMP) return 1;
-        if (addrMode == &CPU::IMM) return 2;
-        if (addrMode == &CPU::ZP0) return 2;
-        if (addrMode == &CPU::ZPX) return 2;
-        if (addrMode == &CPU::ZPY) return 2;
-        if (addrMode == &CPU::REL) return 2;
-        if (addrMode == &CPU::ABS) return 3;
-        if (addrMode == &CPU::ABX) return 3;
-        if (addrMode == &CPU::ABY) return 3;
-        if (addrMode == &CPU::IND) return 3;
-        if (addrMode == &CPU::IZX) return 2;
-        if (addrMode == &CPU::IZY) return 2;
-        return 1;
-    }
+    // Name of an addressing mode ("IMM", "ABX", ...)
+    static const char* GetModeName(CPU::AddressingMode mode);
 
-    static std::string FormatOperand(CPU& cpu, uint16_t address, AddressModeFunc addrMode)
-    {
-        std::ostringstream oss;
-        oss << std::hex << std::uppercase << std::setfill('0');
-        
-        if (addrMode == &CPU::IMP) {
-            return "";
-        } else if (addrMode == &CPU::IMM) {
-            uint8_t value = cpu.ReadMemory(address + 1);
-            oss << "#$" << std::setw(2) << (int)value;
-        } else if (addrMode == &CPU::ZP0) {
-            uint8_t addr = cpu.ReadMemory(address + 1);
-            oss << "$" << std::setw(2) << (int)addr;
-        } else if (addrMode == &CPU::ZPX) {
-            uint8_t addr = cpu.ReadMemory(address + 1);
-            oss << "$" << std::setw(2) << (int)addr << ",X";
-        } else if (addrMode == &CPU::ZPY) {
-            uint8_t addr = cpu.ReadMemory(address + 1);
-            oss << "$" << std::setw(2) << (int)addr << ",Y";
-        } else if (addrMode == &CPU::ABS) {
-            uint16_t addr = cpu.ReadMemory(address + 1) | 
-                           (cpu.ReadMemory(address + 2) << 8);
-            oss << "$" << std::setw(4) << addr;
-        } else if (addrMode == &CPU::ABX) {
-            uint16_t addr = cpu.ReadMemory(address + 1) | 
-                           (cpu.ReadMemory(address + 2) << 8);
-            oss << "$" << std::setw(4) << addr << ",X";
-        } else if (addrMode == &CPU::ABY) {
-            uint16_t addr = cpu.ReadMemory(address + 1) | 
-                           (cpu.ReadMemory(address + 2) << 8);
-            oss << "$" << std::setw(4) << addr << ",Y";
-        } else if (addrMode == &CPU::IND) {
-            uint16_t addr = cpu.ReadMemory(address + 1) | 
-                           (cpu.ReadMemory(address + 2) << 8);
-            oss << "($" << std::setw(4) << addr << ")";
-        } else if (addrMode == &CPU::IZX) {
-            uint8_t addr = cpu.ReadMemory(address + 1);
-            oss << "($" << std::setw(2) << (int)addr << ",X)";
-        } else if (addrMode == &CPU::IZY) {
-            uint8_t addr = cpu.ReadMemory(address + 1);
-            oss << "($" << std::setw(2) << (int)addr << "),Y";
-        } else if (addrMode == &CPU::REL) {
-            int8_t offset = cpu.ReadMemory(address + 1);
-            uint16_t target = address + 2 + offset;
-            oss << "$" << std::setw(4) << target;
-        }
-        
-        return oss.str();
-    }
+    // std::string conveniences for tools and tests (allocate; avoid in hot paths)
+    static std::string Disassemble(CPU& cpu, uint16_t address);
+    static std::string FormatInstruction(uint16_t address, const uint8_t* bytes);
+    static std::string LogState(CPU& cpu);
 };
 
-#endif // DISASSEMBLER_H
\ No newline at end of file
+#endif // DISASSEMBLER_H
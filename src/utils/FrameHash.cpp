@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+#include "FrameHash.h"
+#include "Hash.h"
+#include "machine/Machine.h"
+#include "utils/Logger.h"
+
+
+// CPU-visible RAM ($0000-$1FFF; the flat memory doesn't fold the mirrors)
+static constexpr size_t RAM_HASH_SIZE = 0x2000;
+
+
+bool InputScript::Load(const std::string& filename)
+{
+    FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open input script: %s", filename.c_str());
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0; )
+        text.append(buffer, n);
+    std::fclose(file);
+
+    if (!Parse(text.data(), text.size()))
+    {
+        LOG_ERROR("Invalid input script: %s", filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InputScript::Parse(const char* text, size_t length)
+{
+    _events.clear();
+
+    const char* end = text + length;
+    for (const char* line = text; line < end; )
+    {
+        const char* eol = std::find(line, end, '\n');
+        std::string s(line, std::find(line, eol, '#'));
+        line = eol + 1;
+
+        if (s.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        unsigned long long frame;
+        unsigned pad1, pad2 = 0;
+        int fields = std::sscanf(s.c_str(), "%llu %x %x", &frame, &pad1, &pad2);
+        if (fields < 2 || pad1 > 0xFF || pad2 > 0xFF)
+            return false;
+
+        _events.push_back({ frame, { (uint8_t) pad1, (uint8_t) pad2 } });
+    }
+
+    std::stable_sort(_events.begin(), _events.end(),
+        [](const Event& a, const Event& b) { return a.frame < b.frame; });
+
+    return true;
+}
+
+uint8_t InputScript::GetState(int pad, uint64_t frame) const
+{
+    // Last event at or before this frame
+    auto it = std::upper_bound(_events.begin(), _events.end(), frame,
+        [](uint64_t f, const Event& e) { return f < e.frame; });
+
+    return it == _events.begin() ? 0 : (it - 1)->pads[pad & 1];
+}
+
+
+FrameHash FrameHash::Capture(Machine& machine)
+{
+    FrameHash hash;
+    hash.screen = Hash::XXH64(machine.GetPPU().GetScreenBuffer(), PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT);
+    uint8_t ram[RAM_HASH_SIZE];
+    machine.GetMemory().CopyTo(0x0000, ram, RAM_HASH_SIZE);
+    hash.ram = Hash::XXH64(ram, RAM_HASH_SIZE);
+    return hash;
+}
+
+void FrameHash::Run(Machine& machine, uint32_t frames, const InputScript* input, std::vector<FrameHash>& hashes)
+{
+    hashes.reserve(hashes.size() + frames);
+
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        if (input)
+        {
+            uint64_t frame = machine.GetFrameCount();
+            machine.SetControllerState(0, input->GetState(0, frame));
+            machine.SetControllerState(1, input->GetState(1, frame));
+        }
+
+        machine.RunFrame();
+        hashes.push_back(Capture(machine));
+    }
+}
+
+bool FrameHash::Save(const std::string& filename, const std::vector<FrameHash>& hashes)
+{
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file)
+    {
+        LOG_ERROR("Failed to create golden file: %s", filename.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "# frame screen ram\n");
+    for (size_t i = 0; i < hashes.size(); ++i)
+        std::fprintf(file, "%zu %016" PRIx64 " %016" PRIx64 "\n", i, hashes[i].screen, hashes[i].ram);
+
+    return std::fclose(file) == 0;
+}
+
+bool FrameHash::Load(const std::string& filename, std::vector<FrameHash>& hashes)
+{
+    FILE* file = std::fopen(filename.c_str(), "r");
+    if (!file)
+        return false;
+
+    hashes.clear();
+
+    char line[128];
+    bool ok = true;
+    while (ok && std::fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+
+        size_t frame;
+        FrameHash hash;
+        ok = std::sscanf(line, "%zu %" SCNx64 " %" SCNx64, &frame, &hash.screen, &hash.ram) == 3
+            && frame == hashes.size();
+        hashes.push_back(hash);
+    }
+
+    std::fclose(file);
+
+    if (!ok)
+        LOG_ERROR("Invalid golden file: %s", filename.c_str());
+
+    return ok;
+}
+
+long FrameHash::FindMismatch(const std::vector<FrameHash>& a, const std::vector<FrameHash>& b)
+{
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (a[i] != b[i])
+            return (long) i;
+    }
+
+    return -1;
+}
@@ -0,0 +1,64 @@
+#ifndef FRAME_HASH_H
+#define FRAME_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Machine;
+
+
+// Scripted controller input for headless runs.
+// Text format, one change per line: `<frame> <pad1> [<pad2>]` with the pad
+// states in hex (Controller::Button bits); a state holds until the next line.
+// '#' starts a comment.
+class InputScript
+{
+public:
+    bool Load(const std::string& filename);
+    bool Parse(const char* text, size_t length);
+
+    // Pad state for the given frame
+    uint8_t GetState(int pad, uint64_t frame) const;
+
+    bool IsEmpty() const { return _events.empty(); }
+
+private:
+    struct Event
+    {
+        uint64_t frame;
+        uint8_t pads[2];
+    };
+
+    // Sorted by frame
+    std::vector<Event> _events;
+};
+
+
+// Per-frame digest of the visible output and CPU RAM.
+// Golden files store one line per frame (`<frame> <screen> <ram>` in hex),
+// so two runs can be proven identical without keeping any images.
+struct FrameHash
+{
+    uint64_t screen;
+    uint64_t ram;
+
+    bool operator==(const FrameHash& other) const { return screen == other.screen && ram == other.ram; }
+    bool operator!=(const FrameHash& other) const { return !(*this == other); }
+
+    // Hash the current screen buffer and RAM
+    static FrameHash Capture(Machine& machine);
+
+    // Run `frames` frames from the machine's current state, applying the
+    // script before each one, and append a hash per frame
+    static void Run(Machine& machine, uint32_t frames, const InputScript* input, std::vector<FrameHash>& hashes);
+
+    static bool Save(const std::string& filename, const std::vector<FrameHash>& hashes);
+    static bool Load(const std::string& filename, std::vector<FrameHash>& hashes);
+
+    // Index of the first differing frame, or -1 if the common prefix matches
+    static long FindMismatch(const std::vector<FrameHash>& a, const std::vector<FrameHash>& b);
+};
+
+#endif // FRAME_HASH_H
@@ -0,0 +1,103 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+// XXH64 (xxHash, 64-bit): fast non-cryptographic content hash.
+// Four independent lanes keep the multiplier pipeline busy, so it runs near
+// memory bandwidth on mmapped ROM data. Output matches the reference
+// implementation (seed 0: "" -> EF46DB3751D8E999).
+namespace Hash
+{
+
+namespace Detail
+{
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline uint64_t Read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+    inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+    inline uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME2;
+        acc = Rotl(acc, 31);
+        return acc * PRIME1;
+    }
+
+    inline uint64_t Merge(uint64_t acc, uint64_t value)
+    {
+        acc ^= Round(0, value);
+        return acc * PRIME1 + PRIME4;
+    }
+}
+
+inline uint64_t XXH64(const void* data, size_t length, uint64_t seed = 0)
+{
+    using namespace Detail;
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + length;
+    uint64_t h;
+
+    if (length >= 32)
+    {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+
+        const uint8_t* limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = Merge(h, v1);
+        h = Merge(h, v2);
+        h = Merge(h, v3);
+        h = Merge(h, v4);
+    }
+    else
+    {
+        h = seed + PRIME5;
+    }
+
+    h += (uint64_t) length;
+
+    for (; p + 8 <= end; p += 8)
+        h = Rotl(h ^ Round(0, Read64(p)), 27) * PRIME1 + PRIME4;
+
+    if (p + 4 <= end)
+    {
+        h = Rotl(h ^ ((uint64_t) Read32(p) * PRIME1), 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+
+    for (; p < end; ++p)
+        h = Rotl(h ^ (*p * PRIME5), 11) * PRIME1;
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace Hash
+
+#endif // HASH_H
@@ -2,6 +2,9 @@
 #include <iostream>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <algorithm>
+#include <ctime>
 
 Logger::Logger()
     : currentLevel(LogLevel::INFO),
@@ -10,13 +13,34 @@ Logger::Logger()
       timestamps(true),
       initialized(false),
       logCount(0),
-      errorCount(0)
+      errorCount(0),
+      dropCount(0),
+      ring(new Slot[RING_CAPACITY]),
+      enqueuePos(0),
+      dequeuePos(0),
+      writtenPos(0),
+      stopRequested(false),
+      writerSleeping(false),
+      logFile(nullptr),
+      reportedDrops(0)
 {
+    for (size_t i = 0; i < RING_CAPACITY; ++i)
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+
+    consoleBatch.reserve(BATCH_SIZE + SLOT_TEXT_SIZE);
+    fileBatch.reserve(BATCH_SIZE + SLOT_TEXT_SIZE);
+
+    writer = std::thread(&Logger::WriterThread, this);
 }
 
 Logger::~Logger()
 {
     Shutdown();
+
+    stopRequested.store(true);
+    WakeWriter();
+    if (writer.joinable())
+        writer.join();
 }
 
 Logger& Logger::GetInstance()
@@ -27,18 +51,20 @@ Logger& Logger::GetInstance()
 
 void Logger::Initialize(const std::string& filename, LogLevel level)
 {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
     if (initialized)
     {
         Shutdown();
     }
     
-    logFile.open(filename, std::ios::out | std::ios::trunc);
-    if (!logFile.is_open())
     {
-        std::cerr << "Failed to open log file: " << filename << std::endl;
-        return;
+        std::lock_guard<std::mutex> lock(outputMutex);
+
+        logFile = std::fopen(filename.c_str(), "w");
+        if (!logFile)
+        {
+            std::cerr << "Failed to open log file: " << filename << std::endl;
+            return;
+        }
     }
     
     currentLevel = level;
@@ -46,23 +72,33 @@ void Logger::Initialize(const std::string& filename, LogLevel level)
     initialized = true;
     
     LOG_INFO("=== Logger initialized ===");
-    LOG_INFO("Log file: %s", filename);
+    LOG_INFO("Log file: %s", filename.c_str());
     LOG_INFO("Log level: %s", GetLevelString(level));
 }
 
 void Logger::Shutdown()
 {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    if (initialized && logFile.is_open())
+    if (initialized)
     {
         LOG_INFO("=== Logger shutdown ===");
-        logFile.close();
+        Flush();
+        CloseFile();
     }
     
     initialized = false;
 }
 
+void Logger::CloseFile()
+{
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    if (logFile)
+    {
+        std::fclose(logFile);
+        logFile = nullptr;
+    }
+}
+
 void Logger::SetLogLevel(LogLevel level)
 {
     currentLevel = level;
@@ -83,59 +119,280 @@ void Logger::SetTimestamps(bool enabled)
     timestamps = enabled;
 }
 
-void Logger::Log(LogLevel level, const char* file, int line, const char* func, const std::string& message)
+// ============================================================================
+// PRODUCER SIDE
+// ============================================================================
+
+// Per-thread line buffer, so formatting never allocates or contends
+static thread_local char tlsLine[512];
+
+size_t Logger::FormatPrefix(char* buffer, size_t size, LogLevel level, const char* file, int line, const char* func) const
+{
+    int length = 0;
+
+    if (timestamps.load(std::memory_order_relaxed))
+    {
+        // localtime_r is comparatively slow; redo it once per second per thread
+        static thread_local time_t cachedSecond = -1;
+        static thread_local char cachedClock[16];
+
+        auto now = std::chrono::system_clock::now();
+        time_t seconds = std::chrono::system_clock::to_time_t(now);
+        int ms = (int) (std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count() % 1000);
+
+        if (seconds != cachedSecond)
+        {
+            struct tm local;
+            localtime_r(&seconds, &local);
+            std::strftime(cachedClock, sizeof(cachedClock), "%H:%M:%S", &local);
+            cachedSecond = seconds;
+        }
+
+        length = std::snprintf(buffer, size, "[%s.%03d] ", cachedClock, ms);
+    }
+
+    length += std::snprintf(buffer + length, size - length, "[%s] [%s:%d:%s] ",
+                            GetLevelString(level), file, line, func);
+
+    return std::min((size_t) length, size - 1);
+}
+
+void Logger::Log(LogLevel level, const char* file, int line, const char* func, const char* message)
 {
     // Check if we should log this level
-    if (level < currentLevel)
+    if (level < currentLevel.load(std::memory_order_relaxed))
         return;
-    
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    std::string formattedMessage = FormatMessage(level, file, line, func, message);
-    
-    // Output to console
-    if (consoleOutput)
+
+    size_t length = FormatPrefix(tlsLine, sizeof(tlsLine), level, file, line, func);
+    int written = std::snprintf(tlsLine + length, sizeof(tlsLine) - length, "%s", message);
+    length = std::min(length + (size_t) std::max(written, 0), sizeof(tlsLine) - 1);
+
+    Enqueue(level, tlsLine, length);
+}
+
+void Logger::LogV(LogLevel level, const char* file, int line, const char* func, const char* format, va_list args)
+{
+    if (level < currentLevel.load(std::memory_order_relaxed))
+        return;
+
+    size_t length = FormatPrefix(tlsLine, sizeof(tlsLine), level, file, line, func);
+    int written = std::vsnprintf(tlsLine + length, sizeof(tlsLine) - length, format, args);
+    length = std::min(length + (size_t) std::max(written, 0), sizeof(tlsLine) - 1);
+
+    Enqueue(level, tlsLine, length);
+}
+
+bool Logger::TryEnqueue(LogLevel level, const char* text, size_t length)
+{
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;)
     {
-        if (level >= LogLevel::ERROR)
-            std::cerr << formattedMessage << std::endl;
+        slot = &ring[pos & (RING_CAPACITY - 1)];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t) sequence - (int64_t) pos;
+
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false; // Full
+        }
         else
-            std::cout << formattedMessage << std::endl;
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
     }
-    
-    // Output to file
-    if (fileOutput && logFile.is_open())
+
+    length = std::min(length, SLOT_TEXT_SIZE);
+    std::memcpy(slot->text, text, length);
+    slot->length = (uint32_t) length;
+    slot->level = level;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::Enqueue(LogLevel level, const char* text, size_t length)
+{
+    if (!TryEnqueue(level, text, length))
     {
-        logFile << formattedMessage << std::endl;
+        if (level < LogLevel::ERROR)
+        {
+            // Drop policy: lose the newest low-priority line, never block the caller
+            dropCount.fetch_add(1, std::memory_order_relaxed);
+            WakeWriter();
+            return;
+        }
+
+        // Errors are never dropped: wait for the writer to make room
+        do {
+            WakeWriter();
+            std::this_thread::yield();
+        } while (!TryEnqueue(level, text, length));
     }
-    
-    logCount++;
+
+    logCount.fetch_add(1, std::memory_order_relaxed);
+
     if (level >= LogLevel::ERROR)
-        errorCount++;
+    {
+        errorCount.fetch_add(1, std::memory_order_relaxed);
+        WakeWriter();
+    }
+
+    if (level == LogLevel::FATAL)
+        Flush();
 }
 
-std::string Logger::FormatMessage(LogLevel level, const char* file, int line, const char* func, const std::string& message) const
+void Logger::WakeWriter()
 {
-    std::ostringstream oss;
-    
-    // Timestamp
-    if (timestamps)
+    if (writerSleeping.load(std::memory_order_acquire))
     {
-        oss << "[" << GetTimestamp() << "] ";
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
     }
-    
-    // Level
-    oss << "[" << GetLevelString(level) << "] ";
+}
+
+void Logger::Flush()
+{
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
 
-    // File & Line & Function
-    oss << "[" << file << ":" << line << ":" << func << "] ";
+    std::unique_lock<std::mutex> lock(flushMutex);
+    while (writtenPos.load(std::memory_order_acquire) < target)
+    {
+        WakeWriter();
+        flushCondition.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
 
-    // Message
-    oss << message;
-    
-    return oss.str();
+// ============================================================================
+// WRITER SIDE
+// ============================================================================
+
+void Logger::WriterThread()
+{
+    for (;;)
+    {
+        if (Drain() > 0)
+            continue;
+
+        if (stopRequested.load())
+            break;
+
+        // Nothing queued: sleep until woken (errors, flush, full ring) or
+        // the next periodic drain
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true, std::memory_order_release);
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(5));
+        writerSleeping.store(false, std::memory_order_release);
+    }
 }
 
-std::string Logger::GetLevelString(LogLevel level) const
+size_t Logger::Drain()
+{
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    const bool toConsole = consoleOutput.load(std::memory_order_relaxed);
+    const bool toFile = fileOutput.load(std::memory_order_relaxed) && logFile;
+
+    auto flushConsole = [this]() {
+        if (!consoleBatch.empty())
+        {
+            std::fwrite(consoleBatch.data(), 1, consoleBatch.size(), stdout);
+            consoleBatch.clear();
+        }
+    };
+
+    auto flushFile = [this]() {
+        if (!fileBatch.empty())
+        {
+            std::fwrite(fileBatch.data(), 1, fileBatch.size(), logFile);
+            fileBatch.clear();
+        }
+    };
+
+    size_t count = 0;
+
+    for (;;)
+    {
+        Slot& slot = ring[dequeuePos & (RING_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+            break;
+
+        if (toConsole)
+        {
+            if (slot.level >= LogLevel::ERROR)
+            {
+                // Keep stdout/stderr interleaving in order
+                flushConsole();
+                std::fflush(stdout);
+                std::fwrite(slot.text, 1, slot.length, stderr);
+                std::fputc('\n', stderr);
+            }
+            else
+            {
+                consoleBatch.append(slot.text, slot.length);
+                consoleBatch.push_back('\n');
+                if (consoleBatch.size() >= BATCH_SIZE)
+                    flushConsole();
+            }
+        }
+
+        if (toFile)
+        {
+            fileBatch.append(slot.text, slot.length);
+            fileBatch.push_back('\n');
+            if (fileBatch.size() >= BATCH_SIZE)
+                flushFile();
+        }
+
+        slot.sequence.store(dequeuePos + RING_CAPACITY, std::memory_order_release);
+        dequeuePos++;
+        count++;
+    }
+
+    // Report drops in-band so the gap is visible in the log itself
+    uint64_t drops = dropCount.load(std::memory_order_relaxed);
+    if (drops != reportedDrops)
+    {
+        char notice[96];
+        int length = std::snprintf(notice, sizeof(notice),
+                                   "[WARN ] [Logger] %llu log messages dropped (ring full)\n",
+                                   (unsigned long long) (drops - reportedDrops));
+        if (toConsole)
+            consoleBatch.append(notice, length);
+        if (toFile)
+            fileBatch.append(notice, length);
+        reportedDrops = drops;
+    }
+
+    if (toConsole)
+    {
+        flushConsole();
+        std::fflush(stdout);
+    }
+
+    if (toFile)
+    {
+        flushFile();
+        std::fflush(logFile);
+    }
+
+    if (count > 0)
+    {
+        std::lock_guard<std::mutex> flushLock(flushMutex);
+        writtenPos.store(dequeuePos, std::memory_order_release);
+        flushCondition.notify_all();
+    }
+
+    return count;
+}
+
+const char* Logger::GetLevelString(LogLevel level) const
 {
     switch (level)
     {
@@ -149,110 +406,84 @@ std::string Logger::GetLevelString(LogLevel level) const
     }
 }
 
-std::string Logger::GetTimestamp() const
-{
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time), "%H:%M:%S");
-    oss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    
-    return oss.str();
-}
-
 // Log level methods
 void Logger::Trace(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::TRACE, file, line, func, message);
+    Log(LogLevel::TRACE, file, line, func, message.c_str());
 }
 
 void Logger::Debug(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::DEBUG, file, line, func, message);
+    Log(LogLevel::DEBUG, file, line, func, message.c_str());
 }
 
 void Logger::Info(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::INFO, file, line, func, message);
+    Log(LogLevel::INFO, file, line, func, message.c_str());
 }
 
 void Logger::Warn(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::WARN, file, line, func, message);
+    Log(LogLevel::WARN, file, line, func, message.c_str());
 }
 
 void Logger::Error(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::ERROR, file, line, func, message);
+    Log(LogLevel::ERROR, file, line, func, message.c_str());
 }
 
 void Logger::Fatal(const char* file, int line, const char* func, const std::string& message)
 {
-    Log(LogLevel::FATAL, file, line, func, message);
+    Log(LogLevel::FATAL, file, line, func, message.c_str());
 }
 
 // Formatted logging using variadic arguments
 void Logger::TraceF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::TRACE, file, line, func, format, args);
     va_end(args);
-    Trace(file, line, func, buffer);
 }
 
 void Logger::DebugF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::DEBUG, file, line, func, format, args);
     va_end(args);
-    Debug(file, line, func, buffer);
 }
 
 void Logger::InfoF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::INFO, file, line, func, format, args);
     va_end(args);
-    Info(file, line, func, buffer);
 }
 
 void Logger::WarnF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::WARN, file, line, func, format, args);
     va_end(args);
-    Warn(file, line, func, buffer);
 }
 
 void Logger::ErrorF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::ERROR, file, line, func, format, args);
     va_end(args);
-    Error(file, line, func, buffer);
 }
 
 void Logger::FatalF(const char* file, int line, const char* func, const char* format, ...)
 {
-    char buffer[1024];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    LogV(LogLevel::FATAL, file, line, func, format, args);
     va_end(args);
-    Fatal(file, line, func, buffer);
 }
 
 // CPU instruction logging (nestest compatible format)
@@ -261,41 +492,17 @@ void Logger::LogCPUInstruction(uint16_t pc, uint8_t opcode,
                                uint8_t sp, uint8_t status,
                                const std::string& disassembly)
 {
-    if (currentLevel > LogLevel::TRACE)
+    if (currentLevel.load(std::memory_order_relaxed) > LogLevel::TRACE)
         return;
     
-    std::lock_guard<std::mutex> lock(logMutex);
-    
     // Format: PC:$XXXX OP [disasm] A:XX X:XX Y:XX P:XX SP:XX
-    std::ostringstream oss;
-    
-    oss << std::hex << std::uppercase << std::setfill('0');
-    oss << std::setw(4) << pc << "  ";
-    oss << std::setw(4) << opcode << "  ";
-    oss << disassembly;
-    
-    // Pad to align registers
-    int padding = 48 - disassembly.length();
-    if (padding > 0)
-        oss << std::string(padding, ' ');
+    int padding = std::max(0, 48 - (int) disassembly.length());
+    int length = std::snprintf(tlsLine, sizeof(tlsLine),
+                               "%04X  %04X  %s%*sA:%02X X:%02X Y:%02X P:%02X SP:%02X",
+                               pc, opcode, disassembly.c_str(), padding, "",
+                               a, x, y, status, sp);
     
-    oss << "A:" << std::setw(2) << (int)a << " ";
-    oss << "X:" << std::setw(2) << (int)x << " ";
-    oss << "Y:" << std::setw(2) << (int)y << " ";
-    oss << "P:" << std::setw(2) << (int)status << " ";
-    oss << "SP:" << std::setw(2) << (int)sp;
-    
-    if (fileOutput && logFile.is_open())
-    {
-        logFile << oss.str() << std::endl;
-    }
-    
-    if (consoleOutput)
-    {
-        std::cout << oss.str() << std::endl;
-    }
-    
-    logCount++;
+    Enqueue(LogLevel::TRACE, tlsLine, std::min((size_t) std::max(length, 0), sizeof(tlsLine) - 1));
 }
 
 // PPU event logging
@@ -310,7 +517,7 @@ void Logger::LogPPUWrite(uint16_t address, uint8_t value)
     oss << "[PPU] Write $" << std::hex << std::uppercase 
         << std::setw(4) << std::setfill('0') << address
         << " = $" << std::setw(2) << (int)value;
-    LOG_TRACE("%s", oss.str());
+    LOG_TRACE("%s", oss.str().c_str());
 }
 
 void Logger::LogPPURead(uint16_t address, uint8_t value)
@@ -319,7 +526,7 @@ void Logger::LogPPURead(uint16_t address, uint8_t value)
     oss << "[PPU] Read $" << std::hex << std::uppercase 
         << std::setw(4) << std::setfill('0') << address
         << " = $" << std::setw(2) << (int)value;
-    LOG_TRACE("%s", oss.str());
+    LOG_TRACE("%s", oss.str().c_str());
 }
 
 // Memory access logging
@@ -329,7 +536,7 @@ void Logger::LogMemoryRead(uint16_t address, uint8_t value)
     oss << "[MEM] Read $" << std::hex << std::uppercase 
         << std::setw(4) << std::setfill('0') << address
         << " = $" << std::setw(2) << (int)value;
-    LOG_TRACE("%s", oss.str());
+    LOG_TRACE("%s", oss.str().c_str());
 }
 
 void Logger::LogMemoryWrite(uint16_t address, uint8_t value)
@@ -338,7 +545,7 @@ void Logger::LogMemoryWrite(uint16_t address, uint8_t value)
     oss << "[MEM] Write $" << std::hex << std::uppercase 
         << std::setw(4) << std::setfill('0') << address
         << " = $" << std::setw(2) << (int)value;
-    LOG_TRACE("%s", oss.str());
+    LOG_TRACE("%s", oss.str().c_str());
 }
 
 // Frame logging
@@ -346,14 +553,14 @@ void Logger::LogFrameStart(uint64_t frameNumber)
 {
     std::ostringstream oss;
     oss << "=== Frame " << std::dec << frameNumber << " START ===";
-    LOG_DEBUG("%s", oss.str());
+    LOG_DEBUG("%s", oss.str().c_str());
 }
 
 void Logger::LogFrameEnd(uint64_t frameNumber)
 {
     std::ostringstream oss;
     oss << "=== Frame " << std::dec << frameNumber << " END ===";
-    LOG_DEBUG("%s", oss.str());
+    LOG_DEBUG("%s", oss.str().c_str());
 }
 
 // Performance logging
@@ -362,15 +569,5 @@ void Logger::LogPerformance(const std::string& metric, double value)
     std::ostringstream oss;
     oss << "[PERF] " << metric << ": " << std::fixed 
         << std::setprecision(2) << value;
-    LOG_INFO("%s", oss.str());
+    LOG_INFO("%s", oss.str().c_str());
 }
-
-void Logger::Flush()
-{
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    if (logFile.is_open())
-    {
-        logFile.flush();
-    }
-}
\ No newline at end of file
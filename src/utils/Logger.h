@@ -2,12 +2,16 @@
 #define LOGGER_H
 
 #include <string>
-#include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <thread>
 
 // Log levels
 enum class LogLevel
@@ -20,6 +24,12 @@ enum class LogLevel
     FATAL = 5     // Fatal errors
 };
 
+// Asynchronous logger.
+// Callers format each line into a per-thread buffer and push it into a
+// bounded lock-free ring; a background thread drains the ring in batched
+// writes. When the ring is full, TRACE..WARN lines are dropped (and counted,
+// see GetDropCount()), while ERROR and FATAL wait for space so they are
+// never lost. FATAL additionally waits until it has been written out.
 class Logger
 {
 public:
@@ -82,15 +92,16 @@ public:
     // Performance logging
     void LogPerformance(const std::string& metric, double value);
     
-    // Flush logs to disk
+    // Block until everything logged so far has been written out
     void Flush();
     
     // Get statistics
-    uint64_t GetLogCount() const { return logCount; }
-    uint64_t GetErrorCount() const { return errorCount; }
+    uint64_t GetLogCount() const { return logCount.load(std::memory_order_relaxed); }
+    uint64_t GetErrorCount() const { return errorCount.load(std::memory_order_relaxed); }
+    uint64_t GetDropCount() const { return dropCount.load(std::memory_order_relaxed); }
 
     // Cheap level check so call sites can skip expensive formatting
-    bool IsLevelEnabled(LogLevel level) const { return level >= currentLevel; }
+    bool IsLevelEnabled(LogLevel level) const { return level >= currentLevel.load(std::memory_order_relaxed); }
     
 private:
     Logger();
@@ -100,28 +111,72 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    // Internal log method
-    void Log(LogLevel level, const char* file, int line, const char* func, const std::string& message);
-    
+    // Ring geometry: 4096 slots of 512 bytes (2MB, allocated once)
+    static constexpr size_t RING_CAPACITY = 4096;
+    static constexpr size_t SLOT_TEXT_SIZE = 512 - 16;
+
+    // Console/file batches are written once this much has accumulated
+    static constexpr size_t BATCH_SIZE = 64 * 1024;
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        uint32_t length;
+        LogLevel level;
+        char text[SLOT_TEXT_SIZE];
+    };
+
+    // Internal log methods
+    void Log(LogLevel level, const char* file, int line, const char* func, const char* message);
+    void LogV(LogLevel level, const char* file, int line, const char* func, const char* format, va_list args);
+
+    // Format "[time] [LEVEL] [file:line:func] " into buffer, returns length
+    size_t FormatPrefix(char* buffer, size_t size, LogLevel level, const char* file, int line, const char* func) const;
+
+    // Push a finished line into the ring, applying the drop policy
+    void Enqueue(LogLevel level, const char* text, size_t length);
+    bool TryEnqueue(LogLevel level, const char* text, size_t length);
+
+    // Background writer
+    void WriterThread();
+    size_t Drain();
+    void WakeWriter();
+    void CloseFile();
+
     // Get level string
-    std::string GetLevelString(LogLevel level) const;
-    
-    // Get timestamp
-    std::string GetTimestamp() const;
-    
-    // Format message with level and timestamp
-    std::string FormatMessage(LogLevel level, const char* file, int line, const char* func, const std::string& message) const;
+    const char* GetLevelString(LogLevel level) const;
     
     // Member variables
-    std::ofstream logFile;
-    LogLevel currentLevel;
-    bool consoleOutput;
-    bool fileOutput;
-    bool timestamps;
+    std::atomic<LogLevel> currentLevel;
+    std::atomic<bool> consoleOutput;
+    std::atomic<bool> fileOutput;
+    std::atomic<bool> timestamps;
     bool initialized;
-    uint64_t logCount;
-    uint64_t errorCount;
-    std::mutex logMutex;  // Thread safety
+    std::atomic<uint64_t> logCount;
+    std::atomic<uint64_t> errorCount;
+    std::atomic<uint64_t> dropCount;
+
+    // Lock-free MPSC ring (Vyukov bounded queue)
+    std::unique_ptr<Slot[]> ring;
+    alignas(64) std::atomic<uint64_t> enqueuePos;
+    alignas(64) uint64_t dequeuePos;        // Writer thread only
+    std::atomic<uint64_t> writtenPos;       // Everything below has been written
+
+    // Writer thread state
+    std::thread writer;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> writerSleeping;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::mutex flushMutex;
+    std::condition_variable flushCondition;
+
+    // Output (guarded by outputMutex, taken by the writer per batch)
+    std::mutex outputMutex;
+    FILE* logFile;
+    std::string consoleBatch;
+    std::string fileBatch;
+    uint64_t reportedDrops;
 };
 
 // Check if a log level is enabled before formatting
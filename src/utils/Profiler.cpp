@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <vector>
+
+#include "Profiler.h"
+#include "bus/Bus.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+
+
+Profiler::Profiler(uint32_t interval)
+    : _interval(interval ? interval : 1),
+    _countdown(_interval),
+    _totalSamples(0)
+{
+    _samples.reserve(4096);
+}
+
+void Profiler::Sample(Bus& bus)
+{
+    CPU* cpu = bus.GetCPU();
+    if (!cpu)
+        return;
+
+    // Instructions execute on their first cycle, so attribute the sample to
+    // the instruction whose cycles are being spent, not the next one
+    uint16_t pc = cpu->GetOpcodeAddress();
+
+    int bank = -1;
+    Cartridge* cartridge = bus.GetCartridge();
+    if (cartridge && cartridge->IsLoaded())
+        bank = cartridge->GetPRGBank(pc);
+
+    auto result = _samples.try_emplace(MakeKey(pc, bank), Entry{ 0, { 0, 0, 0 } });
+    Entry& entry = result.first->second;
+
+    if (result.second)
+    {
+        entry.bytes[0] = bus.CPUPeek(pc);
+        int length = Disassembler::GetInstructionLength(entry.bytes[0]);
+        for (int i = 1; i < length; ++i)
+            entry.bytes[i] = bus.CPUPeek(pc + i);
+    }
+
+    entry.count++;
+    _totalSamples++;
+}
+
+void Profiler::Clear()
+{
+    _samples.clear();
+    _totalSamples = 0;
+    _countdown = _interval;
+}
+
+std::string Profiler::FormatLocation(uint32_t key, const Entry& entry, char separator) const
+{
+    uint16_t pc = key & 0xFFFF;
+    uint16_t bank = key >> 16;
+
+    char region[32];
+    if (bank != 0xFFFF)
+        std::snprintf(region, sizeof(region), "prg%cbank_%02X", separator, bank);
+    else if (pc < 0x2000)
+        std::snprintf(region, sizeof(region), "ram%c-", separator);
+    else if (0x6000 <= pc && pc < 0x8000)
+        std::snprintf(region, sizeof(region), "sram%c-", separator);
+    else
+        std::snprintf(region, sizeof(region), "flat%c-", separator);
+
+    char location[96];
+    std::snprintf(location, sizeof(location), "%s%c$%04X %s",
+                  region, separator, pc,
+                  Disassembler::FormatInstruction(pc, entry.bytes).c_str());
+
+    return location;
+}
+
+void Profiler::WriteCollapsed(FILE* out) const
+{
+    for (const auto& sample : _samples)
+    {
+        std::fprintf(out, "%s %llu\n",
+                     FormatLocation(sample.first, sample.second, ';').c_str(),
+                     (unsigned long long) sample.second.count);
+    }
+}
+
+bool Profiler::WriteCollapsed(const std::string& filename) const
+{
+    FILE* out = std::fopen(filename.c_str(), "w");
+    if (!out)
+    {
+        LOG_ERROR("Failed to open profile output: %s", filename.c_str());
+        return false;
+    }
+
+    WriteCollapsed(out);
+    std::fclose(out);
+
+    LOG_INFO("Profile (%llu samples) written to %s",
+             (unsigned long long) _totalSamples, filename.c_str());
+    return true;
+}
+
+void Profiler::WriteReport(FILE* out, size_t top) const
+{
+    std::vector<std::pair<uint32_t, const Entry*>> order;
+    order.reserve(_samples.size());
+    for (const auto& sample : _samples)
+        order.emplace_back(sample.first, &sample.second);
+
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.second->count > b.second->count;
+    });
+
+    std::fprintf(out, "# %llu samples, 1 per %u CPU cycles\n",
+                 (unsigned long long) _totalSamples, _interval);
+
+    for (size_t i = 0; i < order.size() && i < top; ++i)
+    {
+        const Entry& entry = *order[i].second;
+        std::fprintf(out, "%6.2f%%  %8llu  %s\n",
+                     _totalSamples ? 100.0 * entry.count / _totalSamples : 0.0,
+                     (unsigned long long) entry.count,
+                     FormatLocation(order[i].first, entry, ' ').c_str());
+    }
+}
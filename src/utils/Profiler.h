@@ -0,0 +1,74 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+
+// Forward declaration
+class Bus;
+
+
+// Sampling profiler for guest (6502) code.
+// Every N CPU cycles the bus hands us the system; we record the address of
+// the instruction being executed together with the PRG bank mapped there,
+// so the same $8000 address in different banks is kept apart.
+class Profiler
+{
+public:
+    // ~1 kHz of emulated time on NTSC
+    static constexpr uint32_t DEFAULT_INTERVAL = 1789;
+
+    explicit Profiler(uint32_t interval = DEFAULT_INTERVAL);
+
+    // Called by the bus once per CPU cycle
+    void Tick(Bus& bus)
+    {
+        if (--_countdown == 0)
+        {
+            _countdown = _interval;
+            Sample(bus);
+        }
+    }
+
+    // Take one sample right now
+    void Sample(Bus& bus);
+
+    void Clear();
+
+    uint64_t GetSampleCount() const { return _totalSamples; }
+    uint32_t GetInterval() const { return _interval; }
+
+    // Collapsed stacks ("region;bank;pc instruction count"), as consumed by
+    // flamegraph.pl / speedscope / inferno
+    void WriteCollapsed(FILE* out) const;
+    bool WriteCollapsed(const std::string& filename) const;
+
+    // Flat top-N listing with disassembly
+    void WriteReport(FILE* out, size_t top = 25) const;
+
+private:
+    struct Entry
+    {
+        uint64_t count;
+        uint8_t bytes[3]; // Instruction bytes captured on first sighting
+    };
+
+    // Key layout: bits 0-15 PC, bits 16-31 PRG bank (0xFFFF = not banked)
+    static uint32_t MakeKey(uint16_t pc, int bank)
+    {
+        return ((uint32_t) (bank & 0xFFFF) << 16) | pc;
+    }
+
+    std::string FormatLocation(uint32_t key, const Entry& entry, char separator) const;
+
+    uint32_t _interval;
+    uint32_t _countdown;
+    uint64_t _totalSamples;
+
+    std::unordered_map<uint32_t, Entry> _samples;
+};
+
+#endif // PROFILER_H
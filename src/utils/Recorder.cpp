@@ -0,0 +1,199 @@
+#include <algorithm>
+
+#include "Recorder.h"
+#include "ppu/Palette.h"
+#include "utils/Logger.h"
+
+
+// Large stdio buffer so the writer issues few, sequential write() calls
+static constexpr size_t FILE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+
+Recorder::Recorder()
+    : _file(nullptr),
+    _format(FORMAT_Y4M),
+    _backpressure(BACKPRESSURE_DROP),
+    _capacity(0),
+    _head(0),
+    _tail(0),
+    _writerWaiting(false),
+    _producerWaiting(false),
+    _stop(false),
+    _lut(),
+    _written(0),
+    _dropped(0)
+{}
+
+Recorder::~Recorder()
+{
+    Close();
+}
+
+bool Recorder::Open(const std::string& filename, Format format, Backpressure backpressure, size_t queueFrames)
+{
+    Close();
+
+    _file = std::fopen(filename.c_str(), "wb");
+    if (!_file)
+    {
+        LOG_ERROR("Failed to create recording: %s", filename.c_str());
+        return false;
+    }
+
+    _fileBuffer.resize(FILE_BUFFER_SIZE);
+    std::setvbuf(_file, _fileBuffer.data(), _IOFBF, _fileBuffer.size());
+
+    _format = format;
+    _backpressure = backpressure;
+    _capacity = queueFrames ? queueFrames : 1;
+    _slots.assign(_capacity * FRAME_SIZE, 0);
+    _converted.assign(FRAME_SIZE * 3, 0);
+    _head = 0;
+    _tail = 0;
+    _stop = false;
+    _written = 0;
+    _dropped = 0;
+
+    // Palette index -> output pixel, computed once
+    for (int i = 0; i < 64; ++i)
+    {
+        uint32_t argb = Palette::ARGB[i];
+        int r = (argb >> 16) & 0xFF;
+        int g = (argb >> 8) & 0xFF;
+        int b = argb & 0xFF;
+
+        if (format == FORMAT_Y4M)
+        {
+            // BT.601, limited range
+            _lut[i][0] = (uint8_t) ((( 66 * r + 129 * g +  25 * b + 128) >> 8) + 16);
+            _lut[i][1] = (uint8_t) (((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+            _lut[i][2] = (uint8_t) (((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+        }
+        else
+        {
+            _lut[i][0] = (uint8_t) r;
+            _lut[i][1] = (uint8_t) g;
+            _lut[i][2] = (uint8_t) b;
+        }
+    }
+
+    // NTSC frame rate: 39375000 / 655171 ~= 60.0988
+    if (format == FORMAT_Y4M)
+        std::fprintf(_file, "YUV4MPEG2 W%d H%d F39375000:655171 Ip A1:1 C444\n", WIDTH, HEIGHT);
+
+    _writer = std::thread(&Recorder::WriterLoop, this);
+    return true;
+}
+
+void Recorder::Close()
+{
+    if (!_file)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _frameReady.notify_one();
+    _writer.join();
+
+    std::fclose(_file);
+    _file = nullptr;
+
+    if (_dropped)
+        LOG_INFO("Recording closed: %llu frames written, %llu dropped",
+                 (unsigned long long) _written.load(), (unsigned long long) _dropped);
+}
+
+bool Recorder::PushFrame(const uint8_t* screen)
+{
+    uint64_t head = _head.load(std::memory_order_relaxed);
+
+    if (head - _tail.load(std::memory_order_acquire) >= _capacity)
+    {
+        if (_backpressure == BACKPRESSURE_DROP)
+        {
+            ++_dropped;
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _producerWaiting = true;
+        _slotFree.wait(lock, [&] { return head - _tail.load() < _capacity; });
+        _producerWaiting = false;
+    }
+
+    std::copy(screen, screen + FRAME_SIZE, &_slots[(head % _capacity) * FRAME_SIZE]);
+    _head.store(head + 1, std::memory_order_seq_cst);
+
+    if (_writerWaiting.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _frameReady.notify_one();
+    }
+
+    return true;
+}
+
+void Recorder::WriterLoop()
+{
+    for (;;)
+    {
+        uint64_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail == _head.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _writerWaiting = true;
+            _frameReady.wait(lock, [&] { return tail != _head.load() || _stop.load(); });
+            _writerWaiting = false;
+
+            if (tail == _head.load())
+                break; // Stopped and drained
+            continue;
+        }
+
+        WriteFrame(&_slots[(tail % _capacity) * FRAME_SIZE]);
+        _tail.store(tail + 1, std::memory_order_seq_cst);
+        _written.fetch_add(1, std::memory_order_relaxed);
+
+        if (_producerWaiting.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _slotFree.notify_one();
+        }
+    }
+
+    std::fflush(_file);
+}
+
+void Recorder::WriteFrame(const uint8_t* frame)
+{
+    uint8_t* out = _converted.data();
+
+    if (_format == FORMAT_Y4M)
+    {
+        // Planar: Y, then Cb, then Cr
+        for (size_t i = 0; i < FRAME_SIZE; ++i)
+        {
+            const uint8_t* yuv = _lut[frame[i] & 0x3F];
+            out[i] = yuv[0];
+            out[FRAME_SIZE + i] = yuv[1];
+            out[FRAME_SIZE * 2 + i] = yuv[2];
+        }
+
+        std::fputs("FRAME\n", _file);
+    }
+    else
+    {
+        for (size_t i = 0; i < FRAME_SIZE; ++i)
+        {
+            const uint8_t* rgb = _lut[frame[i] & 0x3F];
+            out[i * 3 + 0] = rgb[0];
+            out[i * 3 + 1] = rgb[1];
+            out[i * 3 + 2] = rgb[2];
+        }
+    }
+
+    std::fwrite(out, 1, _converted.size(), _file);
+}
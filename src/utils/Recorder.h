@@ -0,0 +1,93 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Background video capture.
+// The emulation thread hands each finished frame (palette indices) to a
+// preallocated ring of frame slots; a writer thread converts and writes
+// them sequentially through a large file buffer. PushFrame() is the only
+// per-frame cost on the emulation side: one 60KB copy and an atomic store.
+class Recorder
+{
+public:
+    enum Format
+    {
+        FORMAT_Y4M,   // YUV4MPEG2, 4:4:4 (ffmpeg/mpv read it directly)
+        FORMAT_RGB24  // Headerless RGB24 (-f rawvideo -pix_fmt rgb24 -s 256x240)
+    };
+
+    // What PushFrame does when the writer falls behind and the ring is full
+    enum Backpressure
+    {
+        BACKPRESSURE_DROP,  // Skip the frame (emulation speed wins)
+        BACKPRESSURE_BLOCK  // Wait for a free slot (every frame is kept)
+    };
+
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 240;
+    static constexpr size_t FRAME_SIZE = WIDTH * HEIGHT;
+
+    Recorder();
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    bool Open(const std::string& filename, Format format,
+              Backpressure backpressure = BACKPRESSURE_DROP, size_t queueFrames = 16);
+
+    // Drain the queue, stop the writer and close the file
+    void Close();
+
+    bool IsOpen() const { return _file != nullptr; }
+
+    // Queue a 256x240 frame of palette indices; false if it was dropped
+    bool PushFrame(const uint8_t* screen);
+
+    uint64_t GetWrittenFrames() const { return _written.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedFrames() const { return _dropped; }
+
+private:
+    void WriterLoop();
+    void WriteFrame(const uint8_t* frame);
+
+    FILE* _file;
+    std::vector<char> _fileBuffer;
+    Format _format;
+    Backpressure _backpressure;
+
+    // Single-producer/single-consumer ring of frame slots
+    std::vector<uint8_t> _slots;
+    size_t _capacity;
+    std::atomic<uint64_t> _head; // Next slot to fill (emulation thread)
+    std::atomic<uint64_t> _tail; // Next slot to write (writer thread)
+
+    // Sleep/wake: each side only takes the mutex when the other is waiting
+    std::mutex _mutex;
+    std::condition_variable _frameReady;
+    std::condition_variable _slotFree;
+    std::atomic<bool> _writerWaiting;
+    std::atomic<bool> _producerWaiting;
+    std::atomic<bool> _stop;
+
+    // Writer-side conversion scratch and palette lookup tables
+    std::vector<uint8_t> _converted;
+    uint8_t _lut[64][3];
+
+    std::atomic<uint64_t> _written;
+    uint64_t _dropped;
+
+    std::thread _writer;
+};
+
+#endif // RECORDER_H
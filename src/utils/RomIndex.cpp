@@ -0,0 +1,351 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unordered_map>
+
+#include "RomIndex.h"
+#include "Hash.h"
+#include "cartridge/RomHeader.h"
+#include "utils/Logger.h"
+
+
+namespace
+{
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t stringsSize;
+    };
+
+    constexpr char MAGIC[4] = { 'N', 'R', 'I', 'X' };
+
+    static_assert(sizeof(FileHeader) == 16, "index header layout");
+    static_assert(sizeof(RomIndex::Entry) == 48, "index entry layout");
+
+    int64_t ModificationTime(const struct stat& st)
+    {
+        return (int64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    bool IsRomFile(const std::filesystem::path& path)
+    {
+        std::string ext = path.extension().string();
+        return ext.size() == 4 && ext[0] == '.'
+            && (ext[1] | 0x20) == 'n' && (ext[2] | 0x20) == 'e' && (ext[3] | 0x20) == 's';
+    }
+}
+
+
+RomIndex::RomIndex()
+    : _entries(nullptr),
+    _strings(nullptr),
+    _stringsSize(0),
+    _count(0),
+    _mapping(nullptr),
+    _mappingSize(0),
+    _stats()
+{}
+
+RomIndex::~RomIndex()
+{
+    Clear();
+}
+
+void RomIndex::Clear()
+{
+    if (_mapping)
+    {
+        ::munmap(_mapping, _mappingSize);
+        _mapping = nullptr;
+        _mappingSize = 0;
+    }
+
+    _ownedEntries.clear();
+    _ownedStrings.clear();
+    _entries = nullptr;
+    _strings = nullptr;
+    _stringsSize = 0;
+    _count = 0;
+}
+
+std::string RomIndex::GetPath(const Entry& entry) const
+{
+    return std::string(_strings + entry.pathOffset, entry.pathLength);
+}
+
+const RomIndex::Entry* RomIndex::Find(uint64_t hash) const
+{
+    const Entry* end = _entries + _count;
+    const Entry* it = std::lower_bound(_entries, end, hash,
+        [](const Entry& e, uint64_t h) { return e.hash < h; });
+
+    return (it != end && it->hash == hash) ? it : nullptr;
+}
+
+bool RomIndex::IndexFile(const std::string& path, Entry& entry, uint64_t* bytesHashed)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < (off_t) RomHeader::SIZE)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = (size_t) st.st_size;
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapping);
+
+    RomHeader header;
+    if (!RomHeader::Parse(data, size, header))
+    {
+        ::munmap(mapping, size);
+        return false;
+    }
+
+    // Hash only what the header describes, so trailing junk or a re-written
+    // header doesn't change a ROM's identity
+    size_t offset = std::min(header.GetDataOffset(), size);
+    size_t length = std::min((size_t) header.prgRomSize + header.chrRomSize, size - offset);
+
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    uint64_t hash = Hash::XXH64(data + offset, length);
+    ::munmap(mapping, size);
+
+    std::memset(&entry, 0, sizeof(entry));
+    entry.hash = hash;
+    entry.fileSize = size;
+    entry.mtime = ModificationTime(st);
+    entry.prgRomSize = header.prgRomSize;
+    entry.chrRomSize = header.chrRomSize;
+    entry.prgRamSize = header.prgRamSize;
+    entry.mapper = header.mapper;
+    entry.submapper = header.submapper;
+    entry.mirrorMode = (uint8_t) header.mirrorMode;
+
+    if (header.format == RomHeader::FORMAT_NES20) entry.flags |= E_NES20;
+    if (header.hasBattery) entry.flags |= E_BATTERY;
+    if (header.hasTrainer) entry.flags |= E_TRAINER;
+    if (size < header.GetExpectedFileSize()) entry.flags |= E_TRUNCATED;
+
+    if (bytesHashed)
+        *bytesHashed = length;
+
+    return true;
+}
+
+bool RomIndex::Scan(const std::string& directory, unsigned threads, const RomIndex* previous)
+{
+    namespace fs = std::filesystem;
+
+    _stats = ScanStats();
+
+    // Walk (metadata only) on this thread; file reads go to the pool
+    std::vector<std::string> paths;
+    std::error_code ec;
+    fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    if (ec)
+    {
+        LOG_ERROR("Failed to open ROM directory: %s", directory.c_str());
+        return false;
+    }
+
+    for (fs::recursive_directory_iterator end; it != end; it.increment(ec))
+    {
+        if (ec)
+            break;
+        if (it->is_regular_file(ec) && IsRomFile(it->path()))
+            paths.push_back(it->path().string());
+    }
+
+    std::sort(paths.begin(), paths.end());
+    _stats.files = paths.size();
+
+    std::unordered_map<std::string, const Entry*> known;
+    if (previous)
+    {
+        known.reserve(previous->GetCount());
+        for (size_t i = 0; i < previous->GetCount(); ++i)
+        {
+            const Entry& e = previous->GetEntry(i);
+            known.emplace(previous->GetPath(e), &e);
+        }
+    }
+
+    std::vector<Entry> results(paths.size());
+    std::vector<uint8_t> valid(paths.size(), 0);
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> hashed(0), reused(0);
+    std::atomic<uint64_t> bytes(0);
+
+    auto worker = [&]()
+    {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < paths.size(); )
+        {
+            auto found = known.find(paths[i]);
+            if (found != known.end())
+            {
+                struct stat st;
+                if (::stat(paths[i].c_str(), &st) == 0
+                    && (uint64_t) st.st_size == found->second->fileSize
+                    && ModificationTime(st) == found->second->mtime)
+                {
+                    results[i] = *found->second;
+                    valid[i] = 1;
+                    reused.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+
+            uint64_t length = 0;
+            if (IndexFile(paths[i], results[i], &length))
+            {
+                valid[i] = 1;
+                hashed.fetch_add(1, std::memory_order_relaxed);
+                bytes.fetch_add(length, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned) std::min<size_t>(threads, std::max<size_t>(1, paths.size()));
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    // Merge: build the string table and sort by hash (path breaks ties)
+    Clear();
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (!valid[i] || paths[i].size() > UINT16_MAX)
+            continue;
+
+        Entry entry = results[i];
+        entry.pathOffset = (uint32_t) _ownedStrings.size();
+        entry.pathLength = (uint16_t) paths[i].size();
+        _ownedStrings += paths[i];
+        _ownedEntries.push_back(entry);
+    }
+
+    std::sort(_ownedEntries.begin(), _ownedEntries.end(),
+        [](const Entry& a, const Entry& b)
+        { return a.hash != b.hash ? a.hash < b.hash : a.pathOffset < b.pathOffset; });
+
+    _entries = _ownedEntries.data();
+    _strings = _ownedStrings.data();
+    _stringsSize = _ownedStrings.size();
+    _count = _ownedEntries.size();
+
+    _stats.hashed = hashed.load();
+    _stats.reused = reused.load();
+    _stats.rejected = _stats.files - _count;
+    _stats.bytesHashed = bytes.load();
+
+    return true;
+}
+
+bool RomIndex::Save(const std::string& filename) const
+{
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file)
+    {
+        LOG_ERROR("Failed to create ROM index: %s", filename.c_str());
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = (uint32_t) _count;
+    header.stringsSize = (uint32_t) _stringsSize;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && (_count == 0 || std::fwrite(_entries, sizeof(Entry), _count, file) == _count)
+        && (_stringsSize == 0 || std::fwrite(_strings, 1, _stringsSize, file) == _stringsSize);
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok)
+        LOG_ERROR("Failed to write ROM index: %s", filename.c_str());
+
+    return ok;
+}
+
+bool RomIndex::Load(const std::string& filename)
+{
+    Clear();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(FileHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = (size_t) st.st_size;
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+        || size != sizeof(FileHeader) + (size_t) header.count * sizeof(Entry) + header.stringsSize)
+    {
+        LOG_ERROR("Invalid or outdated ROM index: %s", filename.c_str());
+        ::munmap(mapping, size);
+        return false;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(mapping);
+    const Entry* entries = reinterpret_cast<const Entry*>(base + sizeof(FileHeader));
+
+    for (uint32_t i = 0; i < header.count; ++i)
+    {
+        if ((size_t) entries[i].pathOffset + entries[i].pathLength > header.stringsSize)
+        {
+            LOG_ERROR("Corrupt ROM index: %s", filename.c_str());
+            ::munmap(mapping, size);
+            return false;
+        }
+    }
+
+    _mapping = mapping;
+    _mappingSize = size;
+    _entries = entries;
+    _strings = reinterpret_cast<const char*>(entries + header.count);
+    _stringsSize = header.stringsSize;
+    _count = header.count;
+
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef ROM_INDEX_H
+#define ROM_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Persistent index of a ROM library: header summary and content hash per file.
+// Scan() walks a directory and hashes files on a thread pool (each file is
+// memory-mapped and only its header decoded; PRG/CHR are never copied). The
+// index is saved as a flat binary file that Load() maps and uses in place, so
+// later runs start instantly and a rescan only re-hashes files whose size or
+// modification time changed.
+class RomIndex
+{
+public:
+    enum EntryFlags : uint8_t
+    {
+        E_NES20     = (1 << 0),
+        E_BATTERY   = (1 << 1),
+        E_TRAINER   = (1 << 2),
+        E_TRUNCATED = (1 << 3), // File shorter than its header claims
+    };
+
+    // On-disk record (fixed size, sorted by hash)
+    struct Entry
+    {
+        uint64_t hash;       // XXH64 of PRG + CHR (header and trainer excluded)
+        uint64_t fileSize;
+        int64_t  mtime;      // Nanoseconds since the epoch
+        uint32_t prgRomSize;
+        uint32_t chrRomSize;
+        uint32_t prgRamSize;
+        uint32_t pathOffset; // Into the string table
+        uint16_t pathLength;
+        uint16_t mapper;
+        uint8_t  submapper;
+        uint8_t  mirrorMode;
+        uint8_t  flags;
+        uint8_t  reserved;
+    };
+
+    struct ScanStats
+    {
+        size_t files;       // Candidate files found by the walk
+        size_t hashed;      // Files read and hashed
+        size_t reused;      // Unchanged files taken from the previous index
+        size_t rejected;    // Unreadable or not an NES ROM
+        uint64_t bytesHashed;
+    };
+
+    RomIndex();
+    ~RomIndex();
+
+    RomIndex(const RomIndex&) = delete;
+    RomIndex& operator=(const RomIndex&) = delete;
+
+    // Index every .nes file under a directory. Entries from `previous` whose
+    // path, size and mtime still match are reused without reading the file.
+    // threads = 0 uses the hardware concurrency.
+    bool Scan(const std::string& directory, unsigned threads = 0, const RomIndex* previous = nullptr);
+
+    bool Save(const std::string& filename) const;
+    bool Load(const std::string& filename);
+    void Clear();
+
+    size_t GetCount() const { return _count; }
+    const Entry& GetEntry(size_t index) const { return _entries[index]; }
+    std::string GetPath(const Entry& entry) const;
+
+    // First entry with the given content hash, or nullptr
+    const Entry* Find(uint64_t hash) const;
+
+    const ScanStats& GetScanStats() const { return _stats; }
+
+    // Hash and summarise one file (exposed for tests and tools)
+    static bool IndexFile(const std::string& path, Entry& entry, uint64_t* bytesHashed = nullptr);
+
+    static constexpr uint32_t VERSION = 1;
+
+private:
+    // Views used for lookups; point into either the mapping or the owned buffers
+    const Entry* _entries;
+    const char* _strings;
+    size_t _stringsSize;
+    size_t _count;
+
+    std::vector<Entry> _ownedEntries;
+    std::string _ownedStrings;
+
+    void* _mapping;
+    size_t _mappingSize;
+
+    ScanStats _stats;
+};
+
+#endif // ROM_INDEX_H
@@ -0,0 +1,244 @@
+#include "StaticDisassembler.h"
+#include "cartridge/Cartridge.h"
+#include "cpu/OpcodeTable.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+
+
+bool StaticDisassembler::Analyze(Cartridge& cartridge)
+{
+    _cartridge = &cartridge;
+    _prg = &cartridge.GetPRGROM();
+    _windowSize = cartridge.GetPRGWindowSize();
+
+    _flags.assign(_prg->size(), 0);
+    _address.assign(_prg->size(), 0);
+    _worklist.clear();
+    _unresolved.clear();
+    _instructions = 0;
+    _codeBytes = 0;
+
+    if (!cartridge.IsLoaded() || _prg->empty())
+    {
+        LOG_ERROR("No PRG-ROM to disassemble");
+        return false;
+    }
+
+    // Vectors live in the last window, which is mapped at power-on
+    static const uint16_t VECTORS[3] = { 0xFFFA, 0xFFFC, 0xFFFE };
+    for (uint16_t vector : VECTORS)
+    {
+        uint32_t lo = 0, hi = 0, entry = 0;
+        if (!cartridge.MapPRGAddress(vector, lo) || !cartridge.MapPRGAddress(vector + 1, hi))
+            continue;
+
+        uint16_t address = (*_prg)[lo] | ((*_prg)[hi] << 8);
+        if (cartridge.MapPRGAddress(address, entry))
+            Push(entry, address, F_VECTOR | F_LABEL);
+    }
+
+    while (!_worklist.empty())
+    {
+        WorkItem item = _worklist.back();
+        _worklist.pop_back();
+        Trace(item);
+    }
+
+    return true;
+}
+
+bool StaticDisassembler::Resolve(uint32_t offset, uint16_t address, uint16_t target, uint32_t& result) const
+{
+    if (target < 0x8000)
+        return false; // RAM / registers / PRG-RAM
+
+    // Fixed window: the current mapping is the only mapping
+    if (_cartridge->IsPRGWindowFixed(target))
+        return _cartridge->MapPRGAddress(target, result);
+
+    // Same switchable window: same bank, so just rebase inside it
+    const uint32_t mask = _windowSize - 1;
+    if ((address & ~mask) == (target & ~mask))
+    {
+        result = (offset - (address & mask)) + (target & mask);
+        return result < _prg->size();
+    }
+
+    return false;
+}
+
+void StaticDisassembler::Push(uint32_t offset, uint16_t address, uint8_t flags)
+{
+    _flags[offset] |= flags;
+
+    if (!(_flags[offset] & F_CODE))
+        _worklist.push_back({ offset, address });
+}
+
+void StaticDisassembler::Trace(WorkItem item)
+{
+    uint32_t offset = item.offset;
+    uint16_t address = item.address;
+
+    for (;;)
+    {
+        const uint8_t opcode = (*_prg)[offset];
+        const OpcodeInfo& info = OPCODE_TABLE[opcode];
+
+        // Instructions never straddle the end of ROM or a window boundary
+        const uint32_t mask = _windowSize - 1;
+        if (offset + info.length > _prg->size() || (address & mask) + info.length > _windowSize)
+            return;
+
+        // JAM opcodes halt the CPU; reaching one means we wandered into data
+        if (info.mnemonic[0] == 'X')
+            return;
+
+        // Already decoded, or overlaps another instruction: stop there
+        for (int i = 0; i < info.length; ++i)
+        {
+            if (_flags[offset + i] & F_CODE)
+                return;
+        }
+
+        _flags[offset] |= F_OPCODE;
+        for (int i = 0; i < info.length; ++i)
+            _flags[offset + i] |= F_CODE;
+        _address[offset] = address;
+        _instructions++;
+        _codeBytes += info.length;
+
+        const uint16_t operand = (info.length == 3)
+            ? (uint16_t) ((*_prg)[offset + 1] | ((*_prg)[offset + 2] << 8))
+            : 0;
+
+        // Control transfers
+        uint32_t target = 0;
+        bool fallsThrough = true;
+
+        switch (opcode)
+        {
+            case 0x00: // BRK: returns past its padding byte, but is usually data
+            case 0x40: // RTI
+            case 0x60: // RTS
+                return;
+
+            case 0x4C: // JMP abs
+                fallsThrough = false;
+                [[fallthrough]];
+            case 0x20: // JSR
+                if (Resolve(offset, address, operand, target))
+                    Push(target, operand, F_LABEL | (opcode == 0x20 ? F_SUBROUTINE : 0));
+                else if (operand >= 0x8000)
+                    _unresolved.push_back({ offset, operand });
+                break;
+
+            case 0x6C: // JMP (ind): target is a run-time value
+                _unresolved.push_back({ offset, 0 });
+                return;
+
+            default:
+                if (info.mode == CPU::M_REL)
+                {
+                    uint16_t dest = address + 2 + (int8_t) (*_prg)[offset + 1];
+                    if (Resolve(offset, address, dest, target))
+                        Push(target, dest, F_LABEL);
+                    else if (dest >= 0x8000)
+                        _unresolved.push_back({ offset, dest });
+                }
+                break;
+        }
+
+        if (!fallsThrough)
+            return;
+
+        // Sequential flow, possibly into the next window
+        uint16_t next = address + info.length;
+        if (next < address || !Resolve(offset, address, next, target))
+            return;
+
+        offset = target;
+        address = next;
+    }
+}
+
+void StaticDisassembler::WriteListing(FILE* out) const
+{
+    const size_t size = _flags.size();
+
+    std::fprintf(out, "; %zu bytes PRG-ROM, %zu instructions, %zu code bytes (%.1f%%), %zu unresolved\n",
+                 size, _instructions, _codeBytes,
+                 size ? 100.0 * _codeBytes / size : 0.0, _unresolved.size());
+
+    char line[96];
+    size_t offset = 0;
+
+    while (offset < size)
+    {
+        if (offset % _windowSize == 0)
+            std::fprintf(out, "\n; ---- bank %zu (PRG $%05zX) ----\n", offset / _windowSize, offset);
+
+        const uint8_t flags = _flags[offset];
+
+        if (flags & F_OPCODE)
+        {
+            const uint16_t address = _address[offset];
+
+            if (flags & F_VECTOR)
+                std::fprintf(out, "\n; entry point\n");
+            else if (flags & F_SUBROUTINE)
+                std::fprintf(out, "\n");
+
+            if (flags & F_LABEL)
+                std::fprintf(out, "L%05zX_%04X:\n", offset, address);
+
+            uint8_t bytes[3] = { (*_prg)[offset], 0, 0 };
+            int length = OPCODE_TABLE[bytes[0]].length;
+            for (int i = 1; i < length; ++i)
+                bytes[i] = (*_prg)[offset + i];
+
+            Disassembler::FormatLine(address, bytes, line, sizeof(line));
+            std::fprintf(out, "    %05zX  %s\n", offset, line);
+            offset += length;
+            continue;
+        }
+
+        // Data: up to 8 bytes per line, stopping at code or a bank boundary
+        std::fprintf(out, "    %05zX  .byte", offset);
+        for (int i = 0; i < 8 && offset < size; ++i)
+        {
+            std::fprintf(out, "%s$%02X", i ? "," : " ", (*_prg)[offset]);
+            ++offset;
+
+            if ((_flags[offset < size ? offset : 0] & F_CODE) || offset % _windowSize == 0)
+                break;
+        }
+        std::fprintf(out, "\n");
+    }
+
+    if (!_unresolved.empty())
+    {
+        std::fprintf(out, "\n; unresolved control transfers\n");
+        for (const Unresolved& u : _unresolved)
+        {
+            if (u.target)
+                std::fprintf(out, ";   %05X -> $%04X (switchable bank)\n", u.from, u.target);
+            else
+                std::fprintf(out, ";   %05X -> indirect\n", u.from);
+        }
+    }
+}
+
+bool StaticDisassembler::WriteListing(const std::string& filename) const
+{
+    FILE* out = std::fopen(filename.c_str(), "w");
+    if (!out)
+    {
+        LOG_ERROR("Failed to open listing file: %s", filename.c_str());
+        return false;
+    }
+
+    WriteListing(out);
+    std::fclose(out);
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef STATIC_DISASSEMBLER_H
+#define STATIC_DISASSEMBLER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+// Forward declaration
+class Cartridge;
+
+
+// Whole-ROM static disassembler.
+// Follows code flow from the NMI/RESET/IRQ vectors through PRG-ROM, marking
+// every byte reached as code. Work is done on PRG-ROM offsets rather than CPU
+// addresses so identical addresses in different banks stay apart: a target in
+// the same mapper window as the branch lives in the same bank, a target in a
+// fixed window is resolved through the current mapping, and anything else is
+// recorded as unresolved (it depends on a bank switch at run time).
+class StaticDisassembler
+{
+public:
+    enum Flags : uint8_t
+    {
+        F_CODE       = (1 << 0), // Part of a decoded instruction
+        F_OPCODE     = (1 << 1), // First byte of an instruction
+        F_LABEL      = (1 << 2), // Branch or jump target
+        F_SUBROUTINE = (1 << 3), // JSR target
+        F_VECTOR     = (1 << 4)  // NMI/RESET/IRQ entry point
+    };
+
+    // Control transfer whose target bank is unknown statically
+    struct Unresolved
+    {
+        uint32_t from;   // PRG offset of the instruction
+        uint16_t target; // CPU address (0 for indirect JMP)
+    };
+
+    // Analyze the PRG-ROM using the cartridge's current (power-on) mapping
+    bool Analyze(Cartridge& cartridge);
+
+    uint8_t GetFlags(uint32_t offset) const { return offset < _flags.size() ? _flags[offset] : 0; }
+    uint16_t GetAddress(uint32_t offset) const { return offset < _address.size() ? _address[offset] : 0; }
+
+    size_t GetInstructionCount() const { return _instructions; }
+    size_t GetCodeBytes() const { return _codeBytes; }
+    const std::vector<Unresolved>& GetUnresolved() const { return _unresolved; }
+
+    // Assembler-style listing of the whole PRG-ROM (code and .byte data)
+    void WriteListing(FILE* out) const;
+    bool WriteListing(const std::string& filename) const;
+
+private:
+    struct WorkItem
+    {
+        uint32_t offset;
+        uint16_t address;
+    };
+
+    // PRG offset for a CPU address reached from the instruction at (offset, address)
+    bool Resolve(uint32_t offset, uint16_t address, uint16_t target, uint32_t& result) const;
+
+    void Push(uint32_t offset, uint16_t address, uint8_t flags);
+    void Trace(WorkItem item);
+
+    Cartridge* _cartridge = nullptr;
+    const std::vector<uint8_t>* _prg = nullptr;
+    uint32_t _windowSize = 0x8000;
+
+    std::vector<uint8_t> _flags;    // One per PRG-ROM byte
+    std::vector<uint16_t> _address; // CPU address of each opcode byte
+    std::vector<WorkItem> _worklist;
+    std::vector<Unresolved> _unresolved;
+
+    size_t _instructions = 0;
+    size_t _codeBytes = 0;
+};
+
+#endif // STATIC_DISASSEMBLER_H
@@ -0,0 +1,272 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "Telemetry.h"
+#include "cpu/CPU.h"
+#include "utils/Logger.h"
+
+
+namespace
+{
+    constexpr char MAGIC[4] = { 'N', 'T', 'E', 'L' };
+    constexpr size_t WORDS = sizeof(TelemetryStats) / sizeof(uint64_t);
+
+    static_assert(sizeof(TelemetryStats) % sizeof(uint64_t) == 0, "stats are copied as 64-bit words");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics are shared between processes");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "atomics are shared between processes");
+
+    // Readers that lose the race this often give up until the next poll
+    constexpr int READ_ATTEMPTS = 1000;
+}
+
+struct TelemetrySegment
+{
+    char magic[4];
+    uint32_t version;
+    int32_t pid;
+    std::atomic<uint32_t> sequence; // Odd while the writer is storing
+    std::atomic<uint64_t> words[WORDS];
+};
+
+
+TelemetryWriter::TelemetryWriter()
+    : _segment(nullptr),
+    _stats(),
+    _phaseNs(),
+    _intervalFrames(0),
+    _intervalCycles(0),
+    _intervalStart(std::chrono::steady_clock::now())
+{
+    _frameNs.reserve(REPORT_INTERVAL);
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+    Close();
+}
+
+bool TelemetryWriter::Open(const std::string& name)
+{
+    Close();
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        LOG_ERROR("Failed to create telemetry segment %s: %s", name.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(fd, sizeof(TelemetrySegment)) == 0)
+        mapping = ::mmap(nullptr, sizeof(TelemetrySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        LOG_ERROR("Failed to map telemetry segment %s: %s", name.c_str(), std::strerror(errno));
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    // Readers only accept the segment once the magic is in place
+    _segment = new (mapping) TelemetrySegment();
+    _segment->version = VERSION;
+    _segment->pid = (int32_t) ::getpid();
+    std::memcpy(_segment->magic, MAGIC, sizeof(MAGIC));
+
+    _name = name;
+    _intervalStart = std::chrono::steady_clock::now();
+    Publish();
+
+    LOG_INFO("Publishing telemetry to %s", name.c_str());
+    return true;
+}
+
+void TelemetryWriter::Close()
+{
+    if (!_segment)
+        return;
+
+    ::munmap(_segment, sizeof(TelemetrySegment));
+    ::shm_unlink(_name.c_str());
+    _segment = nullptr;
+    _name.clear();
+}
+
+void TelemetryWriter::EndFrame(const uint64_t phaseNs[PHASE_COUNT], const CPU& cpu, uint32_t frames)
+{
+    uint64_t frameNs = 0;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        _phaseNs[phase] += phaseNs[phase];
+        frameNs += phaseNs[phase];
+    }
+    _frameNs.push_back(frameNs);
+    _intervalFrames += frames;
+
+    _stats.frames += frames;
+    _stats.cpuCycles = cpu.GetTotalCycles();
+    _stats.instructions = cpu.GetInstructionCount();
+    _stats.nmis = cpu.GetNMICount();
+    _stats.irqs = cpu.GetIRQCount();
+    _stats.logDrops = Logger::GetInstance().GetDropCount();
+
+    if (_frameNs.size() >= REPORT_INTERVAL)
+        Report();
+
+    Publish();
+}
+
+void TelemetryWriter::Report()
+{
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - _intervalStart).count();
+
+    // A reset in the middle of the interval restarts the cycle count
+    uint64_t cycles = _stats.cpuCycles >= _intervalCycles ? _stats.cpuCycles - _intervalCycles : _stats.cpuCycles;
+    if (seconds > 0)
+    {
+        _stats.fps = _intervalFrames / seconds;
+        _stats.cpuMHz = cycles / seconds / 1e6;
+    }
+
+    // Nearest-rank percentiles
+    const size_t count = _frameNs.size();
+    auto percentile = [&](double p)
+    {
+        size_t rank = std::max<size_t>(1, (size_t) std::ceil(p * count));
+        std::nth_element(_frameNs.begin(), _frameNs.begin() + (rank - 1), _frameNs.end());
+        return _frameNs[rank - 1] / 1e6;
+    };
+    _stats.frameMsP50 = percentile(0.50);
+    _stats.frameMsP95 = percentile(0.95);
+    _stats.frameMsP99 = percentile(0.99);
+
+    _stats.emulateMs = _phaseNs[PHASE_EMULATE] / 1e6 / count;
+    _stats.renderMs = _phaseNs[PHASE_RENDER] / 1e6 / count;
+    _stats.displayMs = _phaseNs[PHASE_DISPLAY] / 1e6 / count;
+
+    _frameNs.clear();
+    std::fill(std::begin(_phaseNs), std::end(_phaseNs), 0);
+    _intervalFrames = 0;
+    _intervalCycles = _stats.cpuCycles;
+    _intervalStart = now;
+}
+
+void TelemetryWriter::Publish()
+{
+    if (!_segment)
+        return;
+
+    uint64_t words[WORDS];
+    std::memcpy(words, &_stats, sizeof(words));
+
+    uint32_t sequence = _segment->sequence.load(std::memory_order_relaxed);
+    _segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORDS; ++i)
+        _segment->words[i].store(words[i], std::memory_order_relaxed);
+
+    _segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+
+TelemetryReader::TelemetryReader()
+    : _segment(nullptr)
+{}
+
+TelemetryReader::~TelemetryReader()
+{
+    Close();
+}
+
+bool TelemetryReader::Open(const std::string& name)
+{
+    Close();
+
+    // Quietly, nes_top polls until the emulator is up
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    void* mapping = MAP_FAILED;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(TelemetrySegment))
+        mapping = ::mmap(nullptr, sizeof(TelemetrySegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    const TelemetrySegment* segment = static_cast<const TelemetrySegment*>(mapping);
+    if (std::memcmp(segment->magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        ::munmap(mapping, sizeof(TelemetrySegment));
+        return false;
+    }
+
+    if (segment->version != TelemetryWriter::VERSION)
+    {
+        LOG_ERROR("Telemetry segment %s is version %u, expected %u", name.c_str(),
+                  segment->version, TelemetryWriter::VERSION);
+        ::munmap(mapping, sizeof(TelemetrySegment));
+        return false;
+    }
+
+    _segment = segment;
+    return true;
+}
+
+void TelemetryReader::Close()
+{
+    if (!_segment)
+        return;
+
+    ::munmap(const_cast<TelemetrySegment*>(_segment), sizeof(TelemetrySegment));
+    _segment = nullptr;
+}
+
+bool TelemetryReader::Read(TelemetryStats& stats) const
+{
+    if (!_segment)
+        return false;
+
+    uint64_t words[WORDS];
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+    {
+        uint32_t before = _segment->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < WORDS; ++i)
+            words[i] = _segment->words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_segment->sequence.load(std::memory_order_relaxed) == before)
+        {
+            std::memcpy(&stats, words, sizeof(words));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int TelemetryReader::GetWriterPid() const
+{
+    return _segment ? _segment->pid : 0;
+}
@@ -0,0 +1,126 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Forward declarations
+class CPU;
+struct TelemetrySegment;
+
+
+// What the emulator publishes. Every field is 8 bytes so the whole struct
+// moves through the segment as an array of 64-bit words.
+struct TelemetryStats
+{
+    // Running totals since the emulator started
+    uint64_t frames;
+    uint64_t cpuCycles;
+    uint64_t instructions;
+    uint64_t nmis;
+    uint64_t irqs;
+    uint64_t logDrops;
+
+    // Over the last report interval
+    double cpuMHz;       // Emulated CPU clock
+    double fps;
+    double frameMsP50;   // Main loop iteration time percentiles
+    double frameMsP95;
+    double frameMsP99;
+
+    // Average milliseconds per main loop iteration spent in each phase
+    double emulateMs;    // CPU and PPU, stepped together per dot
+    double renderMs;     // Waiting for the PPU render thread (pipelined)
+    double displayMs;    // Texture upload and present
+};
+
+
+// Live telemetry in a POSIX shared-memory segment (/dev/shm), for
+// nes_top. Layout: "NTEL" version pid sequence, then TelemetryStats as
+// 64-bit atomics.
+//
+// The segment is a seqlock: the one writer makes the sequence odd, stores
+// the words and makes it even again; a reader copies the words and retries
+// if the sequence was odd or moved meanwhile. Nobody ever waits on a lock.
+class TelemetryWriter
+{
+public:
+    static constexpr const char* DEFAULT_NAME = "/nes_telemetry";
+    static constexpr uint32_t VERSION = 1;
+
+    // Rates and percentiles are refreshed every this many calls to EndFrame
+    static constexpr uint32_t REPORT_INTERVAL = 60;
+
+    enum Phase
+    {
+        PHASE_EMULATE,
+        PHASE_RENDER,
+        PHASE_DISPLAY,
+        PHASE_COUNT
+    };
+
+    TelemetryWriter();
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    // Create (or take over) the segment; Close() removes it
+    bool Open(const std::string& name = DEFAULT_NAME);
+    void Close();
+    bool IsOpen() const { return _segment != nullptr; }
+
+    // Once per main loop iteration: nanoseconds spent in each phase, the
+    // CPU whose counters to publish and how many frames were emulated.
+    // Publishes the totals (a few relaxed stores under the seqlock); every
+    // REPORT_INTERVAL calls it also works out the rates and percentiles.
+    void EndFrame(const uint64_t phaseNs[PHASE_COUNT], const CPU& cpu, uint32_t frames = 1);
+
+    const TelemetryStats& GetStats() const { return _stats; }
+
+private:
+    void Report();
+    void Publish();
+
+    TelemetrySegment* _segment;
+    std::string _name;
+
+    TelemetryStats _stats;
+
+    // Current report interval
+    std::vector<uint64_t> _frameNs;
+    uint64_t _phaseNs[PHASE_COUNT];
+    uint64_t _intervalFrames;
+    uint64_t _intervalCycles;
+    std::chrono::steady_clock::time_point _intervalStart;
+};
+
+
+class TelemetryReader
+{
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool Open(const std::string& name = TelemetryWriter::DEFAULT_NAME);
+    void Close();
+    bool IsOpen() const { return _segment != nullptr; }
+
+    // Consistent copy of the latest stats; false if the writer kept
+    // getting in the way (try again later)
+    bool Read(TelemetryStats& stats) const;
+
+    // Process publishing into the segment
+    int GetWriterPid() const;
+
+private:
+    const TelemetrySegment* _segment;
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,301 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "TraceComparator.h"
+#include "utils/Logger.h"
+
+
+static int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Parse hex digits at p, advancing it; false if there are none
+static bool ParseHex(const char*& p, const char* end, uint32_t& value)
+{
+    value = 0;
+    const char* start = p;
+    for (int digit; p < end && (digit = HexDigit(*p)) >= 0; ++p)
+        value = (value << 4) | digit;
+    return p != start;
+}
+
+// Parse a decimal number at p (leading spaces allowed), advancing it
+static bool ParseDec(const char*& p, const char* end, uint64_t& value)
+{
+    while (p < end && *p == ' ')
+        ++p;
+
+    value = 0;
+    const char* start = p;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+        value = value * 10 + (*p - '0');
+    return p != start;
+}
+
+
+TraceComparator::TraceComparator()
+    : _data(nullptr),
+    _size(0),
+    _position(0),
+    _mask(F_ALL),
+    _line(0),
+    _matched(0),
+    _diverged(false),
+    _divergence()
+{}
+
+TraceComparator::~TraceComparator()
+{
+    Close();
+}
+
+bool TraceComparator::Open(const std::string& filename)
+{
+    Close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR("Failed to open reference trace: %s", filename.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        LOG_ERROR("Reference trace is empty: %s", filename.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LOG_ERROR("Failed to map reference trace: %s", filename.c_str());
+        return false;
+    }
+
+    // Read front to back exactly once
+    ::madvise(data, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+    _data = (const char*) data;
+    _size = (size_t) st.st_size;
+    _position = 0;
+    _line = 0;
+    _matched = 0;
+    _diverged = false;
+    return true;
+}
+
+void TraceComparator::Close()
+{
+    if (_data)
+    {
+        ::munmap((void*) _data, _size);
+        _data = nullptr;
+    }
+
+    _size = 0;
+    _position = 0;
+}
+
+bool TraceComparator::ParseLine(const char* line, size_t length, Expected& e)
+{
+    const char* p = line;
+    const char* end = line + length;
+    uint32_t value = 0;
+
+    std::memset(&e, 0, sizeof(e));
+
+    // "C000  4C F5 C5  JMP $C5F5 ..."
+    if (!ParseHex(p, end, value) || (p - line) != 4)
+        return false;
+    e.pc = (uint16_t) value;
+    e.fields = F_PC;
+
+    for (const char* b = line + 6; e.length < 3 && b + 1 < end; b += 3)
+    {
+        int hi = HexDigit(b[0]), lo = HexDigit(b[1]);
+        if (hi < 0 || lo < 0)
+            break;
+        e.bytes[e.length++] = (uint8_t) ((hi << 4) | lo);
+    }
+    if (e.length)
+        e.fields |= F_BYTES;
+
+    // Register columns start at " A:"; the disassembly before it is skipped
+    const char* regs = nullptr;
+    for (const char* s = line + 15; s + 3 <= end; ++s)
+    {
+        if (s[0] == ' ' && s[1] == 'A' && s[2] == ':')
+        {
+            regs = s + 1;
+            break;
+        }
+    }
+    if (!regs)
+        return true;
+
+    // "A:00 X:00 Y:00 P:24 SP:FD PPU:  0, 21 CYC:7"
+    p = regs;
+    while (p < end)
+    {
+        const char* key = p;
+        while (p < end && *p != ':' && *p != ' ')
+            ++p;
+        if (p >= end || *p != ':')
+        {
+            ++p;
+            continue;
+        }
+
+        const size_t keyLength = p - key;
+        ++p;
+
+        uint64_t dec = 0;
+        if (keyLength == 1 && ParseHex(p, end, value))
+        {
+            switch (key[0])
+            {
+                case 'A': e.a = (uint8_t) value; e.fields |= F_A; break;
+                case 'X': e.x = (uint8_t) value; e.fields |= F_X; break;
+                case 'Y': e.y = (uint8_t) value; e.fields |= F_Y; break;
+                case 'P': e.p = (uint8_t) value; e.fields |= F_P; break;
+            }
+        }
+        else if (keyLength == 2 && key[0] == 'S' && key[1] == 'P' && ParseHex(p, end, value))
+        {
+            e.sp = (uint8_t) value;
+            e.fields |= F_SP;
+        }
+        else if (keyLength == 3 && std::memcmp(key, "PPU", 3) == 0 && ParseDec(p, end, dec))
+        {
+            e.scanline = (uint16_t) dec;
+            if (p < end && *p == ',' && ParseDec(++p, end, dec))
+            {
+                e.dot = (uint16_t) dec;
+                e.fields |= F_PPU;
+            }
+        }
+        else if (keyLength == 3 && std::memcmp(key, "CYC", 3) == 0 && ParseDec(p, end, dec))
+        {
+            e.cycle = dec;
+            e.fields |= F_CYCLE;
+        }
+
+        while (p < end && *p == ' ')
+            ++p;
+    }
+
+    return true;
+}
+
+bool TraceComparator::Compare(const TraceRecord& actual)
+{
+    if (_diverged || _position >= _size)
+        return false;
+
+    const char* line = _data + _position;
+    const char* newline = (const char*) std::memchr(line, '\n', _size - _position);
+    size_t length = newline ? (size_t) (newline - line) : _size - _position;
+
+    _position += length + (newline ? 1 : 0);
+    _line++;
+
+    if (length && line[length - 1] == '\r')
+        length--;
+
+    Expected e;
+    uint32_t mismatched = 0;
+
+    if (!ParseLine(line, length, e))
+    {
+        mismatched = F_PC; // Unparseable reference line
+    }
+    else
+    {
+        const uint32_t check = e.fields & _mask;
+        const uint8_t bytes[3] = { actual.opcode, actual.operands[0], actual.operands[1] };
+
+        if ((check & F_PC) && e.pc != actual.pc) mismatched |= F_PC;
+        if ((check & F_BYTES) && std::memcmp(e.bytes, bytes, e.length) != 0) mismatched |= F_BYTES;
+        if ((check & F_A) && e.a != actual.a) mismatched |= F_A;
+        if ((check & F_X) && e.x != actual.x) mismatched |= F_X;
+        if ((check & F_Y) && e.y != actual.y) mismatched |= F_Y;
+        if ((check & F_P) && e.p != actual.p) mismatched |= F_P;
+        if ((check & F_SP) && e.sp != actual.sp) mismatched |= F_SP;
+        if ((check & F_PPU) && (e.scanline != actual.scanline || e.dot != actual.dot)) mismatched |= F_PPU;
+        if ((check & F_CYCLE) && e.cycle != actual.cycle) mismatched |= F_CYCLE;
+    }
+
+    if (mismatched)
+    {
+        _diverged = true;
+        _divergence.line = _line;
+        _divergence.mismatched = mismatched;
+        _divergence.expected = e;
+        _divergence.actual = actual;
+        _divergence.text = line;
+        _divergence.textLength = length;
+        return false;
+    }
+
+    _matched++;
+    return true;
+}
+
+bool TraceComparator::Compare(Bus& bus)
+{
+    TraceRecord record;
+    TraceWriter::Snapshot(bus, record);
+    return Compare(record);
+}
+
+void TraceComparator::WriteReport(FILE* out) const
+{
+    if (!_diverged)
+    {
+        std::fprintf(out, "No divergence: %llu instructions matched%s\n",
+                     (unsigned long long) _matched,
+                     IsExhausted() ? " (reference exhausted)" : "");
+        return;
+    }
+
+    const Divergence& d = _divergence;
+    const Expected& e = d.expected;
+    const TraceRecord& r = d.actual;
+
+    char actualLine[128];
+    TraceReader::FormatNestest(r, actualLine, sizeof(actualLine));
+
+    std::fprintf(out, "First divergence at reference line %llu (after %llu matching instructions)\n",
+                 (unsigned long long) d.line, (unsigned long long) _matched);
+    std::fprintf(out, "  expected: %.*s\n", (int) d.textLength, d.text);
+    std::fprintf(out, "  actual:   %s\n", actualLine);
+    std::fprintf(out, "  %-8s %-10s %-10s\n", "field", "expected", "actual");
+
+    if (d.mismatched & F_PC)    std::fprintf(out, "  %-8s %-10.4X %-10.4X\n", "PC", e.pc, r.pc);
+    if (d.mismatched & F_BYTES) std::fprintf(out, "  %-8s %02X %02X %02X   %02X %02X %02X\n", "bytes",
+                                             e.bytes[0], e.bytes[1], e.bytes[2],
+                                             r.opcode, r.operands[0], r.operands[1]);
+    if (d.mismatched & F_A)     std::fprintf(out, "  %-8s %-10.2X %-10.2X\n", "A", e.a, r.a);
+    if (d.mismatched & F_X)     std::fprintf(out, "  %-8s %-10.2X %-10.2X\n", "X", e.x, r.x);
+    if (d.mismatched & F_Y)     std::fprintf(out, "  %-8s %-10.2X %-10.2X\n", "Y", e.y, r.y);
+    if (d.mismatched & F_P)     std::fprintf(out, "  %-8s %-10.2X %-10.2X\n", "P", e.p, r.p);
+    if (d.mismatched & F_SP)    std::fprintf(out, "  %-8s %-10.2X %-10.2X\n", "SP", e.sp, r.sp);
+    if (d.mismatched & F_PPU)   std::fprintf(out, "  %-8s %3d,%3d    %3d,%3d\n", "PPU",
+                                             e.scanline, e.dot, r.scanline, r.dot);
+    if (d.mismatched & F_CYCLE) std::fprintf(out, "  %-8s %-10llu %-10llu\n", "CYC",
+                                             (unsigned long long) e.cycle,
+                                             (unsigned long long) r.cycle);
+}
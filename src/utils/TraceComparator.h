@@ -0,0 +1,97 @@
+#ifndef TRACE_COMPARATOR_H
+#define TRACE_COMPARATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "TraceFormat.h"
+
+
+// Streaming comparison against a nestest-style reference log.
+// The reference is memory-mapped and parsed one line at a time as the
+// emulator runs; fields are compared as numbers, so no text is generated for
+// matching instructions. Comparison stops at the first divergence, which is
+// kept for a structured report.
+class TraceComparator
+{
+public:
+    enum Field : uint32_t
+    {
+        F_PC     = (1 << 0),
+        F_BYTES  = (1 << 1), // Opcode and operand bytes
+        F_A      = (1 << 2),
+        F_X      = (1 << 3),
+        F_Y      = (1 << 4),
+        F_P      = (1 << 5),
+        F_SP     = (1 << 6),
+        F_PPU    = (1 << 7), // Scanline and dot
+        F_CYCLE  = (1 << 8),
+
+        F_ALL    = 0x1FF
+    };
+
+    // Parsed reference line; missing columns clear their bit in `fields`
+    struct Expected
+    {
+        uint32_t fields;
+        uint16_t pc;
+        uint8_t  bytes[3];
+        uint8_t  length;
+        uint8_t  a, x, y, p, sp;
+        uint16_t scanline, dot;
+        uint64_t cycle;
+    };
+
+    struct Divergence
+    {
+        uint64_t line;      // 1-based line in the reference
+        uint32_t mismatched; // Field bits that differ
+        Expected expected;
+        TraceRecord actual;
+        const char* text;   // Reference line (not terminated)
+        size_t textLength;
+    };
+
+    TraceComparator();
+    ~TraceComparator();
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    // Fields to check (default: all); fields the reference lacks are skipped
+    void SetFieldMask(uint32_t mask) { _mask = mask; }
+
+    // Compare the next reference line against a record; false on divergence
+    // or once the reference is exhausted (see IsExhausted)
+    bool Compare(const TraceRecord& actual);
+
+    // Compare against the instruction about to execute on the bus
+    bool Compare(Bus& bus);
+
+    bool IsExhausted() const { return _position >= _size; }
+    bool HasDiverged() const { return _diverged; }
+    uint64_t GetMatchedCount() const { return _matched; }
+    const Divergence& GetDivergence() const { return _divergence; }
+
+    // Human-readable report of the first divergence (expected vs actual)
+    void WriteReport(FILE* out) const;
+
+    // Parse one reference line (exposed for tests)
+    static bool ParseLine(const char* line, size_t length, Expected& expected);
+
+private:
+    const char* _data;
+    size_t _size;
+    size_t _position;
+
+    uint32_t _mask;
+    uint64_t _line;
+    uint64_t _matched;
+
+    bool _diverged;
+    Divergence _divergence;
+};
+
+#endif // TRACE_COMPARATOR_H
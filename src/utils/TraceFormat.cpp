@@ -0,0 +1,486 @@
+#include <cstring>
+
+#include "TraceFormat.h"
+#include "bus/Bus.h"
+#include "cpu/Instructions.h"
+#include "cpu/OpcodeTable.h"
+#include "utils/Disassembler.h"
+#include "utils/Logger.h"
+
+
+static const char TRACE_MAGIC[4] = { 'N', 'T', 'R', 'C' };
+static const uint8_t TRACE_VERSION = 1;
+
+static const size_t BUFFER_SIZE = 256 * 1024;
+static const size_t MAX_RECORD_SIZE = 32;
+
+// Record flag bits
+enum TraceFlag : uint8_t
+{
+    T_A      = (1 << 0),
+    T_X      = (1 << 1),
+    T_Y      = (1 << 2),
+    T_P      = (1 << 3),
+    T_SP     = (1 << 4),
+    T_PC     = (1 << 5), // PC is not sequential
+    T_PPU    = (1 << 6), // PPU position not predictable from cycles
+    T_MEMORY = (1 << 7)  // Effective address + value follow
+};
+
+
+static int InstructionLength(uint8_t opcode)
+{
+    return OPCODE_TABLE[opcode].length;
+}
+
+// Advance a PPU position by a number of CPU cycles
+static void PredictPPU(const TraceRecord& previous, uint64_t cycleDelta,
+                       uint16_t& scanline, uint16_t& dot)
+{
+    uint64_t dots = previous.dot + cycleDelta * 3;
+    scanline = (uint16_t) ((previous.scanline + dots / 341) % 262);
+    dot = (uint16_t) (dots % 341);
+}
+
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+TraceWriter::TraceWriter()
+    : _file(nullptr),
+    _used(0),
+    _previous(),
+    _recordCount(0)
+{}
+
+TraceWriter::~TraceWriter()
+{
+    Close();
+}
+
+bool TraceWriter::Open(const std::string& filename)
+{
+    Close();
+
+    _file = std::fopen(filename.c_str(), "wb");
+    if (!_file)
+    {
+        LOG_ERROR("Failed to open trace file: %s", filename.c_str());
+        return false;
+    }
+
+    uint8_t header[8] = { 0 };
+    std::memcpy(header, TRACE_MAGIC, 4);
+    header[4] = TRACE_VERSION;
+    std::fwrite(header, 1, sizeof(header), _file);
+
+    _buffer.resize(BUFFER_SIZE);
+    _used = 0;
+    _previous = TraceRecord();
+    _recordCount = 0;
+    return true;
+}
+
+void TraceWriter::Close()
+{
+    if (!_file)
+        return;
+
+    FlushBuffer();
+    std::fclose(_file);
+    _file = nullptr;
+
+    LOG_INFO("Trace closed: %llu instructions", (unsigned long long) _recordCount);
+}
+
+void TraceWriter::FlushBuffer()
+{
+    if (_used > 0)
+    {
+        std::fwrite(_buffer.data(), 1, _used, _file);
+        _used = 0;
+    }
+}
+
+void TraceWriter::Capture(Bus& bus)
+{
+    TraceRecord r;
+    Snapshot(bus, r);
+    Write(r);
+}
+
+void TraceWriter::Snapshot(Bus& bus, TraceRecord& r)
+{
+    CPU* cpu = bus.GetCPU();
+    PPU* ppu = bus.GetPPU();
+
+    r.pc = cpu->PC;
+    r.opcode = bus.CPUPeek(r.pc);
+
+    int length = InstructionLength(r.opcode);
+    r.operands[0] = length >= 2 ? bus.CPUPeek(r.pc + 1) : 0;
+    r.operands[1] = length >= 3 ? bus.CPUPeek(r.pc + 2) : 0;
+
+    r.a = cpu->A;
+    r.x = cpu->X;
+    r.y = cpu->Y;
+    r.p = cpu->P;
+    r.sp = cpu->SP;
+    r.cycle = cpu->GetTotalCycles();
+
+    if (ppu)
+    {
+        r.scanline = ppu->GetScanline();
+        r.dot = ppu->GetCycle();
+    }
+    else
+    {
+        // CPU-only setups (nestest): derive the position from the cycle count
+        uint64_t dots = r.cycle * 3;
+        r.scanline = (uint16_t) ((dots / 341) % 262);
+        r.dot = (uint16_t) (dots % 341);
+    }
+
+    // Effective address as seen before the instruction runs
+    const OpcodeInfo& info = OPCODE_TABLE[r.opcode];
+    const uint8_t op1 = r.operands[0];
+    const uint16_t abs = r.operands[0] | (r.operands[1] << 8);
+    const bool isJump = (info.mnemonic[0] == 'J');
+
+    r.hasMemory = true;
+    if (info.mode == CPU::M_ZP0)
+        r.effectiveAddress = op1;
+    else if (info.mode == CPU::M_ZPX)
+        r.effectiveAddress = (uint8_t) (op1 + r.x);
+    else if (info.mode == CPU::M_ZPY)
+        r.effectiveAddress = (uint8_t) (op1 + r.y);
+    else if (info.mode == CPU::M_ABS && !isJump)
+        r.effectiveAddress = abs;
+    else if (info.mode == CPU::M_ABX)
+        r.effectiveAddress = abs + r.x;
+    else if (info.mode == CPU::M_ABY)
+        r.effectiveAddress = abs + r.y;
+    else if (info.mode == CPU::M_IZX)
+    {
+        uint8_t ptr = op1 + r.x;
+        r.effectiveAddress = bus.CPUPeek(ptr) | (bus.CPUPeek((uint8_t) (ptr + 1)) << 8);
+    }
+    else if (info.mode == CPU::M_IZY)
+        r.effectiveAddress = (bus.CPUPeek(op1) | (bus.CPUPeek((uint8_t) (op1 + 1)) << 8)) + r.y;
+    else if (info.mode == CPU::M_IND)
+    {
+        // 6502 bug: the high byte is fetched without carrying into the page
+        uint16_t hiAddr = (abs & 0xFF00) | ((abs + 1) & 0x00FF);
+        r.effectiveAddress = bus.CPUPeek(abs) | (bus.CPUPeek(hiAddr) << 8);
+    }
+    else
+        r.hasMemory = false;
+
+    r.memoryValue = 0;
+    if (r.hasMemory && info.mode != CPU::M_IND)
+        r.memoryValue = bus.CPUPeek(r.effectiveAddress);
+    if (!r.hasMemory)
+        r.effectiveAddress = 0;
+}
+
+void TraceWriter::Write(const TraceRecord& r)
+{
+    if (!_file)
+        return;
+
+    if (_used + MAX_RECORD_SIZE > _buffer.size())
+        FlushBuffer();
+
+    const TraceRecord& prev = _previous;
+    uint8_t* out = _buffer.data() + _used;
+    uint8_t* start = out;
+
+    uint64_t cycleDelta = r.cycle - prev.cycle;
+    uint16_t predictedPC = prev.pc + (_recordCount ? InstructionLength(prev.opcode) : 0);
+    uint16_t scanline, dot;
+    PredictPPU(prev, cycleDelta, scanline, dot);
+
+    uint8_t flags = 0;
+    if (r.a != prev.a)                                flags |= T_A;
+    if (r.x != prev.x)                                flags |= T_X;
+    if (r.y != prev.y)                                flags |= T_Y;
+    if (r.p != prev.p)                                flags |= T_P;
+    if (r.sp != prev.sp)                              flags |= T_SP;
+    if (r.pc != predictedPC || _recordCount == 0)     flags |= T_PC;
+    if (r.scanline != scanline || r.dot != dot)       flags |= T_PPU;
+    if (r.hasMemory)                                  flags |= T_MEMORY;
+
+    *out++ = flags;
+
+    if (flags & T_PC)
+    {
+        *out++ = r.pc & 0xFF;
+        *out++ = r.pc >> 8;
+    }
+
+    *out++ = r.opcode;
+    int length = InstructionLength(r.opcode);
+    for (int i = 1; i < length; ++i)
+        *out++ = r.operands[i - 1];
+
+    if (flags & T_A)  *out++ = r.a;
+    if (flags & T_X)  *out++ = r.x;
+    if (flags & T_Y)  *out++ = r.y;
+    if (flags & T_P)  *out++ = r.p;
+    if (flags & T_SP) *out++ = r.sp;
+
+    // Cycle delta as LEB128 (one byte for any normal instruction)
+    uint64_t delta = cycleDelta;
+    do {
+        uint8_t byte = delta & 0x7F;
+        delta >>= 7;
+        *out++ = byte | (delta ? 0x80 : 0x00);
+    } while (delta);
+
+    if (flags & T_PPU)
+    {
+        *out++ = r.scanline & 0xFF;
+        *out++ = r.scanline >> 8;
+        *out++ = r.dot & 0xFF;
+        *out++ = r.dot >> 8;
+    }
+
+    if (flags & T_MEMORY)
+    {
+        *out++ = r.effectiveAddress & 0xFF;
+        *out++ = r.effectiveAddress >> 8;
+        *out++ = r.memoryValue;
+    }
+
+    _used += out - start;
+    _previous = r;
+    _recordCount++;
+}
+
+
+// ============================================================================
+// READER
+// ============================================================================
+
+TraceReader::TraceReader()
+    : _file(nullptr),
+    _position(0),
+    _available(0),
+    _previous()
+{}
+
+TraceReader::~TraceReader()
+{
+    Close();
+}
+
+bool TraceReader::Open(const std::string& filename)
+{
+    Close();
+
+    _file = std::fopen(filename.c_str(), "rb");
+    if (!_file)
+    {
+        LOG_ERROR("Failed to open trace file: %s", filename.c_str());
+        return false;
+    }
+
+    uint8_t header[8];
+    if (std::fread(header, 1, sizeof(header), _file) != sizeof(header)
+        || std::memcmp(header, TRACE_MAGIC, 4) != 0)
+    {
+        LOG_ERROR("Not a trace file: %s", filename.c_str());
+        Close();
+        return false;
+    }
+
+    if (header[4] != TRACE_VERSION)
+    {
+        LOG_ERROR("Unsupported trace version %d", (int) header[4]);
+        Close();
+        return false;
+    }
+
+    _buffer.resize(BUFFER_SIZE);
+    _position = _available = 0;
+    _previous = TraceRecord();
+    return true;
+}
+
+void TraceReader::Close()
+{
+    if (_file)
+    {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+}
+
+bool TraceReader::Fill()
+{
+    if (!_file)
+        return false;
+
+    _available = std::fread(_buffer.data(), 1, _buffer.size(), _file);
+    _position = 0;
+    return _available > 0;
+}
+
+bool TraceReader::ReadByte(uint8_t& value)
+{
+    if (_position == _available && !Fill())
+        return false;
+
+    value = _buffer[_position++];
+    return true;
+}
+
+bool TraceReader::ReadWord(uint16_t& value)
+{
+    uint8_t lo, hi;
+    if (!ReadByte(lo) || !ReadByte(hi))
+        return false;
+
+    value = lo | (hi << 8);
+    return true;
+}
+
+bool TraceReader::Next(TraceRecord& r)
+{
+    const TraceRecord& prev = _previous;
+
+    uint8_t flags;
+    if (!ReadByte(flags))
+        return false;
+
+    if (flags & T_PC)
+    {
+        if (!ReadWord(r.pc))
+            return false;
+    }
+    else
+    {
+        // The first record always carries its PC
+        r.pc = prev.pc + InstructionLength(prev.opcode);
+    }
+
+    if (!ReadByte(r.opcode))
+        return false;
+
+    int length = InstructionLength(r.opcode);
+    r.operands[0] = r.operands[1] = 0;
+    for (int i = 1; i < length; ++i)
+    {
+        if (!ReadByte(r.operands[i - 1]))
+            return false;
+    }
+
+    r.a = prev.a; r.x = prev.x; r.y = prev.y; r.p = prev.p; r.sp = prev.sp;
+    if ((flags & T_A)  && !ReadByte(r.a))  return false;
+    if ((flags & T_X)  && !ReadByte(r.x))  return false;
+    if ((flags & T_Y)  && !ReadByte(r.y))  return false;
+    if ((flags & T_P)  && !ReadByte(r.p))  return false;
+    if ((flags & T_SP) && !ReadByte(r.sp)) return false;
+
+    uint64_t delta = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+        uint8_t byte;
+        if (shift > 63 || !ReadByte(byte))
+            return false;
+
+        delta |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    r.cycle = prev.cycle + delta;
+
+    if (flags & T_PPU)
+    {
+        if (!ReadWord(r.scanline) || !ReadWord(r.dot))
+            return false;
+    }
+    else
+    {
+        PredictPPU(prev, delta, r.scanline, r.dot);
+    }
+
+    r.hasMemory = (flags & T_MEMORY) != 0;
+    r.effectiveAddress = 0;
+    r.memoryValue = 0;
+    if (r.hasMemory)
+    {
+        if (!ReadWord(r.effectiveAddress) || !ReadByte(r.memoryValue))
+            return false;
+    }
+
+    _previous = r;
+    return true;
+}
+
+int TraceReader::FormatNestest(const TraceRecord& r, char* buffer, size_t size)
+{
+    const OpcodeInfo& info = OPCODE_TABLE[r.opcode];
+    const int length = InstructionLength(r.opcode);
+    const uint8_t op1 = r.operands[0];
+    const uint16_t abs = r.operands[0] | (r.operands[1] << 8);
+    const uint16_t ea = r.effectiveAddress;
+    const uint8_t value = r.memoryValue;
+
+    // Instruction bytes, padded to three
+    char bytes[10];
+    if (length == 1)
+        std::snprintf(bytes, sizeof(bytes), "%02X", r.opcode);
+    else if (length == 2)
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X", r.opcode, op1);
+    else
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X %02X", r.opcode, op1, r.operands[1]);
+
+    // nestest calls ISC "ISB"
+    const char* name = std::strcmp(info.mnemonic, "ISC") == 0 ? "ISB" : info.mnemonic;
+
+    char operand[48] = "";
+    CPU::AddressingMode mode = info.mode;
+
+    if (mode == CPU::M_ACC)
+        std::snprintf(operand, sizeof(operand), "A");
+    else if (mode == CPU::M_IMM)
+        std::snprintf(operand, sizeof(operand), "#$%02X", op1);
+    else if (mode == CPU::M_ZP0)
+        std::snprintf(operand, sizeof(operand), "$%02X = %02X", op1, value);
+    else if (mode == CPU::M_ZPX)
+        std::snprintf(operand, sizeof(operand), "$%02X,X @ %02X = %02X", op1, ea & 0xFF, value);
+    else if (mode == CPU::M_ZPY)
+        std::snprintf(operand, sizeof(operand), "$%02X,Y @ %02X = %02X", op1, ea & 0xFF, value);
+    else if (mode == CPU::M_ABS)
+    {
+        if (r.hasMemory)
+            std::snprintf(operand, sizeof(operand), "$%04X = %02X", abs, value);
+        else
+            std::snprintf(operand, sizeof(operand), "$%04X", abs);
+    }
+    else if (mode == CPU::M_ABX)
+        std::snprintf(operand, sizeof(operand), "$%04X,X @ %04X = %02X", abs, ea, value);
+    else if (mode == CPU::M_ABY)
+        std::snprintf(operand, sizeof(operand), "$%04X,Y @ %04X = %02X", abs, ea, value);
+    else if (mode == CPU::M_IND)
+        std::snprintf(operand, sizeof(operand), "($%04X) = %04X", abs, ea);
+    else if (mode == CPU::M_IZX)
+        std::snprintf(operand, sizeof(operand), "($%02X,X) @ %02X = %04X = %02X",
+                      op1, (uint8_t) (op1 + r.x), ea, value);
+    else if (mode == CPU::M_IZY)
+        std::snprintf(operand, sizeof(operand), "($%02X),Y = %04X @ %04X = %02X",
+                      op1, (uint16_t) (ea - r.y), ea, value);
+    else if (mode == CPU::M_REL)
+        std::snprintf(operand, sizeof(operand), "$%04X", (uint16_t) (r.pc + 2 + (int8_t) op1));
+
+    char text[64];
+    std::snprintf(text, sizeof(text), operand[0] ? "%s %s" : "%s", name, operand);
+
+    return std::snprintf(buffer, size,
+                         "%04X  %-8s %c%-32sA:%02X X:%02X Y:%02X P:%02X SP:%02X PPU:%3d,%3d CYC:%llu",
+                         r.pc, bytes, IsOfficialOpcode(r.opcode) ? ' ' : '*', text,
+                         r.a, r.x, r.y, r.p, r.sp, r.scanline, r.dot,
+                         (unsigned long long) r.cycle);
+}
@@ -0,0 +1,101 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+// Forward declaration
+class Bus;
+
+
+// One executed instruction, captured before it runs (nestest convention)
+struct TraceRecord
+{
+    uint16_t pc;
+    uint8_t  opcode;
+    uint8_t  operands[2];
+    uint8_t  a, x, y, p, sp;
+    uint64_t cycle;           // CPU cycle count
+    uint16_t scanline, dot;   // PPU position
+
+    // Effective address and the value there, for modes nestest annotates
+    // ("= XX", "@ XXXX"); for JMP (ind) the address is the jump target
+    bool     hasMemory;
+    uint16_t effectiveAddress;
+    uint8_t  memoryValue;
+};
+
+
+// Binary trace file layout:
+//   header: "NTRC" version(1) reserved(3)
+//   record: flags, [pc16], opcode, operands..., [a][x][y][p][sp],
+//           cycleDelta (LEB128), [scanline16 dot16], [addr16 value8]
+//
+// Each record is delta-encoded against the previous one. Registers are only
+// stored when they changed, PC only when it isn't the previous PC plus its
+// instruction length, and the PPU position only when it doesn't follow from
+// the cycle delta (3 dots per cycle).
+class TraceWriter
+{
+public:
+    TraceWriter();
+    ~TraceWriter();
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return _file != nullptr; }
+
+    // Record the instruction about to execute at CPU PC
+    void Capture(Bus& bus);
+
+    // Fill a record from the current system state without writing it
+    static void Snapshot(Bus& bus, TraceRecord& record);
+
+    void Write(const TraceRecord& record);
+
+    uint64_t GetRecordCount() const { return _recordCount; }
+
+private:
+    void FlushBuffer();
+
+    FILE* _file;
+    std::vector<uint8_t> _buffer;
+    size_t _used;
+
+    TraceRecord _previous;
+    uint64_t _recordCount;
+};
+
+
+class TraceReader
+{
+public:
+    TraceReader();
+    ~TraceReader();
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    // Decode the next record, false at end of file (or on corruption)
+    bool Next(TraceRecord& record);
+
+    // Render a record as a nestest.log line (no newline), returns length
+    static int FormatNestest(const TraceRecord& record, char* buffer, size_t size);
+
+private:
+    bool Fill();
+    bool ReadByte(uint8_t& value);
+    bool ReadWord(uint16_t& value);
+
+    FILE* _file;
+    std::vector<uint8_t> _buffer;
+    size_t _position;
+    size_t _available;
+
+    TraceRecord _previous;
+};
+
+#endif // TRACE_FORMAT_H
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "bus/Bus.h"
+#include "TestROM.h"
 
 
 class CPUTest : public ::testing::Test
@@ -0,0 +1,50 @@
+#ifndef TEST_ROM_H
+#define TEST_ROM_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+// Synthetic iNES images for the tests and benchmarks. Header only, so the
+// benchmark can use it without linking the test support code.
+
+// Offset of PRG-ROM in the image (no trainer)
+static constexpr size_t TEST_ROM_PRG = 16;
+
+// Point a CPU vector ($FFFA NMI, $FFFC RESET, $FFFE IRQ) at `target`. The
+// vectors live at the end of the last 16KB bank, which the mappers used
+// here keep at $C000-$FFFF.
+inline void SetTestROMVector(std::vector<uint8_t>& rom, uint16_t vector, uint16_t target)
+{
+    size_t offset = TEST_ROM_PRG + (size_t) (rom[4] - 1) * 0x4000 + (vector - 0xC000);
+    rom[offset] = (uint8_t) target;
+    rom[offset + 1] = (uint8_t) (target >> 8);
+}
+
+// `program` starts at $8000 (PRG offset 0) and RESET points there; NMI and
+// IRQ return at once through an RTI at $FFF0. No CHR banks means CHR-RAM.
+// `flags` is the low nibble of header byte 6: bit 0 vertical mirroring,
+// bit 1 battery, bit 3 four-screen VRAM.
+inline std::vector<uint8_t> MakeTestROM(const std::vector<uint8_t>& program = {}, uint8_t mapper = 0,
+                                        uint8_t prgBanks = 1, uint8_t chrBanks = 1, uint8_t flags = 0)
+{
+    std::vector<uint8_t> rom(TEST_ROM_PRG + prgBanks * 0x4000 + chrBanks * 0x2000, 0x00);
+    rom[0] = 'N'; rom[1] = 'E'; rom[2] = 'S'; rom[3] = 0x1A;
+    rom[4] = prgBanks;
+    rom[5] = chrBanks;
+    rom[6] = (uint8_t) (((mapper & 0x0F) << 4) | (flags & 0x0F));
+    rom[7] = (uint8_t) (mapper & 0xF0);
+
+    if (!program.empty())
+        std::memcpy(&rom[TEST_ROM_PRG], program.data(), program.size());
+
+    rom[TEST_ROM_PRG + prgBanks * 0x4000 - 0x10] = 0x40; // RTI at $FFF0
+    SetTestROMVector(rom, 0xFFFA, 0xFFF0);
+    SetTestROMVector(rom, 0xFFFC, 0x8000);
+    SetTestROMVector(rom, 0xFFFE, 0xFFF0);
+
+    return rom;
+}
+
+#endif // TEST_ROM_H
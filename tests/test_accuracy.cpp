@@ -0,0 +1,228 @@
+#include <cstring>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/Machine.h"
+#include "utils/Debugger.h"
+
+
+// UxROM image (CHR-RAM) running `program` from $8000, with the NMI
+// handler at `nmi` (by default the helper's RTI)
+static std::vector<uint8_t> MakeROM(const std::vector<uint8_t>& program, uint16_t nmi = 0xFFF0)
+{
+    std::vector<uint8_t> rom = MakeTestROM(program, 2, 2, 0);
+    SetTestROMVector(rom, 0xFFFA, nmi);
+    return rom;
+}
+
+// $2100-$21FF read back as $80, $81, ... through $2007
+static void FillNametable(Machine& machine)
+{
+    for (uint16_t i = 0; i < 0x0100; ++i)
+        machine.GetPPU().PPUWrite(0x2100 + i, (uint8_t) (0x80 + i));
+}
+
+TEST(AccuracyTest, FastMatchesBalanced)
+{
+    // Scroll writes from both the main loop and the NMI handler, so the
+    // picture depends on where each instruction lands in the frame
+    const std::vector<uint8_t> program = {
+        0xA9, 0x80,        // LDA #$80
+        0x8D, 0x00, 0x20,  // STA $2000 ; NMI on
+        0xA9, 0x1E,        // LDA #$1E
+        0x8D, 0x01, 0x20,  // STA $2001 ; rendering on
+        0xE6, 0x10,        // INC $10   ; $800A
+        0xA5, 0x10,        // LDA $10
+        0x8D, 0x05, 0x20,  // STA $2005
+        0x4C, 0x0A, 0x80,  // JMP $800A
+        0xE6, 0x11,        // INC $11   ; $8014 NMI
+        0xA5, 0x11,        // LDA $11
+        0x8D, 0x05, 0x20,  // STA $2005
+        0x40,              // RTI
+    };
+    const std::vector<uint8_t> rom = MakeROM(program, 0x8014);
+
+    Machine fast(Accuracy::FAST), balanced;
+    EXPECT_EQ(fast.GetAccuracy(), Accuracy::FAST);
+    EXPECT_EQ(balanced.GetAccuracy(), Accuracy::BALANCED);
+
+    for (Machine* m : { &fast, &balanced })
+    {
+        ASSERT_TRUE(m->LoadFromMemory(rom));
+        for (uint16_t i = 0; i < 0x0800; ++i)
+            m->GetPPU().PPUWrite(0x2000 + i, (uint8_t) (i * 7));
+        for (uint16_t i = 0; i < 0x2000; ++i)
+            m->GetPPU().PPUWrite(i, (uint8_t) (i * 13 + (i >> 5)));
+        for (uint16_t i = 0; i < 0x20; ++i)
+            m->GetPPU().PPUWrite(0x3F00 + i, (uint8_t) (i * 5 + 1));
+    }
+
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        fast.RunFrame();
+        balanced.RunFrame();
+
+        ASSERT_EQ(std::memcmp(fast.GetPPU().GetScreenBuffer(), balanced.GetPPU().GetScreenBuffer(),
+                              PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT), 0) << "frame " << frame;
+
+        uint8_t ramFast[0x0800], ramBalanced[0x0800];
+        fast.GetMemory().CopyTo(0x0000, ramFast, sizeof(ramFast));
+        balanced.GetMemory().CopyTo(0x0000, ramBalanced, sizeof(ramBalanced));
+        ASSERT_EQ(std::memcmp(ramFast, ramBalanced, sizeof(ramFast)), 0) << "frame " << frame;
+    }
+
+    EXPECT_GT(balanced.GetMemory().Read(0x0011), 0);
+}
+
+TEST(AccuracyTest, FastSkipsDebuggerHooks)
+{
+    // A CPU write watchpoint and a PPU nametable read watchpoint both
+    // trigger on BALANCED; FAST compiles the hooks out of its bus paths
+    const std::vector<uint8_t> program = {
+        0xA9, 0x1E,        // LDA #$1E
+        0x8D, 0x01, 0x20,  // STA $2001 ; rendering on
+        0xE6, 0x10,        // INC $10   ; $8005
+        0x4C, 0x05, 0x80,  // JMP $8005
+    };
+    const std::vector<uint8_t> rom = MakeROM(program);
+
+    for (Debugger::Space space : { Debugger::SPACE_CPU, Debugger::SPACE_PPU })
+    {
+        Machine fast(Accuracy::FAST), balanced;
+        Debugger fastDebugger, balancedDebugger;
+        for (Debugger* d : { &fastDebugger, &balancedDebugger })
+        {
+            if (space == Debugger::SPACE_CPU)
+                d->AddWatchpoint(space, 0x0010, 0x0010, Debugger::ACCESS_WRITE);
+            else
+                d->AddWatchpoint(space, 0x2000, 0x23FF, Debugger::ACCESS_READ);
+        }
+
+        ASSERT_TRUE(fast.LoadFromMemory(rom));
+        ASSERT_TRUE(balanced.LoadFromMemory(rom));
+        fast.GetBus().AttachDebugger(&fastDebugger);
+        balanced.GetBus().AttachDebugger(&balancedDebugger);
+
+        fast.RunFrame();
+        fast.RunFrame();
+        EXPECT_FALSE(fastDebugger.IsInstructionHookArmed()) << "space " << space;
+        EXPECT_GT(fast.GetMemory().Read(0x0010), 0);
+
+        // A hit holds BALANCED at the next instruction, so clock by hand
+        for (int dot = 0; dot < 2 * 341 * 262 && !balancedDebugger.IsPaused(); ++dot)
+            balanced.GetBus().Clock();
+        EXPECT_TRUE(balancedDebugger.IsPaused()) << "space " << space;
+        EXPECT_EQ(balancedDebugger.GetLastBreak().space, space);
+    }
+}
+
+TEST(AccuracyTest, ExactReadsOpenBus)
+{
+    const std::vector<uint8_t> program = {
+        0xAD, 0x00, 0x40,  // LDA $4000 ; unmapped
+        0x85, 0x10,        // STA $10
+        0xAD, 0x16, 0x40,  // LDA $4016 ; pad 1, upper bits float
+        0x85, 0x11,        // STA $11
+        0x4C, 0x0A, 0x80,  // JMP $800A
+    };
+    const std::vector<uint8_t> rom = MakeROM(program);
+
+    Machine exact(Accuracy::EXACT), balanced;
+    ASSERT_TRUE(exact.LoadFromMemory(rom));
+    ASSERT_TRUE(balanced.LoadFromMemory(rom));
+    exact.RunFrame();
+    balanced.RunFrame();
+
+    EXPECT_EQ(exact.GetMemory().Read(0x0010), 0x40);
+    EXPECT_EQ(exact.GetMemory().Read(0x0011) & 0xE0, 0x40);
+    EXPECT_EQ(balanced.GetMemory().Read(0x0010), 0x00);
+    EXPECT_EQ(balanced.GetMemory().Read(0x0011) & 0xE0, 0x00);
+}
+
+TEST(AccuracyTest, ExactIndexedPageCrossDummyReads)
+{
+    // $20F7,X with X = $10 reads $2107 (a $2007 mirror); the dummy read at
+    // $2007 first advances the VRAM address once more
+    const std::vector<uint8_t> program = {
+        0xA9, 0x21,        // LDA #$21
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x06, 0x20,  // STA $2006 ; VRAM address $2100
+        0xA2, 0x10,        // LDX #$10
+        0xBD, 0xF7, 0x20,  // LDA $20F7,X
+        0xAD, 0x07, 0x20,  // LDA $2007
+        0x85, 0x10,        // STA $10
+        0x4C, 0x14, 0x80,  // JMP $8014
+    };
+    const std::vector<uint8_t> rom = MakeROM(program);
+
+    Machine exact(Accuracy::EXACT), balanced;
+    for (Machine* m : { &exact, &balanced })
+    {
+        ASSERT_TRUE(m->LoadFromMemory(rom));
+        FillNametable(*m);
+        m->RunFrame();
+    }
+
+    EXPECT_EQ(balanced.GetMemory().Read(0x0010), 0x80);
+    EXPECT_EQ(exact.GetMemory().Read(0x0010), 0x81);
+}
+
+TEST(AccuracyTest, ExactIndexedStoreAlwaysDummyReads)
+{
+    // $2000,X with X = 7 stores to $2007 without crossing a page; the
+    // dummy read of $2007 still advances the VRAM address first
+    const std::vector<uint8_t> program = {
+        0xA9, 0x21,        // LDA #$21
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x06, 0x20,  // STA $2006 ; VRAM address $2100
+        0xA2, 0x07,        // LDX #$07
+        0xA9, 0x55,        // LDA #$55
+        0x9D, 0x00, 0x20,  // STA $2000,X
+        0x4C, 0x11, 0x80,  // JMP $8011
+    };
+    const std::vector<uint8_t> rom = MakeROM(program);
+
+    Machine exact(Accuracy::EXACT), balanced;
+    for (Machine* m : { &exact, &balanced })
+    {
+        ASSERT_TRUE(m->LoadFromMemory(rom));
+        FillNametable(*m);
+        m->RunFrame();
+    }
+
+    EXPECT_EQ(balanced.GetPPU().PPURead(0x2100), 0x55);
+    EXPECT_EQ(balanced.GetPPU().PPURead(0x2101), 0x81);
+    EXPECT_EQ(exact.GetPPU().PPURead(0x2100), 0x80);
+    EXPECT_EQ(exact.GetPPU().PPURead(0x2101), 0x55);
+}
+
+TEST(AccuracyTest, ExactReadModifyWriteWritesTwice)
+{
+    // INC $2007 reads the buffered $80 and, on EXACT, writes it back
+    // (advancing the address) before writing $81
+    const std::vector<uint8_t> program = {
+        0xA9, 0x21,        // LDA #$21
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x06, 0x20,  // STA $2006 ; VRAM address $2100
+        0xAD, 0x07, 0x20,  // LDA $2007 ; fill the read buffer
+        0xEE, 0x07, 0x20,  // INC $2007
+        0x4C, 0x10, 0x80,  // JMP $8010
+    };
+    const std::vector<uint8_t> rom = MakeROM(program);
+
+    Machine exact(Accuracy::EXACT), balanced;
+    for (Machine* m : { &exact, &balanced })
+    {
+        ASSERT_TRUE(m->LoadFromMemory(rom));
+        FillNametable(*m);
+        m->RunFrame();
+    }
+
+    EXPECT_EQ(balanced.GetPPU().PPURead(0x2102), 0x81);
+    EXPECT_EQ(balanced.GetPPU().PPURead(0x2103), 0x83);
+    EXPECT_EQ(exact.GetPPU().PPURead(0x2102), 0x80);
+    EXPECT_EQ(exact.GetPPU().PPURead(0x2103), 0x81);
+}
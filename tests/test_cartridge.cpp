@@ -0,0 +1,106 @@
+#include "TestFixture.h"
+
+
+// iNES image whose PRG bytes encode their own 8KB bank number and CHR bytes
+// their 1KB bank number, so any read tells which bank is mapped
+static std::vector<uint8_t> MakeBankedROM(uint8_t mapper, uint8_t prgBanks, uint8_t chrBanks)
+{
+    std::vector<uint8_t> rom = MakeTestROM({}, mapper, prgBanks, chrBanks);
+
+    for (size_t i = 0; i < (size_t) prgBanks * 0x4000; ++i)
+        rom[TEST_ROM_PRG + i] = (uint8_t) (i / 0x2000);
+
+    size_t chr = TEST_ROM_PRG + prgBanks * 0x4000;
+    for (size_t i = 0; i < (size_t) chrBanks * 0x2000; ++i)
+        rom[chr + i] = (uint8_t) (0x80 | (i / 0x0400));
+
+    return rom;
+}
+
+TEST(CartridgeTest, NROMReadsMirrorSixteenKilobytes)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(0, 1, 1)));
+
+    EXPECT_EQ(cartridge.CPURead(0x8000), 0);
+    EXPECT_EQ(cartridge.CPURead(0xA000), 1);
+    EXPECT_EQ(cartridge.CPURead(0xC000), 0); // Mirror of $8000
+    EXPECT_EQ(cartridge.CPURead(0xFFFF), 1);
+    EXPECT_EQ(cartridge.PPURead(0x1C00), 0x87);
+}
+
+TEST(CartridgeTest, UxROMBankSwitchUpdatesFetchPath)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(2, 4, 0)));
+
+    EXPECT_EQ(cartridge.CPURead(0x8000), 0);
+    EXPECT_EQ(cartridge.CPURead(0xC000), 6); // Last 16KB bank fixed
+
+    cartridge.CPUWrite(0x8000, 2);
+    EXPECT_EQ(cartridge.CPURead(0x8000), 4);
+    EXPECT_EQ(cartridge.CPURead(0xA000), 5);
+    EXPECT_EQ(cartridge.CPURead(0xE000), 7);
+
+    // CHR-RAM is writable through the page table
+    cartridge.PPUWrite(0x0123, 0x5A);
+    EXPECT_EQ(cartridge.PPURead(0x0123), 0x5A);
+}
+
+TEST(CartridgeTest, CNROMSwitchesCHRBank)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(3, 2, 4)));
+
+    EXPECT_EQ(cartridge.PPURead(0x0000), 0x80);
+
+    cartridge.CPUWrite(0x8000, 3);
+    EXPECT_EQ(cartridge.PPURead(0x0000), 0x80 | 24);
+    EXPECT_EQ(cartridge.PPURead(0x1FFF), 0x80 | 31);
+
+    // CHR-ROM ignores writes
+    cartridge.PPUWrite(0x0000, 0x00);
+    EXPECT_EQ(cartridge.PPURead(0x0000), 0x80 | 24);
+}
+
+TEST(CartridgeTest, MMC3SwitchesEightKilobytePRG)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(4, 8, 8)));
+
+    // R6 -> bank 5 at $8000 (PRG mode 0)
+    cartridge.CPUWrite(0x8000, 6);
+    cartridge.CPUWrite(0x8001, 5);
+    EXPECT_EQ(cartridge.CPURead(0x8000), 5);
+    EXPECT_EQ(cartridge.CPURead(0xC000), 14); // Second-to-last
+    EXPECT_EQ(cartridge.CPURead(0xE000), 15); // Last
+
+    // R2 -> 1KB CHR bank 9 at $1000
+    cartridge.CPUWrite(0x8000, 2);
+    cartridge.CPUWrite(0x8001, 9);
+    EXPECT_EQ(cartridge.PPURead(0x1000), 0x80 | 9);
+}
+
+TEST(CartridgeTest, AxROMSwitchesPRGAndMirroring)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(7, 8, 0)));
+
+    EXPECT_EQ(cartridge.CPURead(0x8000), 0);
+    EXPECT_EQ(cartridge.GetMirrorMode(), MIRROR_MODE_ONE_SCREEN_LOWER);
+
+    cartridge.CPUWrite(0x8000, 0x13);
+    EXPECT_EQ(cartridge.CPURead(0x8000), 12);
+    EXPECT_EQ(cartridge.CPURead(0xFFFF), 15);
+    EXPECT_EQ(cartridge.GetMirrorMode(), MIRROR_MODE_ONE_SCREEN_UPPER);
+}
+
+TEST(CartridgeTest, GxROMSwitchesPRGAndCHR)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBankedROM(66, 4, 4)));
+
+    cartridge.CPUWrite(0x8000, 0x12);
+    EXPECT_EQ(cartridge.CPURead(0x8000), 4);
+    EXPECT_EQ(cartridge.PPURead(0x0000), 0x80 | 16);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "bus/Bus.h"
+
+
+// Reads the 8 buttons of one pad after a strobe, A first
+static uint8_t ReadPad(Bus& bus, uint16_t port)
+{
+    bus.CPUWrite(0x4016, 1);
+    bus.CPUWrite(0x4016, 0);
+
+    uint8_t state = 0;
+    for (int i = 0; i < 8; ++i)
+        state = (uint8_t) ((state << 1) | (bus.CPURead(port) & 0x01));
+    return state;
+}
+
+TEST(ControllerTest, ShiftsOutButtonsSetPerFrame)
+{
+    Bus bus;
+    bus.SetControllerState(0, Controller::A | Controller::RIGHT);
+    bus.SetControllerState(1, Controller::START);
+
+    EXPECT_EQ(ReadPad(bus, 0x4016), Controller::A | Controller::RIGHT);
+    EXPECT_EQ(ReadPad(bus, 0x4017), Controller::START);
+}
+
+TEST(ControllerTest, InputProviderSampledAtStrobe)
+{
+    Bus bus;
+    int calls = 0;
+    uint8_t live = Controller::B;
+    bus.SetInputProvider(0, [&]() { ++calls; return live; });
+    bus.SetControllerState(0, Controller::SELECT); // overridden at the strobe
+
+    EXPECT_EQ(ReadPad(bus, 0x4016), Controller::B);
+    EXPECT_EQ(calls, 1);
+
+    // A change between strobes is seen by the next poll, not a frame later
+    live = Controller::UP;
+    EXPECT_EQ(ReadPad(bus, 0x4016), Controller::UP);
+    EXPECT_EQ(calls, 2);
+
+    // Pad 2 has no provider and keeps its own state; the shared strobe
+    // samples pad 1 again
+    EXPECT_EQ(ReadPad(bus, 0x4017), 0x00);
+    EXPECT_EQ(calls, 3);
+
+    bus.SetInputProvider(0, nullptr);
+    bus.SetControllerState(0, Controller::DOWN);
+    EXPECT_EQ(ReadPad(bus, 0x4016), Controller::DOWN);
+}
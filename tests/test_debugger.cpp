@@ -0,0 +1,152 @@
+#include "TestFixture.h"
+#include "utils/Debugger.h"
+
+
+class DebuggerTest : public CPUTest
+{
+protected:
+    PPU ppu;
+    Debugger debugger;
+
+    void SetUp() override
+    {
+        CPUTest::SetUp();
+        bus.ConnectPPU(&ppu);
+        bus.AttachDebugger(&debugger);
+    }
+
+    // Clock until the debugger stops the system (or give up)
+    bool RunUntilPaused(int maxClocks = 3000)
+    {
+        for (int i = 0; i < maxClocks && !debugger.IsPaused(); ++i)
+            bus.Clock();
+        return debugger.IsPaused();
+    }
+
+    void RunClocks(int clocks)
+    {
+        for (int i = 0; i < clocks; ++i)
+            bus.Clock();
+    }
+};
+
+
+TEST_F(DebuggerTest, ExecutionBreakpointStopsBeforeInstruction)
+{
+    uint8_t program[] = {
+        0xA9, 0x01,  // LDA #$01  ; 0x8000
+        0xA2, 0x02,  // LDX #$02  ; 0x8002
+        0xA0, 0x03,  // LDY #$03  ; 0x8004
+        0x4C, 0x04, 0x80, // JMP $8004
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    debugger.AddBreakpoint(0x8002);
+    ASSERT_TRUE(RunUntilPaused());
+
+    EXPECT_EQ(cpu.PC, 0x8002);
+    EXPECT_EQ(cpu.A, 0x01);
+    EXPECT_EQ(cpu.X, 0x00);
+    EXPECT_EQ(debugger.GetLastBreak().access, Debugger::ACCESS_EXECUTE);
+
+    // Paused: clocking does nothing
+    RunClocks(30);
+    EXPECT_EQ(cpu.PC, 0x8002);
+
+    // Resuming runs past the breakpoint we are sitting on
+    debugger.Resume();
+    RunClocks(30);
+    EXPECT_FALSE(debugger.IsPaused());
+    EXPECT_EQ(cpu.X, 0x02);
+    EXPECT_EQ(cpu.Y, 0x03);
+}
+
+TEST_F(DebuggerTest, StepRunsOneInstruction)
+{
+    uint8_t program[] = {
+        0xE8,        // INX  ; 0x8000
+        0xE8,        // INX  ; 0x8001
+        0xE8,        // INX  ; 0x8002
+        0x4C, 0x00, 0x80, // JMP $8000
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    debugger.Pause();
+    ASSERT_TRUE(RunUntilPaused());
+    EXPECT_EQ(cpu.PC, 0x8000);
+
+    debugger.Step();
+    ASSERT_TRUE(RunUntilPaused());
+    EXPECT_EQ(cpu.PC, 0x8001);
+    EXPECT_EQ(cpu.X, 0x01);
+
+    debugger.Step(2);
+    ASSERT_TRUE(RunUntilPaused());
+    EXPECT_EQ(cpu.PC, 0x8003);
+    EXPECT_EQ(cpu.X, 0x03);
+    EXPECT_EQ(debugger.GetLastBreak().access, Debugger::ACCESS_NONE);
+}
+
+TEST_F(DebuggerTest, CPUWriteWatchpointReportsAccess)
+{
+    uint8_t program[] = {
+        0xA9, 0x42,        // LDA #$42    ; 0x8000
+        0x8D, 0x10, 0x03,  // STA $0310   ; 0x8002 (same page, not watched)
+        0x8D, 0x00, 0x03,  // STA $0300   ; 0x8005
+        0xEA,              // NOP         ; 0x8008
+        0x4C, 0x08, 0x80,  // JMP $8008
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    int id = debugger.AddWatchpoint(Debugger::SPACE_CPU, 0x0300, 0x0300, Debugger::ACCESS_WRITE);
+    ASSERT_TRUE(RunUntilPaused());
+
+    // Stops at the boundary after the writing instruction
+    EXPECT_EQ(cpu.PC, 0x8008);
+    const Debugger::BreakInfo& info = debugger.GetLastBreak();
+    EXPECT_EQ(info.access, Debugger::ACCESS_WRITE);
+    EXPECT_EQ(info.space, Debugger::SPACE_CPU);
+    EXPECT_EQ(info.address, 0x0300);
+    EXPECT_EQ(info.value, 0x42);
+    EXPECT_EQ(info.watchpoint, id);
+
+    debugger.RemoveWatchpoint(id);
+    debugger.Resume();
+    EXPECT_FALSE(RunUntilPaused(300));
+}
+
+TEST_F(DebuggerTest, PPUWriteWatchpointSeesVRAMWrites)
+{
+    uint8_t program[] = {
+        0xA9, 0x21,        // LDA #$21    ; 0x8000
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x05,        // LDA #$05
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x77,        // LDA #$77
+        0x8D, 0x07, 0x20,  // STA $2007   ; VRAM $2105 <- $77
+        0xEA,              // NOP         ; 0x800F
+        0x4C, 0x0F, 0x80,  // JMP $800F
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    debugger.AddWatchpoint(Debugger::SPACE_PPU, 0x2100, 0x21FF, Debugger::ACCESS_WRITE);
+    ASSERT_TRUE(RunUntilPaused());
+
+    EXPECT_EQ(cpu.PC, 0x800F);
+    EXPECT_EQ(debugger.GetLastBreak().space, Debugger::SPACE_PPU);
+    EXPECT_EQ(debugger.GetLastBreak().address, 0x2105);
+    EXPECT_EQ(debugger.GetLastBreak().value, 0x77);
+}
+
+TEST_F(DebuggerTest, AttachedButUnarmedNeverStops)
+{
+    uint8_t program[] = {
+        0xE8,              // INX         ; 0x8000
+        0x8E, 0x00, 0x03,  // STX $0300
+        0x4C, 0x00, 0x80,  // JMP $8000
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    EXPECT_FALSE(RunUntilPaused(3000));
+    EXPECT_NE(cpu.X, 0x00);
+}
@@ -0,0 +1,100 @@
+#include <cstring>
+#include "TestFixture.h"
+#include "cpu/OpcodeTable.h"
+#include "cpu/Instructions.h"
+#include "utils/Disassembler.h"
+#include "utils/StaticDisassembler.h"
+
+
+TEST(OpcodeTableTest, MatchesInstructionTable)
+{
+    static const AddressModeFunc MODES[] = {
+        &CPU::IMP, &CPU::ACC, &CPU::IMM, &CPU::ZP0, &CPU::ZPX, &CPU::ZPY, &CPU::REL,
+        &CPU::ABS, &CPU::ABX, &CPU::ABY, &CPU::IND, &CPU::IZX, &CPU::IZY
+    };
+    static const CPU::AddressingMode ENUMS[] = {
+        CPU::M_IMP, CPU::M_ACC, CPU::M_IMM, CPU::M_ZP0, CPU::M_ZPX, CPU::M_ZPY, CPU::M_REL,
+        CPU::M_ABS, CPU::M_ABX, CPU::M_ABY, CPU::M_IND, CPU::M_IZX, CPU::M_IZY
+    };
+
+    for (int op = 0; op < 256; ++op)
+    {
+        EXPECT_STREQ(OPCODE_TABLE[op].mnemonic, INSTRUCTION_TABLE[op].name) << "opcode " << op;
+
+        for (size_t m = 0; m < sizeof(MODES) / sizeof(MODES[0]); ++m)
+        {
+            if (INSTRUCTION_TABLE[op].addrMode == MODES[m])
+            {
+                EXPECT_EQ(OPCODE_TABLE[op].mode, ENUMS[m]) << "opcode " << op;
+            }
+        }
+    }
+}
+
+TEST(DisassemblerTest, FormatsIntoCallerBuffer)
+{
+    char line[64];
+
+    const uint8_t lda[] = { 0xBD, 0x00, 0x02 };
+    Disassembler::FormatLine(0x8000, lda, line, sizeof(line));
+    EXPECT_STREQ(line, "8000  BD 00 02  LDA $0200,X");
+
+    const uint8_t bne[] = { 0xD0, 0xFC, 0x00 };
+    Disassembler::FormatLine(0x8010, bne, line, sizeof(line));
+    EXPECT_STREQ(line, "8010  D0 FC     BNE $800E");
+
+    const uint8_t asl[] = { 0x0A, 0x00, 0x00 };
+    Disassembler::FormatInstruction(0x8000, asl, line, sizeof(line));
+    EXPECT_STREQ(line, "ASL A");
+}
+
+// Two 16KB banks on UxROM: $8000 switchable, $C000 fixed to bank 1
+static std::vector<uint8_t> MakeUxROM()
+{
+    std::vector<uint8_t> rom = MakeTestROM({}, 2, 2, 1);
+
+    uint8_t* fixed = &rom[TEST_ROM_PRG + 0x4000];
+    const uint8_t code[] = {
+        0x20, 0x10, 0xC0,  // C000  JSR $C010
+        0x4C, 0x00, 0x80,  // C003  JMP $8000  ; switchable bank: unresolved
+    };
+    const uint8_t sub[] = {
+        0xA9, 0x01,        // C010  LDA #$01
+        0xD0, 0x01,        // C012  BNE $C015
+        0x02,              // C014  .byte $02  ; skipped data
+        0x60,              // C015  RTS
+    };
+    std::memcpy(fixed, code, sizeof(code));
+    std::memcpy(fixed + 0x10, sub, sizeof(sub));
+    fixed[0x20] = 0x40;    // C020  RTI
+
+    SetTestROMVector(rom, 0xFFFA, 0xC020);
+    SetTestROMVector(rom, 0xFFFC, 0xC000);
+    SetTestROMVector(rom, 0xFFFE, 0xC020);
+    return rom;
+}
+
+TEST(StaticDisassemblerTest, FollowsFlowFromVectorsPerBank)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeUxROM()));
+
+    StaticDisassembler disassembler;
+    ASSERT_TRUE(disassembler.Analyze(cartridge));
+
+    // Offsets are PRG-ROM offsets; the fixed bank starts at $4000
+    EXPECT_EQ(disassembler.GetFlags(0x4000) & StaticDisassembler::F_VECTOR, StaticDisassembler::F_VECTOR);
+    EXPECT_EQ(disassembler.GetAddress(0x4000), 0xC000);
+    EXPECT_TRUE(disassembler.GetFlags(0x4010) & StaticDisassembler::F_SUBROUTINE);
+    EXPECT_TRUE(disassembler.GetFlags(0x4015) & StaticDisassembler::F_OPCODE);
+    EXPECT_FALSE(disassembler.GetFlags(0x4014) & StaticDisassembler::F_CODE);
+    EXPECT_TRUE(disassembler.GetFlags(0x4020) & StaticDisassembler::F_OPCODE);
+
+    // Nothing in the switchable bank is reachable without knowing the bank
+    EXPECT_EQ(disassembler.GetFlags(0x0000), 0);
+    ASSERT_EQ(disassembler.GetUnresolved().size(), 1u);
+    EXPECT_EQ(disassembler.GetUnresolved()[0].from, 0x4003u);
+    EXPECT_EQ(disassembler.GetUnresolved()[0].target, 0x8000);
+
+    EXPECT_EQ(disassembler.GetInstructionCount(), 6u);
+}
@@ -0,0 +1,100 @@
+#include <filesystem>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/Machine.h"
+#include "utils/FrameHash.h"
+
+
+// NROM image that polls pad 1 forever and counts A presses in $0010
+static std::vector<uint8_t> MakeInputROM()
+{
+    return MakeTestROM({
+        0xA9, 0x01,        // LDA #$01
+        0x8D, 0x16, 0x40,  // STA $4016 ; strobe
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x16, 0x40,  // STA $4016
+        0xAD, 0x16, 0x40,  // LDA $4016 ; A button
+        0x29, 0x01,        // AND #$01
+        0x18,              // CLC
+        0x65, 0x10,        // ADC $10
+        0x85, 0x10,        // STA $10
+        0x4C, 0x00, 0x80,  // JMP $8000
+    });
+}
+
+
+TEST(InputScriptTest, StateHoldsUntilNextEvent)
+{
+    const char* text =
+        "# frame pad1 pad2\n"
+        "10 80\n"
+        "5 01 02   # out of order is fine\n"
+        "\n"
+        "20 00 40\n";
+
+    InputScript script;
+    ASSERT_TRUE(script.Parse(text, std::strlen(text)));
+
+    EXPECT_EQ(script.GetState(0, 0), 0x00);
+    EXPECT_EQ(script.GetState(0, 5), 0x01);
+    EXPECT_EQ(script.GetState(1, 9), 0x02);
+    EXPECT_EQ(script.GetState(0, 10), 0x80);
+    EXPECT_EQ(script.GetState(1, 10), 0x00);
+    EXPECT_EQ(script.GetState(1, 1000), 0x40);
+
+    const char* bad = "1 zz\n";
+    EXPECT_FALSE(script.Parse(bad, std::strlen(bad)));
+}
+
+TEST(FrameHashTest, RunsAreDeterministicAndInputDiverges)
+{
+    std::vector<uint8_t> rom = MakeInputROM();
+
+    std::vector<FrameHash> first, second, pressed;
+    {
+        Machine machine;
+        ASSERT_TRUE(machine.LoadFromMemory(rom));
+        FrameHash::Run(machine, 8, nullptr, first);
+        EXPECT_EQ(machine.GetFrameCount(), 8u);
+    }
+    {
+        Machine machine;
+        ASSERT_TRUE(machine.LoadFromMemory(rom));
+        FrameHash::Run(machine, 8, nullptr, second);
+    }
+
+    ASSERT_EQ(first.size(), 8u);
+    EXPECT_EQ(FrameHash::FindMismatch(first, second), -1);
+
+    // Pressing A from frame 3 changes RAM from that frame on
+    const char* text = "3 80\n";
+    InputScript script;
+    ASSERT_TRUE(script.Parse(text, std::strlen(text)));
+    {
+        Machine machine;
+        ASSERT_TRUE(machine.LoadFromMemory(rom));
+        FrameHash::Run(machine, 8, &script, pressed);
+        EXPECT_NE(machine.GetMemory().Read(0x0010), 0);
+    }
+
+    EXPECT_EQ(FrameHash::FindMismatch(first, pressed), 3);
+    EXPECT_EQ(first[3].screen, pressed[3].screen);
+    EXPECT_NE(first[3].ram, pressed[3].ram);
+}
+
+TEST(FrameHashTest, GoldenFileRoundTrip)
+{
+    std::vector<FrameHash> hashes = { { 0x0123456789ABCDEFULL, 1 }, { 2, 0xFEDCBA9876543210ULL } };
+
+    std::string file = (std::filesystem::path(::testing::TempDir()) / "frame_hash_test.fh").string();
+    ASSERT_TRUE(FrameHash::Save(file, hashes));
+
+    std::vector<FrameHash> loaded;
+    ASSERT_TRUE(FrameHash::Load(file, loaded));
+    EXPECT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(FrameHash::FindMismatch(hashes, loaded), -1);
+    EXPECT_EQ(loaded[1].ram, 0xFEDCBA9876543210ULL);
+
+    std::filesystem::remove(file);
+}
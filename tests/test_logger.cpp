@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utils/Logger.h"
+
+
+// Route the logger to a temporary file for the duration of a test
+class ScopedLogFile
+{
+public:
+    explicit ScopedLogFile(const std::string& name)
+        : path(::testing::TempDir() + name)
+    {
+        Logger::GetInstance().SetConsoleOutput(false);
+        Logger::GetInstance().Initialize(path, LogLevel::INFO);
+    }
+
+    ~ScopedLogFile()
+    {
+        Logger& logger = Logger::GetInstance();
+        logger.Shutdown();
+        logger.SetFileOutput(false);
+        logger.SetConsoleOutput(true);
+        logger.SetLogLevel(LogLevel::INFO);
+        std::remove(path.c_str());
+    }
+
+    std::vector<std::string> ReadLines() const
+    {
+        Logger::GetInstance().Flush();
+
+        std::vector<std::string> lines;
+        std::ifstream in(path);
+        for (std::string line; std::getline(in, line); )
+            lines.push_back(line);
+        return lines;
+    }
+
+    std::string path;
+};
+
+
+TEST(LoggerTest, FlushWritesLinesInOrder)
+{
+    ScopedLogFile log("logger_order.log");
+
+    for (int i = 0; i < 100; ++i)
+        LOG_INFO("line %d", i);
+
+    int expected = 0;
+    for (const std::string& line : log.ReadLines())
+    {
+        size_t pos = line.find("] line ");
+        if (pos == std::string::npos)
+            continue;
+        EXPECT_EQ(std::stoi(line.substr(pos + 7)), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, 100);
+}
+
+TEST(LoggerTest, ErrorsAreNeverDropped)
+{
+    ScopedLogFile log("logger_errors.log");
+
+    // Far more than the ring holds, faster than it can drain
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+        LOG_ERROR("err %d", i);
+
+    int seen = 0;
+    for (const std::string& line : log.ReadLines())
+    {
+        if (line.find("] err ") != std::string::npos)
+            seen++;
+    }
+    EXPECT_EQ(seen, count);
+}
+
+TEST(LoggerTest, DisabledLevelIsSkipped)
+{
+    ScopedLogFile log("logger_level.log");
+
+    uint64_t before = Logger::GetInstance().GetLogCount();
+    LOG_DEBUG("not logged");
+    EXPECT_EQ(Logger::GetInstance().GetLogCount(), before);
+}
@@ -0,0 +1,186 @@
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/Machine.h"
+
+
+// UxROM image (CHR-RAM) whose main loop counts A-button samples into $10,
+// mirrors the count to PRG-RAM and bumps a loop counter in $11, with
+// rendering on so the screen depends on VRAM and CHR-RAM
+static std::vector<uint8_t> MakeForkROM()
+{
+    return MakeTestROM({
+        0xA9, 0x1E,        // LDA #$1E
+        0x8D, 0x01, 0x20,  // STA $2001 ; rendering on
+        0xA9, 0x01,        // LDA #$01  ; $8005
+        0x8D, 0x16, 0x40,  // STA $4016
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x16, 0x40,  // STA $4016
+        0xAD, 0x16, 0x40,  // LDA $4016 ; A button
+        0x29, 0x01,        // AND #$01
+        0x18,              // CLC
+        0x65, 0x10,        // ADC $10
+        0x85, 0x10,        // STA $10
+        0x8D, 0x00, 0x60,  // STA $6000
+        0xE6, 0x11,        // INC $11
+        0x4C, 0x05, 0x80,  // JMP $8005
+    }, 2, 2, 0);
+}
+
+static void ExpectSameState(Machine& a, Machine& b)
+{
+    EXPECT_EQ(a.GetCPU().PC, b.GetCPU().PC);
+    EXPECT_EQ(a.GetCPU().A, b.GetCPU().A);
+    EXPECT_EQ(a.GetCPU().GetTotalCycles(), b.GetCPU().GetTotalCycles());
+    EXPECT_EQ(a.GetFrameCount(), b.GetFrameCount());
+
+    uint8_t ramA[0x0800], ramB[0x0800];
+    a.GetMemory().CopyTo(0x0000, ramA, sizeof(ramA));
+    b.GetMemory().CopyTo(0x0000, ramB, sizeof(ramB));
+    EXPECT_EQ(std::memcmp(ramA, ramB, sizeof(ramA)), 0);
+
+    EXPECT_EQ(std::memcmp(a.GetPPU().GetScreenBuffer(), b.GetPPU().GetScreenBuffer(),
+                          PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT), 0);
+}
+
+class MachineForkTest : public ::testing::Test
+{
+protected:
+    Machine parent;
+    Machine control; // Never forked, follows the parent's inputs
+
+    void SetUp() override
+    {
+        std::vector<uint8_t> rom = MakeForkROM();
+        ASSERT_TRUE(parent.LoadFromMemory(rom));
+        ASSERT_TRUE(control.LoadFromMemory(rom));
+
+        // Something in the nametables and CHR-RAM to draw
+        for (Machine* m : { &parent, &control })
+        {
+            for (uint16_t i = 0; i < 0x0400; ++i)
+                m->GetPPU().PPUWrite(0x2000 + i, (uint8_t) i);
+            for (uint16_t i = 0; i < 0x2000; ++i)
+                m->GetPPU().PPUWrite(i, (uint8_t) (i * 13));
+            m->GetPPU().PPUWrite(0x3F01, 0x16);
+            m->GetPPU().PPUWrite(0x3F02, 0x2A);
+            m->GetPPU().PPUWrite(0x3F03, 0x12);
+        }
+
+        RunBoth(parent, control, 2, Controller::A);
+    }
+
+    static void RunBoth(Machine& a, Machine& b, int frames, uint8_t buttons)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            a.SetControllerState(0, buttons);
+            b.SetControllerState(0, buttons);
+            a.RunFrame();
+            b.RunFrame();
+        }
+    }
+};
+
+TEST_F(MachineForkTest, ForkContinuesLikeTheParent)
+{
+    std::unique_ptr<Machine> fork = parent.Fork();
+    ExpectSameState(*fork, parent);
+
+    RunBoth(*fork, parent, 3, Controller::A);
+    ExpectSameState(*fork, parent);
+    EXPECT_EQ(fork->GetCartridge().CPURead(0x6000), parent.GetCartridge().CPURead(0x6000));
+}
+
+TEST_F(MachineForkTest, ForksDivergeWithoutTouchingTheParent)
+{
+    std::unique_ptr<Machine> fork = parent.Fork();
+    std::unique_ptr<Machine> sibling = parent.Fork();
+
+    // Different input on each fork, the original's on the parent
+    RunBoth(*fork, *sibling, 2, 0);
+    fork->SetControllerState(0, Controller::A);
+    fork->RunFrame();
+    RunBoth(parent, control, 3, Controller::A);
+
+    ExpectSameState(parent, control);
+    EXPECT_NE(fork->GetMemory().Read(0x0010), parent.GetMemory().Read(0x0010));
+    EXPECT_NE(fork->GetMemory().Read(0x0010), sibling->GetMemory().Read(0x0010));
+    EXPECT_EQ(parent.GetCartridge().CPURead(0x6000), control.GetCartridge().CPURead(0x6000));
+
+    // VRAM and CHR-RAM writes stay on their side too
+    fork->GetPPU().PPUWrite(0x2000, 0xEE);
+    fork->GetPPU().PPUWrite(0x0000, 0xEE);
+    EXPECT_EQ(fork->GetPPU().PPURead(0x0000), 0xEE);
+    EXPECT_EQ(parent.GetPPU().PPURead(0x0000), control.GetPPU().PPURead(0x0000));
+    EXPECT_EQ(parent.GetPPU().PPURead(0x2000), control.GetPPU().PPURead(0x2000));
+
+    parent.GetPPU().PPUWrite(0x0001, 0x55);
+    EXPECT_EQ(parent.GetPPU().PPURead(0x0001), 0x55);
+    EXPECT_NE(fork->GetPPU().PPURead(0x0001), 0x55);
+    EXPECT_NE(sibling->GetPPU().PPURead(0x0001), 0x55);
+}
+
+TEST_F(MachineForkTest, PagesAreSharedUntilWritten)
+{
+    std::unique_ptr<Machine> fork = parent.Fork();
+    EXPECT_EQ(fork->GetMemory().GetOwnedPageCount(), 0u);
+    EXPECT_EQ(parent.GetMemory().GetOwnedPageCount(), 0u);
+
+    fork->GetMemory().Write(0x0123, 0x42);
+    EXPECT_EQ(fork->GetMemory().GetOwnedPageCount(), 1u);
+    EXPECT_EQ(fork->GetMemory().Read(0x0123), 0x42);
+    EXPECT_EQ(parent.GetMemory().Read(0x0123), control.GetMemory().Read(0x0123));
+
+    // Once the fork is gone the parent's pages are its own again
+    fork.reset();
+    EXPECT_GT(parent.GetMemory().GetOwnedPageCount(), 0u);
+}
+
+TEST_F(MachineForkTest, PipelinedParentForksItsLastFrame)
+{
+    ASSERT_TRUE(parent.SetPipelinedPPU(true));
+    RunBoth(parent, control, 2, Controller::A);
+
+    std::unique_ptr<Machine> fork = parent.Fork();
+    EXPECT_FALSE(fork->IsPipelinedPPU());
+    EXPECT_FALSE(fork->GetPPU().IsPipelined());
+    EXPECT_FALSE(fork->GetPPU().IsSkipRender());
+    ExpectSameState(*fork, control);
+
+    RunBoth(*fork, control, 2, Controller::A);
+    ExpectSameState(*fork, control);
+}
+
+TEST_F(MachineForkTest, ForksRunOnOtherThreadsBesideTheParent)
+{
+    // Forked while paused; from then on every copy writes the pages they
+    // share from its own thread
+    std::vector<std::unique_ptr<Machine>> forks;
+    for (int i = 0; i < 3; ++i)
+        forks.push_back(parent.Fork());
+
+    auto run = [](Machine* machine)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            machine->SetControllerState(0, Controller::A);
+            machine->RunFrame();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(run, &parent);
+    for (std::unique_ptr<Machine>& fork : forks)
+        threads.emplace_back(run, fork.get());
+    for (std::thread& thread : threads)
+        thread.join();
+
+    run(&control);
+    ExpectSameState(parent, control);
+    for (std::unique_ptr<Machine>& fork : forks)
+        ExpectSameState(*fork, control);
+}
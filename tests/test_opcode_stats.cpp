@@ -0,0 +1,65 @@
+#include <cstring>
+#include "TestFixture.h"
+#include "cpu/OpcodeStats.h"
+
+
+TEST(OpcodeStatsTest, RecordAccumulates)
+{
+    OpcodeStats stats;
+
+    stats.Record(0xBD, 4, false, false); // LDA $nnnn,X
+    stats.Record(0xBD, 5, true, false);  // page crossed
+    stats.Record(0xD0, 3, false, true);  // BNE taken
+
+    EXPECT_EQ(stats.Get(0xBD).executions, 2u);
+    EXPECT_EQ(stats.Get(0xBD).cycles, 9u);
+    EXPECT_EQ(stats.Get(0xBD).pageCrossings, 1u);
+    EXPECT_EQ(stats.Get(0xD0).branchesTaken, 1u);
+    EXPECT_EQ(stats.GetTotalExecutions(), 3u);
+    EXPECT_EQ(stats.GetTotalCycles(), 12u);
+
+    stats.Reset();
+    EXPECT_EQ(stats.GetTotalExecutions(), 0u);
+}
+
+TEST(OpcodeStatsTest, DumpListsHottestFirst)
+{
+    OpcodeStats stats;
+    stats.Record(0xEA, 2, false, false); // NOP
+    stats.Record(0x20, 6, false, false); // JSR
+
+    char buffer[1024] = {};
+    FILE* out = fmemopen(buffer, sizeof(buffer) - 1, "w");
+    ASSERT_NE(out, nullptr);
+    stats.Dump(out);
+    std::fclose(out);
+
+    const char* jsr = std::strstr(buffer, "JSR");
+    const char* nop = std::strstr(buffer, "NOP");
+    ASSERT_NE(jsr, nullptr);
+    ASSERT_NE(nop, nullptr);
+    EXPECT_LT(jsr, nop);
+}
+
+#ifdef CPU_OPCODE_STATS
+TEST_F(CPUTest, OpcodeStats_CountsBranchesAndCycles)
+{
+    uint8_t program[] = {
+        0xA2, 0x00,  // LDX #$00
+        0xE8,        // INX
+        0xE0, 0x03,  // CPX #$03
+        0xD0, 0xFB,  // BNE -5
+    };
+    cpu.LoadProgram(program, sizeof(program));
+    cpu.GetOpcodeStats().Reset();
+
+    for (int i = 0; i < 1 + 3 * 3; ++i)
+        cpu.Step();
+
+    const OpcodeStats& stats = cpu.GetOpcodeStats();
+    EXPECT_EQ(stats.Get(0xE8).executions, 3u);
+    EXPECT_EQ(stats.Get(0xD0).executions, 3u);
+    EXPECT_EQ(stats.Get(0xD0).branchesTaken, 2u);
+    EXPECT_EQ(stats.Get(0xD0).cycles, 3u + 3u + 2u);
+}
+#endif
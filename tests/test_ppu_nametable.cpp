@@ -0,0 +1,80 @@
+#include <vector>
+
+#include "TestFixture.h"
+
+
+// Nametable mirroring as seen through the PPU address space, for header
+// mirroring, four-screen VRAM and mapper-controlled mirroring
+class PPUNametableTest : public ::testing::Test
+{
+protected:
+    Memory memory;
+    Bus bus;
+    CPU cpu;
+    PPU ppu;
+    Cartridge cartridge;
+
+    void Load(uint8_t mapper, uint8_t flags6)
+    {
+        bus.ConnectMemory(&memory);
+        bus.ConnectCPU(&cpu);
+        bus.ConnectPPU(&ppu);
+        ASSERT_TRUE(cartridge.LoadFromMemory(MakeTestROM({}, mapper, 1, 1, flags6)));
+        bus.InsertCartridge(&cartridge);
+        bus.Reset();
+    }
+
+    // Tag the first byte of each logical nametable, then read them back
+    std::vector<uint8_t> WriteAndReadBack()
+    {
+        for (uint16_t table = 0; table < 4; ++table)
+            ppu.PPUWrite(0x2000 + table * 0x0400, (uint8_t) (0x10 + table));
+
+        std::vector<uint8_t> result;
+        for (uint16_t table = 0; table < 4; ++table)
+            result.push_back(ppu.PPURead(0x2000 + table * 0x0400));
+        return result;
+    }
+
+    // MMC1 registers are loaded serially, LSB first
+    void WriteMMC1(uint16_t address, uint8_t value)
+    {
+        for (int bit = 0; bit < 5; ++bit)
+            bus.CPUWrite(address, (value >> bit) & 0x01);
+    }
+};
+
+TEST_F(PPUNametableTest, HorizontalMirroring)
+{
+    Load(0, 0x00);
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x11, 0x11, 0x13, 0x13 }));
+}
+
+TEST_F(PPUNametableTest, VerticalMirroring)
+{
+    Load(0, 0x01);
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x12, 0x13, 0x12, 0x13 }));
+}
+
+TEST_F(PPUNametableTest, FourScreenKeepsAllTablesDistinct)
+{
+    Load(4, 0x08);
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x10, 0x11, 0x12, 0x13 }));
+
+    // $3000-$3EFF mirrors $2000-$2EFF
+    EXPECT_EQ(ppu.PPURead(0x3C00), 0x13);
+}
+
+TEST_F(PPUNametableTest, MapperMirroringSwitch)
+{
+    Load(1, 0x00);
+
+    WriteMMC1(0x8000, 0x0E); // PRG mode 3, vertical
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x12, 0x13, 0x12, 0x13 }));
+
+    WriteMMC1(0x8000, 0x0F); // PRG mode 3, horizontal
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x11, 0x11, 0x13, 0x13 }));
+
+    WriteMMC1(0x8000, 0x0D); // PRG mode 3, one-screen upper
+    EXPECT_EQ(WriteAndReadBack(), (std::vector<uint8_t>{ 0x13, 0x13, 0x13, 0x13 }));
+}
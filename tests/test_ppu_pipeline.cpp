@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/Machine.h"
+
+
+// CNROM image that loads a palette, turns rendering on and then hammers
+// everything the render thread has to replay, all mid-frame: scroll, CHR
+// bank switches, $2006/$2007 writes, $2007/$2002 reads and OAM DMA
+static std::vector<uint8_t> MakeStressROM()
+{
+    std::vector<uint8_t> rom = MakeTestROM({
+        0xA9, 0x3F,        // LDA #$3F
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x06, 0x20,  // STA $2006
+        0xA0, 0x00,        // LDY #$00
+        0x98,              // TYA       ; palette entry = index
+        0x8D, 0x07, 0x20,  // STA $2007
+        0xC8,              // INY
+        0xC0, 0x20,        // CPY #$20
+        0xD0, 0xF7,        // BNE -9
+        0xA9, 0x1E,        // LDA #$1E
+        0x8D, 0x01, 0x20,  // STA $2001 ; rendering on
+        0xA9, 0x98,        // LDA #$98
+        0x8D, 0x00, 0x20,  // STA $2000 ; NMI, $1000 patterns
+        0xE8,              // INX       ; $801F
+        0x8E, 0x05, 0x20,  // STX $2005
+        0x8E, 0x05, 0x20,  // STX $2005
+        0x8A,              // TXA
+        0x29, 0x01,        // AND #$01
+        0x8D, 0x00, 0x80,  // STA $8000 ; CHR bank
+        0x8E, 0x06, 0x20,  // STX $2006
+        0x8E, 0x06, 0x20,  // STX $2006
+        0x8E, 0x07, 0x20,  // STX $2007
+        0xAD, 0x07, 0x20,  // LDA $2007
+        0xAD, 0x02, 0x20,  // LDA $2002
+        0x8E, 0x03, 0x02,  // STX $0203 ; sprite 0 X
+        0xA9, 0x02,        // LDA #$02
+        0x8D, 0x14, 0x40,  // STA $4014
+        0x4C, 0x1F, 0x80,  // JMP $801F
+    }, 3, 1, 2);
+
+    // Different patterns in each CHR bank
+    for (size_t i = 0; i < 2 * 0x2000; ++i)
+        rom[TEST_ROM_PRG + 0x4000 + i] = (uint8_t) ((i * 37 + (i >> 8)) ^ (i >= 0x2000 ? 0xA5 : 0x00));
+
+    return rom;
+}
+
+class PPUPipelineTest : public ::testing::Test
+{
+protected:
+    Machine serial;
+    Machine pipelined;
+
+    void SetUp() override
+    {
+        std::vector<uint8_t> rom = MakeStressROM();
+        ASSERT_TRUE(serial.LoadFromMemory(rom));
+        ASSERT_TRUE(pipelined.LoadFromMemory(rom));
+        ASSERT_TRUE(pipelined.SetPipelinedPPU(true));
+    }
+
+    // Run a frame on both and compare what they show
+    void RunAndCompare(int frames)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            serial.RunFrame();
+            pipelined.RunFrame();
+
+            ASSERT_EQ(std::memcmp(serial.GetPPU().GetScreenBuffer(), pipelined.GetPPU().GetScreenBuffer(),
+                                  PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT), 0)
+                << "frame " << serial.GetFrameCount();
+            uint8_t serialRAM[0x0800], pipelinedRAM[0x0800];
+            serial.GetMemory().CopyTo(0x0000, serialRAM, sizeof(serialRAM));
+            pipelined.GetMemory().CopyTo(0x0000, pipelinedRAM, sizeof(pipelinedRAM));
+            ASSERT_EQ(std::memcmp(serialRAM, pipelinedRAM, sizeof(serialRAM)), 0)
+                << "frame " << serial.GetFrameCount();
+        }
+    }
+};
+
+TEST_F(PPUPipelineTest, FramesMatchSerialRendering)
+{
+    RunAndCompare(4);
+
+    // Make sure the comparison is not between two blank screens
+    const uint8_t* screen = pipelined.GetPPU().GetScreenBuffer();
+    std::set<uint8_t> colours(screen, screen + PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT);
+    EXPECT_GT(colours.size(), 4u);
+}
+
+TEST_F(PPUPipelineTest, ResetAndSkipRenderAreReplayed)
+{
+    RunAndCompare(2);
+
+    serial.Reset();
+    pipelined.Reset();
+    RunAndCompare(1);
+
+    serial.GetPPU().SetSkipRender(true);
+    pipelined.GetPPU().SetSkipRender(true);
+    RunAndCompare(1);
+
+    serial.GetPPU().SetSkipRender(false);
+    pipelined.GetPPU().SetSkipRender(false);
+    RunAndCompare(2);
+}
+
+TEST_F(PPUPipelineTest, StoppingHandsBackToTheSerialPPU)
+{
+    RunAndCompare(2);
+
+    ASSERT_TRUE(pipelined.SetPipelinedPPU(false));
+    EXPECT_FALSE(pipelined.GetPPU().IsPipelined());
+    EXPECT_FALSE(pipelined.GetPPU().IsSkipRender());
+    EXPECT_EQ(std::memcmp(serial.GetPPU().GetScreenBuffer(), pipelined.GetPPU().GetScreenBuffer(),
+                          PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT), 0);
+
+    RunAndCompare(2);
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestFixture.h"
+#include "ppu/Palette.h"
+
+
+// PPU driven on its own with an NROM CHR-RAM cartridge; sprites only, drawn
+// in a single colour so a frame can be checked by counting pixels
+class PPUSpriteTest : public ::testing::Test
+{
+protected:
+    static constexpr uint8_t SPRITE_COLOUR = 0x16;
+
+    Memory memory;
+    Bus bus;
+    CPU cpu;
+    PPU ppu;
+    Cartridge cartridge;
+
+    void SetUp() override
+    {
+        bus.ConnectMemory(&memory);
+        bus.ConnectCPU(&cpu);
+        bus.ConnectPPU(&ppu);
+        ASSERT_TRUE(cartridge.LoadFromMemory(MakeTestROM({}, 0, 1, 0)));
+        bus.InsertCartridge(&cartridge);
+        bus.Reset();
+
+        ppu.PPUWrite(0x3F00, 0x0F);
+        ppu.PPUWrite(0x3F11, SPRITE_COLOUR);
+
+        // Tile 1 in both pattern tables: plane 0 solid
+        SetTileRows(0x0010, 0xFF);
+        SetTileRows(0x1010, 0xFF);
+
+        ppu.CPUWrite(0x2001, 0x14); // Sprites, including the left column
+    }
+
+    void SetTileRows(uint16_t address, uint8_t bits)
+    {
+        for (int row = 0; row < 8; ++row)
+            ppu.PPUWrite(address + row, bits);
+    }
+
+    void SetSprite(uint8_t index, uint8_t y, uint8_t tile, uint8_t x)
+    {
+        ppu.CPUWrite(0x2003, index * 4);
+        ppu.CPUWrite(0x2004, y);
+        ppu.CPUWrite(0x2004, tile);
+        ppu.CPUWrite(0x2004, 0x00);
+        ppu.CPUWrite(0x2004, x);
+    }
+
+    void RunUntilScanline(int scanline)
+    {
+        while (ppu.GetScanline() != scanline)
+            ppu.Clock();
+    }
+
+    size_t RunFrame()
+    {
+        do
+        {
+            ppu.Clock();
+        } while (!ppu.IsFrameComplete());
+        ppu.ClearFrameComplete();
+
+        const uint8_t* screen = ppu.GetScreenBuffer();
+        return std::count(screen, screen + PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT, SPRITE_COLOUR);
+    }
+};
+
+TEST_F(PPUSpriteTest, OAMChangesRebuildBins)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0); // Off screen
+
+    SetSprite(0, 50, 1, 200);
+    RunFrame();
+    EXPECT_EQ(RunFrame(), 64u);
+
+    // More than 8 sprites on a line: only the first 8 in OAM order show
+    for (int i = 1; i < 10; ++i)
+        SetSprite(i, 50, 1, (uint8_t) (i * 16));
+    RunFrame();
+    EXPECT_EQ(RunFrame(), 8u * 64u);
+}
+
+TEST_F(PPUSpriteTest, NinthSpriteOnALineSetsOverflow)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    for (int i = 0; i < 8; ++i)
+        SetSprite(i, 50, 1, (uint8_t) (i * 16));
+
+    // Eight on a line is fine
+    RunFrame();
+    RunUntilScanline(240);
+    EXPECT_EQ(ppu.CPURead(0x2002) & 0x20, 0x00);
+
+    // Binned: the 9th sprite only sets the flag
+    SetSprite(8, 50, 1, 128);
+    RunFrame();
+    RunUntilScanline(240);
+    EXPECT_EQ(ppu.CPURead(0x2002) & 0x20, 0x20);
+
+    // Cleared on the pre-render line
+    SetSprite(8, 0xF0, 0, 0);
+    RunFrame();
+    RunUntilScanline(240);
+    EXPECT_EQ(ppu.CPURead(0x2002) & 0x20, 0x00);
+
+    // Direct: OAM written during rendering, after the bins were built
+    RunFrame();
+    RunUntilScanline(20);
+    for (int i = 0; i < 9; ++i)
+        SetSprite(i, 100, 1, (uint8_t) (i * 16));
+    RunUntilScanline(240);
+    EXPECT_EQ(ppu.CPURead(0x2002) & 0x20, 0x20);
+}
+
+TEST_F(PPUSpriteTest, CHRWritesRefetchCachedPatterns)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 100);
+    RunFrame();
+    EXPECT_EQ(RunFrame(), 64u);
+
+    // Same OAM, new pattern data: half of each row left
+    SetTileRows(0x0010, 0x0F);
+    EXPECT_EQ(RunFrame(), 32u);
+
+    // Switching the sprite pattern table is picked up without an OAM change
+    ppu.CPUWrite(0x2000, 0x08);
+    EXPECT_EQ(RunFrame(), 64u);
+}
+
+TEST_F(PPUSpriteTest, SpriteSizeChangeRebuildsBins)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 100);
+    RunFrame();
+    EXPECT_EQ(RunFrame(), 64u);
+
+    // 8x16: tile 1 selects the $1000 table, tiles $00 (empty) and $01
+    ppu.CPUWrite(0x2000, 0x20);
+    EXPECT_EQ(RunFrame(), 64u);
+
+    SetTileRows(0x1000, 0xFF);
+    EXPECT_EQ(RunFrame(), 128u);
+}
+
+TEST_F(PPUSpriteTest, MidFrameOAMWritesAreVisible)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 100);
+    RunFrame();
+    EXPECT_EQ(RunFrame(), 64u);
+
+    // Add a sprite below the current scanline: drawn in this same frame
+    RunUntilScanline(100);
+    SetSprite(1, 150, 1, 20);
+    RunUntilScanline(120);
+    SetSprite(2, 180, 1, 40);
+
+    do
+    {
+        ppu.Clock();
+    } while (!ppu.IsFrameComplete());
+    ppu.ClearFrameComplete();
+
+    const uint8_t* screen = ppu.GetScreenBuffer();
+    EXPECT_EQ(std::count(screen, screen + PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT, SPRITE_COLOUR), 3 * 64);
+}
+
+TEST_F(PPUSpriteTest, DirectARGBOutputMatchesScreenBuffer)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 100);
+
+    // Padded pitch, as a locked texture may have
+    const int pitch = (PPU::SCREEN_WIDTH + 16) * 4;
+    std::vector<uint32_t> pixels(pitch / 4 * PPU::SCREEN_HEIGHT, 0);
+    ppu.SetOutputBuffer(pixels.data(), pitch);
+
+    EXPECT_EQ(RunFrame(), 64u);
+    EXPECT_EQ(pixels[55 * (pitch / 4) + 104], Palette::ARGB[SPRITE_COLOUR]);
+
+    // Grayscale takes effect through the palette cache
+    ppu.CPUWrite(0x2001, 0x15);
+    EXPECT_EQ(RunFrame(), 0u);
+    EXPECT_EQ(pixels[55 * (pitch / 4) + 104], Palette::ARGB[SPRITE_COLOUR & 0x30]);
+
+    const uint8_t* screen = ppu.GetScreenBuffer();
+    for (int y = 0; y < PPU::SCREEN_HEIGHT; ++y)
+        for (int x = 0; x < PPU::SCREEN_WIDTH; ++x)
+            ASSERT_EQ(pixels[y * (pitch / 4) + x], Palette::ARGB[screen[y * PPU::SCREEN_WIDTH + x]]);
+
+    ppu.SetOutputBuffer(nullptr, 0);
+}
+
+TEST_F(PPUSpriteTest, SkipRenderKeepsStatusFlags)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 200);
+
+    // Nine on one line, for the overflow flag
+    for (int i = 1; i < 10; ++i)
+        SetSprite(i, 120, 1, (uint8_t) (i * 16));
+
+    // Opaque background under sprite 0
+    for (uint16_t column = 0; column < 32; ++column)
+    {
+        ppu.PPUWrite(0x2000 + 6 * 32 + column, 0x01);
+        ppu.PPUWrite(0x2000 + 7 * 32 + column, 0x01);
+    }
+    ppu.CPUWrite(0x2001, 0x1E);
+
+    for (bool skip : { false, true })
+    {
+        ppu.SetSkipRender(skip);
+        RunFrame();
+        std::vector<uint8_t> before(ppu.GetScreenBuffer(), ppu.GetScreenBuffer() + PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT);
+
+        RunUntilScanline(240);
+        uint8_t status = ppu.CPURead(0x2002);
+        EXPECT_EQ(status & 0x40, 0x40) << "skip=" << skip; // Sprite 0 hit
+        EXPECT_EQ(status & 0x20, 0x20) << "skip=" << skip; // Sprite overflow
+
+        // Skipped frames leave the last drawn picture alone
+        if (skip)
+        {
+            EXPECT_TRUE(std::equal(before.begin(), before.end(), ppu.GetScreenBuffer()));
+        }
+    }
+
+    ppu.SetSkipRender(false);
+}
+
+TEST_F(PPUSpriteTest, PreRenderClearsFlagsOnOddFrames)
+{
+    for (int i = 0; i < 64; ++i)
+        SetSprite(i, 0xF0, 0, 0);
+    SetSprite(0, 50, 1, 200);
+
+    // Opaque background under sprite 0
+    for (uint16_t column = 0; column < 32; ++column)
+    {
+        ppu.PPUWrite(0x2000 + 6 * 32 + column, 0x01);
+        ppu.PPUWrite(0x2000 + 7 * 32 + column, 0x01);
+    }
+    ppu.CPUWrite(0x2001, 0x1E);
+
+    // The odd frames skip dot 0 of the pre-render line
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        RunUntilScanline(10);
+        EXPECT_EQ(ppu.CPURead(0x2002) & 0xC0, 0x00) << "frame " << ppu.GetFrameCount(); // VBlank, sprite 0 hit
+
+        RunUntilScanline(240);
+        EXPECT_EQ(ppu.CPURead(0x2002) & 0x40, 0x40) << "frame " << ppu.GetFrameCount();
+    }
+}
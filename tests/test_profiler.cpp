@@ -0,0 +1,50 @@
+#include <cstring>
+#include "TestFixture.h"
+#include "utils/Profiler.h"
+
+
+class ProfilerTest : public CPUTest
+{
+};
+
+TEST_F(ProfilerTest, AttributesSamplesToExecutingInstruction)
+{
+    uint8_t program[] = {
+        0xA9, 0x01,        // LDA #$01       ; 0x8000
+        0xBD, 0x00, 0x02,  // LDA $0200,X    ; 0x8002
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    Profiler profiler(1);
+
+    cpu.Step(); // LDA #$01
+    profiler.Sample(bus);
+
+    cpu.Step(); // LDA $0200,X
+    profiler.Sample(bus);
+    profiler.Sample(bus);
+
+    EXPECT_EQ(profiler.GetSampleCount(), 3u);
+
+    char buffer[512] = {};
+    FILE* out = fmemopen(buffer, sizeof(buffer) - 1, "w");
+    ASSERT_NE(out, nullptr);
+    profiler.WriteCollapsed(out);
+    std::fclose(out);
+
+    EXPECT_NE(std::strstr(buffer, "$8000 LDA #$01 1\n"), nullptr);
+    EXPECT_NE(std::strstr(buffer, "$8002 LDA $0200,X 2\n"), nullptr);
+}
+
+TEST_F(ProfilerTest, TickSamplesEveryInterval)
+{
+    Profiler profiler(4);
+
+    for (int i = 0; i < 20; ++i)
+        profiler.Tick(bus);
+
+    EXPECT_EQ(profiler.GetSampleCount(), 5u);
+
+    profiler.Clear();
+    EXPECT_EQ(profiler.GetSampleCount(), 0u);
+}
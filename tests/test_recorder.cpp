@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "ppu/Palette.h"
+#include "utils/Recorder.h"
+
+
+static std::vector<uint8_t> ReadFile(const std::string& filename)
+{
+    std::vector<uint8_t> data(std::filesystem::file_size(filename));
+    FILE* f = std::fopen(filename.c_str(), "rb");
+    if (f)
+    {
+        size_t n = std::fread(data.data(), 1, data.size(), f);
+        data.resize(n);
+        std::fclose(f);
+    }
+    return data;
+}
+
+
+TEST(RecorderTest, BlockingModeWritesEveryFrame)
+{
+    std::string file = (std::filesystem::path(::testing::TempDir()) / "recorder_test.rgb").string();
+
+    Recorder recorder;
+    ASSERT_TRUE(recorder.Open(file, Recorder::FORMAT_RGB24, Recorder::BACKPRESSURE_BLOCK, 2));
+
+    std::vector<uint8_t> frame(Recorder::FRAME_SIZE);
+    for (int i = 0; i < 10; ++i)
+    {
+        std::fill(frame.begin(), frame.end(), (uint8_t) (0x10 + i));
+        EXPECT_TRUE(recorder.PushFrame(frame.data()));
+    }
+
+    recorder.Close();
+    EXPECT_EQ(recorder.GetWrittenFrames(), 10u);
+    EXPECT_EQ(recorder.GetDroppedFrames(), 0u);
+
+    // Frames come out in order, converted through the master palette
+    std::vector<uint8_t> data = ReadFile(file);
+    ASSERT_EQ(data.size(), 10 * Recorder::FRAME_SIZE * 3);
+
+    uint32_t argb = Palette::ARGB[0x19];
+    const uint8_t* pixel = &data[9 * Recorder::FRAME_SIZE * 3 + 123 * 3];
+    EXPECT_EQ(pixel[0], (argb >> 16) & 0xFF);
+    EXPECT_EQ(pixel[1], (argb >> 8) & 0xFF);
+    EXPECT_EQ(pixel[2], argb & 0xFF);
+
+    std::filesystem::remove(file);
+}
+
+TEST(RecorderTest, Y4MStreamHasHeaderAndFrameMarkers)
+{
+    std::string file = (std::filesystem::path(::testing::TempDir()) / "recorder_test.y4m").string();
+
+    Recorder recorder;
+    ASSERT_TRUE(recorder.Open(file, Recorder::FORMAT_Y4M, Recorder::BACKPRESSURE_DROP, 4));
+
+    // Dropping mode never blocks; every frame is either written or counted
+    std::vector<uint8_t> frame(Recorder::FRAME_SIZE, 0x30);
+    int pushed = 0;
+    for (int i = 0; i < 50; ++i)
+        pushed += recorder.PushFrame(frame.data()) ? 1 : 0;
+
+    recorder.Close();
+    EXPECT_EQ(recorder.GetWrittenFrames(), (uint64_t) pushed);
+    EXPECT_EQ(recorder.GetWrittenFrames() + recorder.GetDroppedFrames(), 50u);
+
+    std::vector<uint8_t> data = ReadFile(file);
+    const char* header = "YUV4MPEG2 W256 H240 ";
+    ASSERT_GT(data.size(), std::strlen(header));
+    EXPECT_EQ(std::memcmp(data.data(), header, std::strlen(header)), 0);
+
+    size_t headerSize = std::find(data.begin(), data.end(), '\n') - data.begin() + 1;
+    size_t frameSize = 6 + Recorder::FRAME_SIZE * 3;
+    ASSERT_EQ(data.size(), headerSize + pushed * frameSize);
+    EXPECT_EQ(std::memcmp(&data[headerSize], "FRAME\n", 6), 0);
+
+    // $30 is near-white: high (limited-range) luma, neutral chroma
+    EXPECT_GE(data[headerSize + 6], 210);
+    EXPECT_NEAR(data[headerSize + 6 + Recorder::FRAME_SIZE], 128, 2);
+
+    std::filesystem::remove(file);
+}
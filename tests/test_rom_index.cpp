@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "TestFixture.h"
+#include "cartridge/RomHeader.h"
+#include "utils/Hash.h"
+#include "utils/RomIndex.h"
+
+
+// Vertical mirroring, every PRG/CHR byte set to `fill`
+static std::vector<uint8_t> MakeROM(uint8_t prgBanks, uint8_t chrBanks, uint8_t mapper, uint8_t fill)
+{
+    std::vector<uint8_t> rom = MakeTestROM({}, mapper, prgBanks, chrBanks, 0x01);
+    std::fill(rom.begin() + TEST_ROM_PRG, rom.end(), fill);
+    return rom;
+}
+
+static void WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+{
+    FILE* f = std::fopen(path.string().c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fwrite(data.data(), 1, data.size(), f);
+    std::fclose(f);
+}
+
+
+TEST(HashTest, XXH64MatchesReferenceVectors)
+{
+    EXPECT_EQ(Hash::XXH64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(Hash::XXH64("a", 1), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(Hash::XXH64("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    // Long enough for the four-lane loop plus every tail path
+    uint8_t data[100];
+    for (int i = 0; i < 100; ++i)
+        data[i] = (uint8_t) i;
+    EXPECT_EQ(Hash::XXH64(data, sizeof(data)), 0x6AC1E58032166597ULL);
+}
+
+TEST(RomHeaderTest, ParsesINESAndNES20)
+{
+    std::vector<uint8_t> rom = MakeROM(2, 1, 4, 0);
+    rom[6] |= 0x02; // Battery
+
+    RomHeader h;
+    ASSERT_TRUE(RomHeader::Parse(rom.data(), rom.size(), h));
+    EXPECT_EQ(h.format, RomHeader::FORMAT_INES);
+    EXPECT_EQ(h.mapper, 4);
+    EXPECT_EQ(h.prgRomSize, 0x8000u);
+    EXPECT_EQ(h.chrRomSize, 0x2000u);
+    EXPECT_EQ(h.mirrorMode, MIRROR_MODE_VERTICAL);
+    EXPECT_TRUE(h.hasBattery);
+    EXPECT_EQ(h.GetExpectedFileSize(), rom.size());
+
+    // NES 2.0: mapper 258 submapper 3, PRG MSB nibble, 8KB battery PRG-RAM
+    uint8_t nes20[16] = { 'N', 'E', 'S', 0x1A, 0x00, 0x00, 0x20, 0x08, 0x31, 0x01, 0x70, 0x07 };
+    ASSERT_TRUE(RomHeader::Parse(nes20, sizeof(nes20), h));
+    EXPECT_EQ(h.format, RomHeader::FORMAT_NES20);
+    EXPECT_EQ(h.mapper, 258);
+    EXPECT_EQ(h.submapper, 3);
+    EXPECT_EQ(h.prgRomSize, 0x100u * 0x4000u);
+    EXPECT_EQ(h.chrRomSize, 0u);
+    EXPECT_EQ(h.prgRamSize, 0x2000u);
+    EXPECT_EQ(h.chrRamSize, 0x2000u);
+
+    uint8_t bad[16] = { 'N', 'E', 'Z', 0x1A };
+    EXPECT_FALSE(RomHeader::Parse(bad, sizeof(bad), h));
+    EXPECT_FALSE(RomHeader::Parse(nes20, 8, h));
+}
+
+TEST(RomIndexTest, ScanSaveLoadRoundTrip)
+{
+    namespace fs = std::filesystem;
+
+    fs::path dir = fs::path(::testing::TempDir()) / "rom_index_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "sub");
+
+    std::vector<uint8_t> a = MakeROM(1, 1, 0, 0x11);
+    std::vector<uint8_t> b = MakeROM(2, 0, 2, 0x22);
+    WriteFile(dir / "a.nes", a);
+    WriteFile(dir / "sub" / "b.NES", b);
+    WriteFile(dir / "readme.txt", { 'h', 'i' });
+    WriteFile(dir / "junk.nes", { 'N', 'E', 'S' });
+
+    RomIndex index;
+    ASSERT_TRUE(index.Scan(dir.string(), 2));
+    EXPECT_EQ(index.GetCount(), 2u);
+    EXPECT_EQ(index.GetScanStats().files, 3u);
+    EXPECT_EQ(index.GetScanStats().rejected, 1u);
+    EXPECT_EQ(index.GetScanStats().hashed, 2u);
+
+    // Content hash covers PRG + CHR only
+    uint64_t hashB = Hash::XXH64(b.data() + 16, b.size() - 16);
+    const RomIndex::Entry* e = index.Find(hashB);
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(e->mapper, 2);
+    EXPECT_EQ(e->prgRomSize, 0x8000u);
+    EXPECT_EQ(index.GetPath(*e), (dir / "sub" / "b.NES").string());
+
+    std::string file = (dir / "library.idx").string();
+    ASSERT_TRUE(index.Save(file));
+
+    RomIndex loaded;
+    ASSERT_TRUE(loaded.Load(file));
+    ASSERT_EQ(loaded.GetCount(), 2u);
+    e = loaded.Find(hashB);
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(loaded.GetPath(*e), (dir / "sub" / "b.NES").string());
+    EXPECT_EQ(loaded.Find(0x1234), nullptr);
+
+    // Rescan against the loaded index reuses unchanged files
+    RomIndex rescanned;
+    ASSERT_TRUE(rescanned.Scan(dir.string(), 1, &loaded));
+    EXPECT_EQ(rescanned.GetScanStats().reused, 2u);
+    EXPECT_EQ(rescanned.GetScanStats().hashed, 0u);
+    EXPECT_NE(rescanned.Find(hashB), nullptr);
+
+    fs::remove_all(dir);
+}
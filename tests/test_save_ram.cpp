@@ -0,0 +1,116 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "TestFixture.h"
+#include "cartridge/Cartridge.h"
+#include "cartridge/SaveRAM.h"
+
+
+// NROM with the battery flag set
+static std::vector<uint8_t> MakeBatteryROM()
+{
+    return MakeTestROM({}, 0, 1, 1, 0x02);
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+TEST(SaveRAMTest, WritesMarkPagesDirty)
+{
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBatteryROM()));
+    EXPECT_TRUE(cartridge.HasBattery());
+    EXPECT_EQ(cartridge.TakeDirtyPRGRAMPages(), 0u);
+
+    cartridge.CPUWrite(0x6000, 0x12);
+    cartridge.CPUWrite(0x60FF, 0x34);
+    cartridge.CPUWrite(0x7F00, 0x56);
+    EXPECT_EQ(cartridge.TakeDirtyPRGRAMPages(), 0x80000001u);
+    EXPECT_EQ(cartridge.TakeDirtyPRGRAMPages(), 0u);
+
+    // Rewriting the same value is not a change
+    cartridge.CPUWrite(0x6000, 0x12);
+    EXPECT_EQ(cartridge.TakeDirtyPRGRAMPages(), 0u);
+}
+
+TEST(SaveRAMTest, PersistsAcrossSessions)
+{
+    std::string file = (std::filesystem::path(::testing::TempDir()) / "save_ram_test.sav").string();
+    std::filesystem::remove(file);
+
+    {
+        Cartridge cartridge;
+        ASSERT_TRUE(cartridge.LoadFromMemory(MakeBatteryROM()));
+
+        SaveRAM save;
+        ASSERT_TRUE(save.Open(file, &cartridge));
+        EXPECT_EQ(ReadFile(file).size(), 0x2000u);
+
+        cartridge.CPUWrite(0x6010, 0xAA);
+        save.Sync();
+        cartridge.CPUWrite(0x7FFF, 0xBB); // Not synced: Close picks it up
+        save.Close();
+
+        std::vector<uint8_t> data = ReadFile(file);
+        ASSERT_EQ(data.size(), 0x2000u);
+        EXPECT_EQ(data[0x0010], 0xAA);
+        EXPECT_EQ(data[0x1FFF], 0xBB);
+    }
+
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBatteryROM()));
+
+    SaveRAM save;
+    ASSERT_TRUE(save.Open(file, &cartridge));
+    EXPECT_EQ(cartridge.CPURead(0x6010), 0xAA);
+    EXPECT_EQ(cartridge.CPURead(0x7FFF), 0xBB);
+    EXPECT_EQ(cartridge.TakeDirtyPRGRAMPages(), 0u);
+    save.Close();
+
+    std::filesystem::remove(file);
+}
+
+TEST(SaveRAMTest, FlushesInBackgroundAfterQuietPeriod)
+{
+    std::string file = (std::filesystem::path(::testing::TempDir()) / "save_ram_flush.sav").string();
+    std::filesystem::remove(file);
+
+    Cartridge cartridge;
+    ASSERT_TRUE(cartridge.LoadFromMemory(MakeBatteryROM()));
+
+    SaveRAM save;
+    ASSERT_TRUE(save.Open(file, &cartridge));
+
+    // A burst over several frames is coalesced into one flush
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        cartridge.CPUWrite(0x6100 + frame, (uint8_t) (frame + 1));
+        save.Sync();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + SaveRAM::MAX_DELAY * 3;
+    while (save.GetFlushCount() == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    EXPECT_EQ(save.GetFlushCount(), 1u);
+    std::vector<uint8_t> data = ReadFile(file);
+    ASSERT_EQ(data.size(), 0x2000u);
+    for (int frame = 0; frame < 5; ++frame)
+        EXPECT_EQ(data[0x0100 + frame], frame + 1);
+
+    save.Close();
+    std::filesystem::remove(file);
+}
+
+TEST(SaveRAMTest, SavePathReplacesExtension)
+{
+    EXPECT_EQ(SaveRAM::GetSavePath("roms/zelda.nes"), "roms/zelda.sav");
+    EXPECT_EQ(SaveRAM::GetSavePath("roms.d/zelda"), "roms.d/zelda.sav");
+}
@@ -0,0 +1,128 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/Machine.h"
+#include "utils/Telemetry.h"
+
+
+// Busy loop with NMIs on, so the CPU counters all move
+static std::vector<uint8_t> MakeNMIROM()
+{
+    return MakeTestROM({
+        0xA9, 0x80,        // LDA #$80
+        0x8D, 0x00, 0x20,  // STA $2000 ; NMI on
+        0xE6, 0x10,        // INC $10   ; $8005
+        0x4C, 0x05, 0x80,  // JMP $8005
+    }, 0, 1, 0);
+}
+
+// Per process, so parallel test runs don't share a segment
+static std::string SegmentName()
+{
+    return "/nes_telemetry_test_" + std::to_string(::getpid());
+}
+
+TEST(TelemetryTest, ReaderSeesWhatTheWriterPublished)
+{
+    Machine machine;
+    ASSERT_TRUE(machine.LoadFromMemory(MakeNMIROM()));
+
+    TelemetryWriter writer;
+    ASSERT_TRUE(writer.Open(SegmentName()));
+
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.Open(SegmentName()));
+    EXPECT_EQ(reader.GetWriterPid(), (int) ::getpid());
+
+    const uint64_t phaseNs[TelemetryWriter::PHASE_COUNT] = { 4000000, 1000000, 2000000 };
+    for (int i = 0; i < 3; ++i)
+    {
+        machine.RunFrame();
+        writer.EndFrame(phaseNs, machine.GetCPU());
+    }
+
+    TelemetryStats stats;
+    ASSERT_TRUE(reader.Read(stats));
+    EXPECT_EQ(stats.frames, 3u);
+    EXPECT_EQ(stats.cpuCycles, machine.GetCPU().GetTotalCycles());
+    EXPECT_EQ(stats.instructions, machine.GetCPU().GetInstructionCount());
+    EXPECT_GT(stats.instructions, 0u);
+    EXPECT_EQ(stats.nmis, 3u);
+    EXPECT_EQ(stats.irqs, 0u);
+
+    // The segment goes away with the writer
+    writer.Close();
+    TelemetryReader late;
+    EXPECT_FALSE(late.Open(SegmentName()));
+}
+
+TEST(TelemetryTest, ReportsPercentilesAndPhases)
+{
+    CPU cpu;
+    TelemetryWriter writer;
+
+    // Iterations of 1..60 ms, all of it emulation except 1 ms display
+    for (uint32_t i = 1; i <= TelemetryWriter::REPORT_INTERVAL; ++i)
+    {
+        const uint64_t phaseNs[TelemetryWriter::PHASE_COUNT] = { (i - 1) * 1000000ull, 0, 1000000 };
+        writer.EndFrame(phaseNs, cpu);
+    }
+
+    const TelemetryStats& stats = writer.GetStats();
+    EXPECT_EQ(stats.frames, 60u);
+    EXPECT_DOUBLE_EQ(stats.frameMsP50, 30.0);
+    EXPECT_DOUBLE_EQ(stats.frameMsP95, 57.0);
+    EXPECT_DOUBLE_EQ(stats.frameMsP99, 60.0);
+    EXPECT_DOUBLE_EQ(stats.emulateMs, 29.5);
+    EXPECT_DOUBLE_EQ(stats.renderMs, 0.0);
+    EXPECT_DOUBLE_EQ(stats.displayMs, 1.0);
+    EXPECT_GT(stats.fps, 0.0);
+}
+
+TEST(TelemetryTest, ReadsAreNeverTorn)
+{
+    Machine machine;
+    ASSERT_TRUE(machine.LoadFromMemory(MakeNMIROM()));
+    CPU& cpu = machine.GetCPU();
+    cpu.Step(); // Reset cycles
+
+    TelemetryWriter writer;
+    ASSERT_TRUE(writer.Open(SegmentName()));
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.Open(SegmentName()));
+
+    // One instruction per published frame, so every snapshot has as many
+    // instructions as frames; a read mixing two snapshots would not
+    std::atomic<bool> stop(false);
+    std::thread publisher([&]()
+    {
+        const uint64_t phaseNs[TelemetryWriter::PHASE_COUNT] = {};
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            cpu.Step();
+            writer.EndFrame(phaseNs, cpu);
+        }
+    });
+
+    uint64_t last = 0;
+    while (last < 20000)
+    {
+        TelemetryStats stats;
+        if (!reader.Read(stats))
+            continue;
+
+        EXPECT_EQ(stats.instructions, stats.frames);
+        EXPECT_GE(stats.frames, last);
+        if (stats.instructions != stats.frames || stats.frames < last)
+            break;
+        last = stats.frames;
+    }
+
+    stop = true;
+    publisher.join();
+}
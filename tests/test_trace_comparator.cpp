@@ -0,0 +1,92 @@
+#include <cstring>
+#include "TestFixture.h"
+#include "utils/TraceComparator.h"
+
+
+class TraceComparatorTest : public CPUTest
+{
+};
+
+TEST_F(TraceComparatorTest, ParsesNestestLine)
+{
+    const char* line =
+        "C72F  6C 00 02  JMP ($0200) = DB7E              A:DB X:07 Y:02 P:E5 SP:FB PPU: 12,137 CYC:1445";
+
+    TraceComparator::Expected e;
+    ASSERT_TRUE(TraceComparator::ParseLine(line, std::strlen(line), e));
+
+    EXPECT_EQ(e.fields, (uint32_t) TraceComparator::F_ALL);
+    EXPECT_EQ(e.pc, 0xC72F);
+    EXPECT_EQ(e.length, 3);
+    EXPECT_EQ(e.bytes[0], 0x6C);
+    EXPECT_EQ(e.bytes[2], 0x02);
+    EXPECT_EQ(e.a, 0xDB);
+    EXPECT_EQ(e.x, 0x07);
+    EXPECT_EQ(e.y, 0x02);
+    EXPECT_EQ(e.p, 0xE5);
+    EXPECT_EQ(e.sp, 0xFB);
+    EXPECT_EQ(e.scanline, 12);
+    EXPECT_EQ(e.dot, 137);
+    EXPECT_EQ(e.cycle, 1445u);
+
+    // Logs without PPU/CYC columns only check what they have
+    const char* shortLine = "8000  A9 01     LDA #$01                        A:00 X:00 Y:00 P:24 SP:FD";
+    ASSERT_TRUE(TraceComparator::ParseLine(shortLine, std::strlen(shortLine), e));
+    EXPECT_EQ(e.fields & (TraceComparator::F_PPU | TraceComparator::F_CYCLE), 0u);
+    EXPECT_EQ(e.length, 2);
+}
+
+TEST_F(TraceComparatorTest, StopsAtFirstDivergence)
+{
+    uint8_t program[] = {
+        0xA9, 0x01,  // LDA #$01  ; 0x8000
+        0xAA,        // TAX       ; 0x8002
+        0xE8,        // INX       ; 0x8003
+    };
+    cpu.LoadProgram(program, sizeof(program));
+
+    // Reference is wrong about A on the second line (and X on the third);
+    // only the first divergence is reported
+    std::string path = ::testing::TempDir() + "trace_reference.log";
+    FILE* file = std::fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+
+    TraceRecord first;
+    TraceWriter::Snapshot(bus, first);
+    char line[128];
+    TraceReader::FormatNestest(first, line, sizeof(line));
+    std::fprintf(file, "%s\n", line);
+    std::fprintf(file, "8002  AA        TAX                             A:02 X:00 Y:00 P:24 SP:FD\n");
+    std::fprintf(file, "8003  E8        INX                             A:01 X:01 Y:00 P:24 SP:FD\n");
+    std::fclose(file);
+
+    TraceComparator comparator;
+    ASSERT_TRUE(comparator.Open(path));
+
+    EXPECT_TRUE(comparator.Compare(bus));
+    cpu.Step();
+    EXPECT_FALSE(comparator.Compare(bus));
+    cpu.Step();
+    EXPECT_FALSE(comparator.Compare(bus)); // Sticky after a divergence
+
+    ASSERT_TRUE(comparator.HasDiverged());
+    EXPECT_EQ(comparator.GetMatchedCount(), 1u);
+
+    const TraceComparator::Divergence& d = comparator.GetDivergence();
+    EXPECT_EQ(d.line, 2u);
+    EXPECT_EQ(d.mismatched, (uint32_t) TraceComparator::F_A);
+    EXPECT_EQ(d.expected.a, 0x02);
+    EXPECT_EQ(d.actual.a, 0x01);
+
+    char report[1024] = {};
+    FILE* out = fmemopen(report, sizeof(report) - 1, "w");
+    ASSERT_NE(out, nullptr);
+    comparator.WriteReport(out);
+    std::fclose(out);
+
+    EXPECT_NE(std::strstr(report, "reference line 2"), nullptr);
+    EXPECT_NE(std::strstr(report, "A        02         01"), nullptr);
+
+    comparator.Close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,75 @@
+#include <cstring>
+#include "TestFixture.h"
+#include "utils/TraceFormat.h"
+
+
+class TraceFormatTest : public CPUTest
+{
+};
+
+TEST_F(TraceFormatTest, RoundTripsCapturedInstructions)
+{
+    uint8_t program[] = {
+        0xA2, 0x03,        // LDX #$03       ; 0x8000
+        0xB5, 0x10,        // LDA $10,X      ; 0x8002
+        0xCA,              // DEX            ; 0x8004
+        0xD0, 0xFB,        // BNE $8002      ; 0x8005
+        0x4C, 0x00, 0x80,  // JMP $8000      ; 0x8007
+    };
+    cpu.LoadProgram(program, sizeof(program));
+    bus.CPUWrite(0x0013, 0x5A);
+
+    std::string path = ::testing::TempDir() + "trace_roundtrip.ntr";
+
+    std::vector<TraceRecord> captured;
+    {
+        TraceWriter writer;
+        ASSERT_TRUE(writer.Open(path));
+
+        for (int i = 0; i < 12; ++i)
+        {
+            writer.Capture(bus);
+            cpu.Step();
+        }
+        EXPECT_EQ(writer.GetRecordCount(), 12u);
+    }
+
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(path));
+
+    TraceRecord record;
+    std::vector<TraceRecord> decoded;
+    while (reader.Next(record))
+        decoded.push_back(record);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(decoded.size(), 12u);
+    EXPECT_EQ(decoded[0].pc, 0x8000);
+    EXPECT_EQ(decoded[1].pc, 0x8002);
+    EXPECT_EQ(decoded[1].x, 0x03);
+    EXPECT_TRUE(decoded[1].hasMemory);
+    EXPECT_EQ(decoded[1].effectiveAddress, 0x0013);
+    EXPECT_EQ(decoded[1].memoryValue, 0x5A);
+    EXPECT_EQ(decoded[4].pc, 0x8002); // Branch taken back
+    EXPECT_EQ(decoded[4].cycle - decoded[3].cycle, 3u);
+
+    char line[128];
+    TraceReader::FormatNestest(decoded[1], line, sizeof(line));
+    EXPECT_STREQ(line, "8002  B5 10     LDA $10,X @ 13 = 5A             "
+                       "A:00 X:03 Y:00 P:24 SP:FD PPU:  0, 27 CYC:9");
+}
+
+TEST_F(TraceFormatTest, MarksIllegalOpcodes)
+{
+    TraceRecord r = {};
+    r.pc = 0xC6BD;
+    r.opcode = 0x04; // *NOP zp
+    r.operands[0] = 0xA9;
+    r.hasMemory = true;
+    r.effectiveAddress = 0x00A9;
+    r.p = 0xEF;
+
+    char line[128];
+    TraceReader::FormatNestest(r, line, sizeof(line));
+    EXPECT_EQ(std::strncmp(line, "C6BD  04 A9    *NOP $A9 = 00", 28), 0);
+}
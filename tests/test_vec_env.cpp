@@ -0,0 +1,173 @@
+#include <cstring>
+#include <vector>
+
+#include "TestFixture.h"
+#include "machine/VecEnv.h"
+
+
+// UxROM image (CHR-RAM) that adds the pad 1 bits it reads to $10 and
+// scrolls the screen by that amount, so both RAM and frames follow input
+static std::vector<uint8_t> MakeInputROM()
+{
+    return MakeTestROM({
+        0xA9, 0x1E,        // LDA #$1E
+        0x8D, 0x01, 0x20,  // STA $2001 ; rendering on
+        0xA9, 0x01,        // LDA #$01  ; $8005
+        0x8D, 0x16, 0x40,  // STA $4016
+        0xA9, 0x00,        // LDA #$00
+        0x8D, 0x16, 0x40,  // STA $4016
+        0xAD, 0x16, 0x40,  // LDA $4016 ; A
+        0x29, 0x01,        // AND #$01
+        0x18,              // CLC
+        0x65, 0x10,        // ADC $10
+        0x85, 0x10,        // STA $10
+        0x8D, 0x05, 0x20,  // STA $2005
+        0x8D, 0x05, 0x20,  // STA $2005
+        0x4C, 0x05, 0x80,  // JMP $8005
+    }, 2, 2, 0);
+}
+
+// Give the PPU something to draw
+static void FillVideo(Machine& machine)
+{
+    PPU& ppu = machine.GetPPU();
+    for (uint16_t i = 0; i < 0x0800; ++i)
+        ppu.PPUWrite(0x2000 + i, (uint8_t) (i * 7));
+    for (uint16_t i = 0; i < 0x2000; ++i)
+        ppu.PPUWrite(i, (uint8_t) (i * 13 + (i >> 5)));
+    for (uint16_t i = 0; i < 0x20; ++i)
+        ppu.PPUWrite(0x3F00 + i, (uint8_t) (i * 5 + 1));
+}
+
+static uint8_t ActionFor(size_t env, int step)
+{
+    return ((env + step) % 3) ? Controller::A : 0;
+}
+
+class VecEnvTest : public ::testing::Test
+{
+protected:
+    std::vector<uint8_t> rom = MakeInputROM();
+
+    bool Init(VecEnv& env, size_t count, const VecEnv::Config& config)
+    {
+        if (!env.Init(rom, count, config))
+            return false;
+        FillVideo(env.GetSnapshot());
+        env.GetSnapshot().RunFrame();
+        env.Reset();
+        return true;
+    }
+
+    static void StepAll(VecEnv& env, int steps)
+    {
+        std::vector<uint8_t> actions(env.GetCount());
+        for (int step = 0; step < steps; ++step)
+        {
+            for (size_t i = 0; i < actions.size(); ++i)
+                actions[i] = ActionFor(i, step);
+            env.Step(actions.data());
+        }
+    }
+};
+
+TEST_F(VecEnvTest, ObservationsMatchAPlainMachine)
+{
+    VecEnv::Config config;
+    config.frameSkip = 3;
+    config.grayscale = false;
+    config.threads = 1;
+
+    VecEnv env;
+    ASSERT_TRUE(Init(env, 3, config));
+    ASSERT_EQ(env.GetObservationSize(), (size_t) (PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT) + VecEnv::RAM_SIZE);
+    StepAll(env, 4);
+
+    for (size_t i = 0; i < env.GetCount(); ++i)
+    {
+        Machine machine;
+        ASSERT_TRUE(machine.LoadFromMemory(rom));
+        FillVideo(machine);
+        machine.RunFrame();
+
+        for (int step = 0; step < 4; ++step)
+        {
+            machine.SetControllerState(0, ActionFor(i, step));
+            for (int frame = 0; frame < config.frameSkip; ++frame)
+                machine.RunFrame();
+        }
+
+        const uint8_t* observation = env.GetObservation(i);
+        EXPECT_EQ(std::memcmp(observation, machine.GetPPU().GetScreenBuffer(),
+                              PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT), 0) << "env " << i;
+
+        uint8_t ram[VecEnv::RAM_SIZE];
+        machine.GetMemory().CopyTo(0x0000, ram, sizeof(ram));
+        EXPECT_EQ(std::memcmp(observation + PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT, ram, sizeof(ram)), 0)
+            << "env " << i;
+    }
+
+    // Different inputs must have led somewhere different
+    EXPECT_NE(env.GetObservation(0)[PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT + 0x10],
+              env.GetObservation(1)[PPU::SCREEN_WIDTH * PPU::SCREEN_HEIGHT + 0x10]);
+}
+
+TEST_F(VecEnvTest, ThreadsDoNotChangeResults)
+{
+    VecEnv::Config config;
+    config.downsample = 2;
+    config.threads = 1;
+
+    VecEnv serial, threaded;
+    ASSERT_TRUE(Init(serial, 7, config));
+    config.threads = 3;
+    ASSERT_TRUE(Init(threaded, 7, config));
+
+    StepAll(serial, 5);
+    StepAll(threaded, 5);
+
+    ASSERT_EQ(serial.GetObservationSize(), threaded.GetObservationSize());
+    EXPECT_EQ(std::memcmp(serial.GetObservations(), threaded.GetObservations(),
+                          serial.GetCount() * serial.GetObservationSize()), 0);
+}
+
+TEST_F(VecEnvTest, ResetGoesBackToTheSnapshot)
+{
+    VecEnv::Config config;
+    config.threads = 2;
+
+    VecEnv env;
+    ASSERT_TRUE(Init(env, 2, config));
+    std::vector<uint8_t> initial(env.GetObservation(1), env.GetObservation(1) + env.GetObservationSize());
+
+    StepAll(env, 3);
+    ASSERT_NE(std::memcmp(env.GetObservation(1), initial.data(), initial.size()), 0);
+
+    env.Reset(1);
+    EXPECT_EQ(std::memcmp(env.GetObservation(1), initial.data(), initial.size()), 0);
+    EXPECT_EQ(env.GetMachine(1).GetFrameCount(), env.GetSnapshot().GetFrameCount());
+
+    // Stepping again from the snapshot repeats the first run
+    std::vector<uint8_t> first(env.GetObservation(0), env.GetObservation(0) + env.GetObservationSize());
+    env.Reset();
+    StepAll(env, 3);
+    EXPECT_EQ(std::memcmp(env.GetObservation(0), first.data(), first.size()), 0);
+}
+
+TEST_F(VecEnvTest, DownsampledGrayscaleLayout)
+{
+    VecEnv::Config config;
+    config.downsample = 4;
+    config.ram = false;
+    config.threads = 1;
+
+    VecEnv env;
+    ASSERT_TRUE(Init(env, 1, config));
+    EXPECT_EQ(env.GetFrameWidth(), 64);
+    EXPECT_EQ(env.GetFrameHeight(), 60);
+    EXPECT_EQ(env.GetObservationSize(), 64u * 60u);
+
+    config.downsample = 3;
+    VecEnv invalid;
+    EXPECT_FALSE(invalid.Init(rom, 1, config));
+}